@@ -476,7 +476,22 @@ SOURCES += \
     dialogs/preferences/AnalOptionsWidget.cpp \
     dialogs/preferences/KeyboardOptionsWidget.cpp \
     common/DecompilerHighlighter.cpp \
-    dialogs/PackageManagerDialog.cpp
+    dialogs/PackageManagerDialog.cpp \
+    common/R2Native.cpp \
+    common/IOPageCache.cpp \
+    common/DisassemblyCache.cpp \
+    widgets/GraphSpatialIndex.cpp \
+    common/RefreshScheduler.cpp \
+    common/AddressCoverage.cpp \
+    common/AddressTelescope.cpp \
+    common/DebugSnapshot.cpp \
+    common/BreakpointIndex.cpp \
+    common/DecompiledIndex.cpp \
+    common/DecompileAllTask.cpp \
+    common/CodeMetaBuilder.cpp \
+    common/CodeAnnotationIndex.cpp \
+    common/ConsoleBuffer.cpp \
+    widgets/ConsoleOutputView.cpp
 
 GRAPHVIZ_SOURCES = \
     widgets/GraphvizLayout.cpp
@@ -656,7 +671,23 @@ HEADERS  += \
     widgets/AddressableDockWidget.h \
     dialogs/preferences/AnalOptionsWidget.h \
     common/DecompilerHighlighter.h \
-    dialogs/PackageManagerDialog.h
+    dialogs/PackageManagerDialog.h \
+    common/R2Native.h \
+    common/IOPageCache.h \
+    common/DisassemblyCache.h \
+    widgets/GraphLayoutTask.h \
+    widgets/GraphSpatialIndex.h \
+    common/RefreshScheduler.h \
+    common/AddressCoverage.h \
+    common/AddressTelescope.h \
+    common/DebugSnapshot.h \
+    common/BreakpointIndex.h \
+    common/DecompiledIndex.h \
+    common/DecompileAllTask.h \
+    common/CodeMetaBuilder.h \
+    common/CodeAnnotationIndex.h \
+    common/ConsoleBuffer.h \
+    widgets/ConsoleOutputView.h
 
 GRAPHVIZ_HEADERS = widgets/GraphvizLayout.h
 
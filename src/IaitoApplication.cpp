@@ -163,6 +163,7 @@ IaitoApplication::IaitoApplication(int &argc, char **argv)
     }
 #endif
 
+    Core()->setThreadedMode(clOptions.threadedModeEnabled || Config()->getThreadedModeEnabled());
     Core()->initialize(clOptions.enableR2Plugins);
     Core()->setSettings();
     Config()->loadInitial();
@@ -423,6 +424,11 @@ bool IaitoApplication::parseCommandLineOptions()
                     " redirection is causing some messages to be lost."));
     cmd_parser.addOption(disableRedirectOption);
 
+    QCommandLineOption threadedOption(
+        "threaded",
+        QObject::tr("Run long radare2 tasks in background threads instead of the GUI thread"));
+    cmd_parser.addOption(threadedOption);
+
     QCommandLineOption disablePlugins("no-plugins", QObject::tr("Do not load plugins"));
     cmd_parser.addOption(disablePlugins);
 
@@ -514,6 +520,7 @@ bool IaitoApplication::parseCommandLineOptions()
     }
 
     opts.outputRedirectionEnabled = !cmd_parser.isSet(disableRedirectOption);
+    opts.threadedModeEnabled = cmd_parser.isSet(threadedOption);
     if (cmd_parser.isSet(disablePlugins)) {
         opts.enableIaitoPlugins = false;
         opts.enableR2Plugins = false;
@@ -17,6 +17,7 @@ struct IaitoCommandLineOptions
     InitialOptions fileOpenOptions;
     QString pythonHome;
     bool outputRedirectionEnabled = true;
+    bool threadedModeEnabled = false;
     bool enableIaitoPlugins = true;
     bool enableR2Plugins = true;
 };
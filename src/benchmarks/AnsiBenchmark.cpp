@@ -0,0 +1,207 @@
+/**
+ * @file AnsiBenchmark.cpp
+ * @brief Time RichTextPainter::fromAnsi() against the HTML round trip it
+ * replaced in DisassemblerGraphView::loadCurrentGraph(): ANSI to HTML with
+ * IaitoCore::ansiEscapeToHtml(), then QTextDocument and fromTextDocument().
+ *
+ * The instructions are read from files holding the output of "agJ" with
+ * colors, for example:
+ *
+ *     r2 -qc 'e scr.color=3; aaa; agJ @@F' /bin/ls > ls.json
+ *     iaito-ansi-benchmark ls.json
+ *
+ * Without files, synthetic instructions colored like r2 does are used. The
+ * plain text of both paths is compared too.
+ */
+
+#include "common/RichTextPainter.h"
+#include "core/Iaito.h"
+
+#include <QCommandLineParser>
+#include <QElapsedTimer>
+#include <QFile>
+#include <QGuiApplication>
+#include <QJsonArray>
+#include <QJsonDocument>
+#include <QJsonObject>
+#include <QTextDocument>
+#include <QTextStream>
+
+#include <algorithm>
+#include <random>
+#include <vector>
+
+namespace {
+
+/**
+ * @brief Text of every instruction in the output of "agJ"
+ */
+QStringList loadInstructions(const QString &path, QString *error)
+{
+    QStringList lines;
+    QFile file(path);
+    if (!file.open(QIODevice::ReadOnly)) {
+        *error = file.errorString();
+        return lines;
+    }
+    QJsonParseError parseError;
+    const QJsonDocument doc = QJsonDocument::fromJson(file.readAll(), &parseError);
+    if (doc.isNull()) {
+        *error = parseError.errorString();
+        return lines;
+    }
+    QJsonArray functions = doc.array();
+    if (doc.isObject()) {
+        functions.append(doc.object());
+    }
+    for (const QJsonValue function : functions) {
+        for (const QJsonValue block : function.toObject()["blocks"].toArray()) {
+            for (const QJsonValue op : block.toObject()["ops"].toArray()) {
+                lines << op.toObject()["text"].toString();
+            }
+        }
+    }
+    return lines;
+}
+
+/**
+ * @brief Instructions with the 16, 256 and 24 bit color escapes r2 prints,
+ * seeded for repeatable results
+ */
+QStringList syntheticInstructions(int count)
+{
+    static const char *const mnemonics[] = {"mov", "lea", "call", "cmp", "jne", "push", "xor"};
+    static const char *const operands[] = {
+        "rax, qword [rbp - 0x18]",
+        "edi, 0x10",
+        "sym.imp.printf",
+        "byte [rax], 0",
+        "0x401a2c",
+        "rbx",
+        "eax, eax",
+    };
+    std::mt19937 generator(count);
+    QStringList lines;
+    lines.reserve(count);
+    for (int i = 0; i < count; i++) {
+        const int mnemonic = int(generator() % 7);
+        const int operand = int(generator() % 7);
+        QString color;
+        switch (generator() % 3) {
+        case 0:
+            color = QStringLiteral("\x1b[3%1m").arg(1 + generator() % 7);
+            break;
+        case 1:
+            color = QStringLiteral("\x1b[38;5;%1m").arg(generator() % 256);
+            break;
+        default:
+            color = QStringLiteral("\x1b[38;2;%1;%2;%3m")
+                        .arg(generator() % 256)
+                        .arg(generator() % 256)
+                        .arg(generator() % 256);
+            break;
+        }
+        lines << QStringLiteral("\x1b[32m0x%1\x1b[0m      %2%3\x1b[0m\t%4\x1b[0m ; comment %5")
+                     .arg(0x401000 + i * 4, 8, 16, QLatin1Char('0'))
+                     .arg(color, QString::fromLatin1(mnemonics[mnemonic]))
+                     .arg(QString::fromLatin1(operands[operand]))
+                     .arg(i);
+    }
+    return lines;
+}
+
+double median(std::vector<double> values)
+{
+    std::sort(values.begin(), values.end());
+    return values[values.size() / 2];
+}
+
+} // namespace
+
+int main(int argc, char *argv[])
+{
+    // QTextDocument needs a GUI application, but no display
+    if (qEnvironmentVariableIsEmpty("QT_QPA_PLATFORM")) {
+        qputenv("QT_QPA_PLATFORM", "offscreen");
+    }
+    QGuiApplication app(argc, argv);
+    QCommandLineParser parser;
+    parser.setApplicationDescription(
+        QStringLiteral("Compare the ANSI tokenizer of the graph with the HTML round trip"));
+    parser.addHelpOption();
+    parser.addPositionalArgument(
+        QStringLiteral("files"), QStringLiteral("Colored output of agJ, synthetic text if none"));
+    QCommandLineOption iterationsOption(
+        {QStringLiteral("n"), QStringLiteral("iterations")},
+        QStringLiteral("Passes over all the instructions, the median time is reported"),
+        QStringLiteral("count"),
+        QStringLiteral("10"));
+    parser.addOption(iterationsOption);
+    parser.process(app);
+
+    QTextStream out(stdout);
+    QTextStream err(stderr);
+
+    QStringList lines;
+    const QStringList files = parser.positionalArguments();
+    for (const QString &path : files) {
+        QString error;
+        const QStringList loaded = loadInstructions(path, &error);
+        if (!error.isEmpty()) {
+            err << path << ": " << error << '\n';
+            return 1;
+        }
+        lines << loaded;
+    }
+    if (files.isEmpty()) {
+        lines = syntheticInstructions(20000);
+    }
+    if (lines.isEmpty()) {
+        err << "No instructions found\n";
+        return 1;
+    }
+    const int iterations = std::max(1, parser.value(iterationsOption).toInt());
+
+    std::vector<double> ansiTimes;
+    std::vector<double> documentTimes;
+    size_t parts = 0;
+    int mismatches = 0;
+    for (int i = 0; i < iterations; i++) {
+        QElapsedTimer timer;
+        QString plainText;
+        timer.start();
+        for (const QString &line : lines) {
+            parts += RichTextPainter::fromAnsi(line, &plainText).size();
+        }
+        ansiTimes.push_back(double(timer.nsecsElapsed()));
+
+        timer.start();
+        for (const QString &line : lines) {
+            QTextDocument textDoc;
+            textDoc.setHtml(IaitoCore::ansiEscapeToHtml(line));
+            plainText = textDoc.toPlainText();
+            parts += RichTextPainter::fromTextDocument(textDoc).size();
+        }
+        documentTimes.push_back(double(timer.nsecsElapsed()));
+    }
+    for (const QString &line : lines) {
+        QString plainText;
+        RichTextPainter::fromAnsi(line, &plainText);
+        QTextDocument textDoc;
+        textDoc.setHtml(IaitoCore::ansiEscapeToHtml(line));
+        if (plainText != textDoc.toPlainText()) {
+            mismatches++;
+        }
+    }
+
+    const double ansiNs = median(ansiTimes) / lines.size();
+    const double documentNs = median(documentTimes) / lines.size();
+    out << lines.size() << " instructions, " << iterations << " iterations, " << parts
+        << " parts\n";
+    out << "fromAnsi:\t" << QString::number(ansiNs, 'f', 0) << " ns per instruction\n";
+    out << "HTML + QTextDocument:\t" << QString::number(documentNs, 'f', 0)
+        << " ns per instruction\n";
+    out << "speedup:\t" << QString::number(ansiNs > 0 ? documentNs / ansiNs : 0, 'f', 1) << "x\n";
+    out << "plain text mismatches:\t" << mismatches << '\n';
+    return 0;
+}
@@ -0,0 +1,306 @@
+/**
+ * @file LayoutBenchmark.cpp
+ * @brief Lay out control flow graphs with GraphGridLayout and report the time
+ * it takes, the number of edge crossings and the total edge length.
+ *
+ * The graphs are read from files holding the output of "agJ" (one or more
+ * functions each), for example:
+ *
+ *     r2 -qc 'aaa; agJ @@F' /bin/ls > ls.json
+ *     iaito-layout-benchmark ls.json
+ *
+ * Without files, synthetic graphs of increasing size are used. Blocks are
+ * sized like DisassemblerGraphView does, with a fixed font size.
+ */
+
+#include "widgets/GraphGridLayout.h"
+
+#include <QCommandLineParser>
+#include <QCoreApplication>
+#include <QElapsedTimer>
+#include <QFile>
+#include <QJsonArray>
+#include <QJsonDocument>
+#include <QJsonObject>
+#include <QTextStream>
+
+#include <algorithm>
+#include <random>
+#include <vector>
+
+#if R2_VERSION_NUMBER >= 50909
+#define ADDR "addr"
+#else
+#define ADDR "offset"
+#endif
+
+// font size used to turn instruction counts and lengths into block sizes
+#define BENCHMARK_CHAR_WIDTH 8
+#define BENCHMARK_CHAR_HEIGHT 16
+// default of graph.maxchars, longer lines are cropped in the graph
+#define BENCHMARK_BLOCK_MAX_CHARS 100
+
+namespace {
+
+struct NamedGraph
+{
+    QString name;
+    GraphLayout::Graph graph;
+    ut64 entry = 0;
+};
+
+struct LayoutStats
+{
+    qint64 crossings = 0;
+    double edgeLength = 0;
+};
+
+void setBlockSize(GraphLayout::GraphBlock &block, int lines, int columns)
+{
+    const int extra = 4 * BENCHMARK_CHAR_WIDTH + 4;
+    columns = std::min(columns, BENCHMARK_BLOCK_MAX_CHARS);
+    block.width = columns * BENCHMARK_CHAR_WIDTH + extra + BENCHMARK_CHAR_WIDTH;
+    block.height = lines * BENCHMARK_CHAR_HEIGHT + extra;
+}
+
+/**
+ * @brief Graphs of the functions in the output of "agJ", with the edges
+ * DisassemblerGraphView::loadCurrentGraph() creates
+ */
+QList<NamedGraph> loadGraphs(const QString &path, QString *error)
+{
+    QList<NamedGraph> graphs;
+    QFile file(path);
+    if (!file.open(QIODevice::ReadOnly)) {
+        *error = file.errorString();
+        return graphs;
+    }
+    QJsonParseError parseError;
+    const QJsonDocument doc = QJsonDocument::fromJson(file.readAll(), &parseError);
+    if (doc.isNull()) {
+        *error = parseError.errorString();
+        return graphs;
+    }
+    QJsonArray functions = doc.array();
+    if (doc.isObject()) {
+        functions.append(doc.object());
+    }
+    for (const QJsonValue functionValue : functions) {
+        const QJsonObject function = functionValue.toObject();
+        NamedGraph named;
+        named.entry = function[ADDR].toVariant().toULongLong();
+        named.name = function["name"].toString();
+        if (named.name.isEmpty()) {
+            named.name = RAddressString(named.entry);
+        }
+        for (const QJsonValue blockValue : function["blocks"].toArray()) {
+            const QJsonObject block = blockValue.toObject();
+            GraphLayout::GraphBlock gb;
+            gb.entry = block[ADDR].toVariant().toULongLong();
+            const RVA fail = block["fail"].toVariant().toULongLong();
+            const RVA jump = block["jump"].toVariant().toULongLong();
+            if (fail) {
+                gb.edges.emplace_back(fail);
+            }
+            if (jump) {
+                gb.edges.emplace_back(jump);
+            }
+            for (const QJsonValue caseValue : block["switchop"].toObject()["cases"].toArray()) {
+                bool ok;
+                const RVA caseJump = caseValue.toObject()["jump"].toVariant().toULongLong(&ok);
+                if (ok) {
+                    gb.edges.emplace_back(caseJump);
+                }
+            }
+            const QJsonArray ops = block["ops"].toArray();
+            int columns = 0;
+            for (const QJsonValue op : ops) {
+                columns = std::max(columns, int(op.toObject()["text"].toString().size()));
+            }
+            setBlockSize(gb, int(ops.size()) + 1, columns);
+            named.graph[gb.entry] = gb;
+        }
+        if (!named.graph.empty()) {
+            graphs << named;
+        }
+    }
+    return graphs;
+}
+
+/**
+ * @brief Graph shaped like compiled code: a sequence of blocks with
+ * conditional branches, loops and a few switches, seeded for repeatable
+ * results
+ */
+NamedGraph syntheticGraph(int blockCount)
+{
+    std::mt19937 generator(blockCount);
+    auto chance = [&generator](int percent) { return int(generator() % 100) < percent; };
+    auto between = [&generator](int low, int high) {
+        return low + int(generator() % (high - low + 1));
+    };
+
+    NamedGraph named;
+    named.name = QStringLiteral("synthetic-%1").arg(blockCount);
+    named.entry = 0;
+    for (int i = 0; i < blockCount; i++) {
+        GraphLayout::GraphBlock block;
+        block.entry = ut64(i);
+        const bool last = i == blockCount - 1;
+        if (!last && chance(10)) {
+            // switch on a few of the next blocks
+            const int cases = between(3, 8);
+            for (int c = 0; c < cases; c++) {
+                block.edges.emplace_back(ut64(std::min(blockCount - 1, i + between(1, 12))));
+            }
+        } else if (!last) {
+            block.edges.emplace_back(ut64(i + 1));
+            if (chance(40)) {
+                // mostly forward branches, some loops back
+                const int target = chance(25) ? between(std::max(0, i - 20), i)
+                                              : std::min(blockCount - 1, i + between(2, 16));
+                block.edges.emplace_back(ut64(target));
+            }
+        }
+        setBlockSize(block, between(2, 20), between(20, 80));
+        named.graph[block.entry] = block;
+    }
+    return named;
+}
+
+LayoutStats layoutStats(const GraphLayout::Graph &graph)
+{
+    struct Segment
+    {
+        double fixed; //!< y of a horizontal segment, x of a vertical one
+        double from;
+        double to;
+        size_t edge;
+    };
+    std::vector<Segment> horizontal;
+    std::vector<Segment> vertical;
+    LayoutStats stats;
+    size_t edgeId = 0;
+    for (const auto &block : graph) {
+        for (const GraphLayout::GraphEdge &edge : block.second.edges) {
+            for (int i = 1; i < edge.polyline.size(); i++) {
+                const QPointF a = edge.polyline[i - 1];
+                const QPointF b = edge.polyline[i];
+                stats.edgeLength += QLineF(a, b).length();
+                if (a.y() == b.y()) {
+                    horizontal.push_back(
+                        {a.y(), std::min(a.x(), b.x()), std::max(a.x(), b.x()), edgeId});
+                } else if (a.x() == b.x()) {
+                    vertical.push_back(
+                        {a.x(), std::min(a.y(), b.y()), std::max(a.y(), b.y()), edgeId});
+                }
+            }
+            edgeId++;
+        }
+    }
+    // Edges are orthogonal, two of them cross where a horizontal segment of
+    // one passes strictly through a vertical segment of the other
+    for (const Segment &h : horizontal) {
+        for (const Segment &v : vertical) {
+            if (h.edge != v.edge && h.from < v.fixed && v.fixed < h.to && v.from < h.fixed
+                && h.fixed < v.to) {
+                stats.crossings++;
+            }
+        }
+    }
+    return stats;
+}
+
+} // namespace
+
+int main(int argc, char *argv[])
+{
+    QCoreApplication app(argc, argv);
+    QCommandLineParser parser;
+    parser.setApplicationDescription(
+        QStringLiteral("Lay out control flow graphs and report time, edge crossings and length"));
+    parser.addHelpOption();
+    parser.addPositionalArgument(
+        QStringLiteral("files"), QStringLiteral("Output of agJ, synthetic graphs if none"));
+    QCommandLineOption iterationsOption(
+        {QStringLiteral("n"), QStringLiteral("iterations")},
+        QStringLiteral("Layouts of each graph, the median time is reported"),
+        QStringLiteral("count"),
+        QStringLiteral("5"));
+    QCommandLineOption budgetOption(
+        {QStringLiteral("b"), QStringLiteral("budget")},
+        QStringLiteral("Optimization time budget in milliseconds, 0 for no limit"),
+        QStringLiteral("ms"),
+        QString::number(GRAPH_GRID_OPTIMIZATION_BUDGET_MS));
+    QCommandLineOption layoutOption(
+        {QStringLiteral("l"), QStringLiteral("layout")},
+        QStringLiteral("Grid layout type: medium, wide or narrow"),
+        QStringLiteral("type"),
+        QStringLiteral("medium"));
+    QCommandLineOption noOptimizationOption(
+        QStringLiteral("no-optimization"), QStringLiteral("Skip the layout optimization"));
+    parser.addOptions({iterationsOption, budgetOption, layoutOption, noOptimizationOption});
+    parser.process(app);
+
+    QTextStream out(stdout);
+    QTextStream err(stderr);
+
+    QList<NamedGraph> graphs;
+    const QStringList files = parser.positionalArguments();
+    for (const QString &path : files) {
+        QString error;
+        const QList<NamedGraph> loaded = loadGraphs(path, &error);
+        if (!error.isEmpty()) {
+            err << path << ": " << error << '\n';
+            return 1;
+        }
+        graphs << loaded;
+    }
+    if (files.isEmpty()) {
+        for (int blockCount : {20, 100, 500, 2000}) {
+            graphs << syntheticGraph(blockCount);
+        }
+    }
+
+    GraphGridLayout::LayoutType layoutType = GraphGridLayout::LayoutType::Medium;
+    const QString layoutName = parser.value(layoutOption);
+    if (layoutName == QLatin1String("wide")) {
+        layoutType = GraphGridLayout::LayoutType::Wide;
+    } else if (layoutName == QLatin1String("narrow")) {
+        layoutType = GraphGridLayout::LayoutType::Narrow;
+    } else if (layoutName != QLatin1String("medium")) {
+        err << "Unknown layout type " << layoutName << '\n';
+        return 1;
+    }
+    GraphGridLayout layout(layoutType);
+    layout.setOptimizationTimeBudget(parser.value(budgetOption).toInt());
+    layout.setLayoutOptimization(!parser.isSet(noOptimizationOption));
+    const int iterations = std::max(1, parser.value(iterationsOption).toInt());
+
+    out << "graph\tblocks\tedges\tmedian ms\tmin ms\tcrossings\tedge length\tsize" << '\n';
+    for (const NamedGraph &named : graphs) {
+        size_t edgeCount = 0;
+        for (const auto &block : named.graph) {
+            edgeCount += block.second.edges.size();
+        }
+        std::vector<double> times;
+        GraphLayout::Graph result;
+        int width = 0;
+        int height = 0;
+        for (int i = 0; i < iterations; i++) {
+            result = named.graph;
+            QElapsedTimer timer;
+            timer.start();
+            layout.CalculateLayout(result, named.entry, width, height);
+            times.push_back(timer.nsecsElapsed() / 1e6);
+        }
+        std::sort(times.begin(), times.end());
+        const LayoutStats stats = layoutStats(result);
+        out << named.name << '\t' << named.graph.size() << '\t' << edgeCount << '\t'
+            << QString::number(times[times.size() / 2], 'f', 2) << '\t'
+            << QString::number(times.front(), 'f', 2) << '\t' << stats.crossings << '\t'
+            << QString::number(stats.edgeLength, 'f', 0) << '\t' << width << 'x' << height
+            << '\n';
+    }
+    return 0;
+}
@@ -0,0 +1,272 @@
+#include "common/AddressCoverage.h"
+#include "core/Iaito.h"
+
+#include <algorithm>
+
+void AddressCoverage::invalidate(int sources)
+{
+    dirty |= sources;
+    if (sources & Functions) {
+        staleFunctions.clear();
+    }
+    if (sources & Meta) {
+        staleMeta.clear();
+    }
+}
+
+void AddressCoverage::invalidateFunction(RVA addr)
+{
+    if (!(dirty & Functions)) {
+        staleFunctions.insert(addr);
+    }
+}
+
+void AddressCoverage::invalidateMeta(RVA addr)
+{
+    if (!(dirty & Meta)) {
+        staleMeta.insert(addr);
+    }
+}
+
+void AddressCoverage::sync(RCore *core)
+{
+    if (dirty & Sections) {
+        scanSections(core);
+    }
+    if (dirty & Functions) {
+        scanFunctions(core);
+    }
+    if (dirty & Flags) {
+        scanFlags(core);
+    }
+    if (dirty & Symbols) {
+        scanSymbols(core);
+    }
+    if (dirty & Meta) {
+        scanMeta(core);
+    }
+    dirty = 0;
+
+    for (RVA addr : staleFunctions) {
+        updateFunction(core, addr);
+    }
+    staleFunctions.clear();
+    for (RVA addr : staleMeta) {
+        updateMeta(core, addr);
+    }
+    staleMeta.clear();
+}
+
+void AddressCoverage::scanSections(RCore *core)
+{
+    sections.clear();
+    from = to = 0;
+
+    RListIter *it;
+    RBinSection *bs;
+    const RList *binSections = r_bin_get_sections(core->bin);
+    IaitoRListForeach(binSections, it, RBinSection, bs)
+    {
+        if (bs->is_segment || !bs->vsize) {
+            continue;
+        }
+        ut8 rwx = 0;
+        if (bs->perm & R_PERM_R) {
+            rwx |= (1 << 0);
+        }
+        if (bs->perm & R_PERM_W) {
+            rwx |= (1 << 1);
+        }
+        if (bs->perm & R_PERM_X) {
+            rwx |= (1 << 2);
+        }
+        sections.push_back({bs->vaddr, bs->vaddr + bs->vsize, rwx});
+    }
+    if (sections.empty()) {
+        return;
+    }
+    std::sort(sections.begin(), sections.end(), [](const Range &a, const Range &b) {
+        return a.from < b.from;
+    });
+    from = sections.front().from;
+    for (const Range &section : sections) {
+        to = std::max(to, section.to);
+    }
+}
+
+void AddressCoverage::scanFunctions(RCore *core)
+{
+    functions.clear();
+
+    RListIter *it;
+    RAnalFunction *fcn;
+    IaitoRListForeach(core->anal->fcns, it, RAnalFunction, fcn)
+    {
+        functions[fcn->addr] = fcn->addr + r_anal_function_linear_size(fcn);
+    }
+}
+
+void AddressCoverage::updateFunction(RCore *core, RVA addr)
+{
+    // the function starting at addr and the one it was part of, if any
+    RVA keys[2] = {addr, RVA_INVALID};
+    auto it = functions.upper_bound(addr);
+    if (it != functions.begin()) {
+        --it;
+        if (it->first != addr && it->second > addr) {
+            keys[1] = it->first;
+        }
+    }
+    for (RVA key : keys) {
+        if (key == RVA_INVALID) {
+            continue;
+        }
+        functions.erase(key);
+        RAnalFunction *fcn = r_anal_get_function_at(core->anal, key);
+        if (fcn) {
+            functions[key] = key + r_anal_function_linear_size(fcn);
+        }
+    }
+}
+
+static bool appendFlagAddress(RFlagItem *fi, void *user)
+{
+    static_cast<std::vector<RVA> *>(user)->push_back(ADDRESS_OF(fi));
+    return true;
+}
+
+void AddressCoverage::scanFlags(RCore *core)
+{
+    flags.clear();
+    r_flag_foreach(core->flags, appendFlagAddress, &flags);
+    std::sort(flags.begin(), flags.end());
+}
+
+void AddressCoverage::scanSymbols(RCore *core)
+{
+    symbols.clear();
+
+    RListIter *it;
+    RBinSymbol *bs;
+    const RList *binSymbols = r_bin_get_symbols(core->bin);
+    IaitoRListForeach(binSymbols, it, RBinSymbol, bs)
+    {
+        symbols.push_back(bs->vaddr);
+    }
+    std::sort(symbols.begin(), symbols.end());
+}
+
+void AddressCoverage::scanMeta(RCore *core)
+{
+    strings.clear();
+    comments.clear();
+
+    RIntervalTreeIter it;
+    RAnalMetaItem *item;
+    r_interval_tree_foreach(&core->anal->meta, it, item)
+    {
+        if (item->type == R_META_TYPE_STRING) {
+            strings.insert(r_interval_tree_iter_get(&it)->start);
+        } else if (item->type == R_META_TYPE_COMMENT) {
+            comments.insert(r_interval_tree_iter_get(&it)->start);
+        }
+    }
+}
+
+void AddressCoverage::updateMeta(RCore *core, RVA addr)
+{
+    strings.erase(addr);
+    comments.erase(addr);
+    if (r_meta_get_at(core->anal, addr, R_META_TYPE_STRING, nullptr)) {
+        strings.insert(addr);
+    }
+    if (r_meta_get_at(core->anal, addr, R_META_TYPE_COMMENT, nullptr)) {
+        comments.insert(addr);
+    }
+}
+
+BlockStatistics AddressCoverage::statistics(RCore *core, unsigned int blocksCount)
+{
+    BlockStatistics blockStats;
+    blockStats.from = blockStats.to = blockStats.blocksize = 0;
+    if (blocksCount == 0) {
+        return blockStats;
+    }
+
+    sync(core);
+    if (to <= from) {
+        return blockStats;
+    }
+
+    const RVA blocksize = std::max<RVA>((to - from) / blocksCount, 1);
+    const size_t count = (to - from + blocksize - 1) / blocksize;
+    blockStats.from = from;
+    blockStats.to = to;
+    blockStats.blocksize = blocksize;
+
+    std::vector<BlockDescription> blocks(count);
+    for (size_t i = 0; i < count; i++) {
+        BlockDescription &block = blocks[i];
+        block.addr = from + i * blocksize;
+        block.size = std::min(blocksize, to - block.addr);
+        block.flags = block.functions = block.inFunctions = 0;
+        block.comments = block.symbols = block.strings = 0;
+        block.rwx = 0;
+    }
+
+    auto blockIndex = [&](RVA addr) -> size_t { return (addr - from) / blocksize; };
+    auto countIn = [&](const auto &addresses, int BlockDescription::*field) {
+        for (auto it = std::lower_bound(addresses.begin(), addresses.end(), from);
+             it != addresses.end() && *it < to;
+             ++it) {
+            blocks[blockIndex(*it)].*field += 1;
+        }
+    };
+    countIn(flags, &BlockDescription::flags);
+    countIn(symbols, &BlockDescription::symbols);
+
+    // std::lower_bound on a std::set is linear, use its own lookup
+    for (auto it = strings.lower_bound(from); it != strings.end() && *it < to; ++it) {
+        blocks[blockIndex(*it)].strings++;
+    }
+    for (auto it = comments.lower_bound(from); it != comments.end() && *it < to; ++it) {
+        blocks[blockIndex(*it)].comments++;
+    }
+
+    // functions covering a block are accumulated as +1/-1 at the range ends
+    std::vector<int> inFunctions(count + 1, 0);
+    for (const auto &function : functions) {
+        RVA start = function.first;
+        RVA end = std::max(function.second, start + 1);
+        if (end <= from || start >= to) {
+            continue;
+        }
+        if (start >= from) {
+            blocks[blockIndex(start)].functions++;
+        }
+        inFunctions[blockIndex(std::max(start, from))]++;
+        inFunctions[blockIndex(std::min(end, to) - 1) + 1]--;
+    }
+    int covering = 0;
+    for (size_t i = 0; i < count; i++) {
+        covering += inFunctions[i];
+        blocks[i].inFunctions = covering;
+    }
+
+    // the sections are sorted, walk them along the blocks
+    auto section = sections.begin();
+    for (BlockDescription &block : blocks) {
+        while (section != sections.end() && section->to <= block.addr) {
+            ++section;
+        }
+        if (section != sections.end() && section->from <= block.addr) {
+            block.rwx = section->rwx;
+        }
+    }
+
+    blockStats.blocks.reserve(int(count));
+    for (const BlockDescription &block : blocks) {
+        blockStats.blocks << block;
+    }
+    return blockStats;
+}
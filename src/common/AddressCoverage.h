@@ -0,0 +1,91 @@
+#ifndef ADDRESSCOVERAGE_H
+#define ADDRESSCOVERAGE_H
+
+#include "core/IaitoCommon.h"
+#include "core/IaitoDescriptions.h"
+
+#include <QSet>
+
+#include <map>
+#include <set>
+#include <vector>
+
+/**
+ * @brief Address map of the binary sections with the functions, flags,
+ * symbols, strings and comments they contain, used to build the block
+ * statistics shown by the visual navbar.
+ *
+ * The addresses are collected directly from RAnal, RFlag, RBin and the meta
+ * interval tree and kept sorted, so statistics() only has to distribute them
+ * over the requested number of blocks instead of running "p-j". Every source
+ * is refreshed separately and lazily: a single function or meta item can be
+ * updated without rescanning the others.
+ *
+ * Not thread safe, IaitoCore only uses it with the core lock held.
+ */
+class IAITO_EXPORT AddressCoverage
+{
+public:
+    enum Source {
+        Sections = 1 << 0,
+        Functions = 1 << 1,
+        Flags = 1 << 2,
+        Symbols = 1 << 3,
+        Meta = 1 << 4,
+        AllSources = 0x1f
+    };
+
+    /**
+     * @brief Rescan \a sources on the next call to statistics()
+     */
+    void invalidate(int sources = AllSources);
+    /**
+     * @brief Look up again the function at or containing \a addr only
+     */
+    void invalidateFunction(RVA addr);
+    /**
+     * @brief Look up again the strings and comments at \a addr only
+     */
+    void invalidateMeta(RVA addr);
+
+    /**
+     * @brief Statistics for the binary sections split in about \a blocksCount
+     * blocks, like "p-j" with search.in=bin.sections
+     */
+    BlockStatistics statistics(RCore *core, unsigned int blocksCount);
+
+private:
+    struct Range
+    {
+        RVA from;
+        RVA to;
+        ut8 rwx;
+    };
+
+    int dirty = AllSources;
+    QSet<RVA> staleFunctions;
+    QSet<RVA> staleMeta;
+
+    RVA from = 0;
+    RVA to = 0;
+    std::vector<Range> sections;
+    /**
+     * function address -> end of its linear range
+     */
+    std::map<RVA, RVA> functions;
+    std::vector<RVA> flags;
+    std::vector<RVA> symbols;
+    std::set<RVA> strings;
+    std::set<RVA> comments;
+
+    void sync(RCore *core);
+    void scanSections(RCore *core);
+    void scanFunctions(RCore *core);
+    void scanFlags(RCore *core);
+    void scanSymbols(RCore *core);
+    void scanMeta(RCore *core);
+    void updateFunction(RCore *core, RVA addr);
+    void updateMeta(RCore *core, RVA addr);
+};
+
+#endif // ADDRESSCOVERAGE_H
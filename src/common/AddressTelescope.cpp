@@ -0,0 +1,262 @@
+#include "common/AddressTelescope.h"
+#include "common/Configuration.h"
+#include "core/Iaito.h"
+
+#include <cstring>
+
+void AddressTelescope::sync(quint64 ioGeneration)
+{
+    if (ioGeneration != this->ioGeneration) {
+        clear();
+        this->ioGeneration = ioGeneration;
+    }
+}
+
+void AddressTelescope::clear()
+{
+    nodes.clear();
+    descriptions.clear();
+    window.clear();
+}
+
+void AddressTelescope::read(RCore *core, RVA addr, char *buf, int len) const
+{
+    RVA windowEnd = windowAddr + RVA(window.size());
+    if (addr >= windowAddr && addr <= windowEnd && RVA(len) <= windowEnd - addr) {
+        memcpy(buf, window.constData() + (addr - windowAddr), len);
+        return;
+    }
+    r_io_read_at(core->io, addr, reinterpret_cast<ut8 *>(buf), len);
+}
+
+RVA AddressTelescope::pointerIn(const char *buf) const
+{
+    if (bits == 64) {
+        ut64 n64;
+        memcpy(&n64, buf, sizeof(n64));
+        return n64;
+    }
+    ut32 n32;
+    memcpy(&n32, buf, sizeof(n32));
+    return n32;
+}
+
+const AddressTelescope::Node &AddressTelescope::node(RCore *core, RVA addr)
+{
+    auto it = nodes.find(addr);
+    if (it != nodes.end()) {
+        return it->second;
+    }
+
+    Node &node = nodes[addr];
+    const ut64 type = r_core_anal_address(core, addr);
+    node.type = type;
+
+    // Search for the section the addr is in, avoid duplication for heap/stack
+    // with type
+    if (!(type & R_ANAL_ADDR_TYPE_HEAP || type & R_ANAL_ADDR_TYPE_STACK)) {
+        RDebugMap *map = r_debug_map_get(core->dbg, addr);
+        if (map && map->name && map->name[0]) {
+            node.mapName = map->name;
+        }
+        RBinSection *sect = r_bin_get_section_at(r_bin_cur_object(core->bin), addr, true);
+        if (sect && sect->name[0]) {
+            node.section = sect->name;
+        }
+    }
+
+    // Check if the address points to a register
+    RFlagItem *fi = r_flag_get_i(core->flags, addr);
+    if (fi) {
+        RRegItem *r = r_reg_get(core->dbg->reg, fi->name, -1);
+        if (r) {
+            node.reg = r->name;
+#if R2_VERSION_NUMBER >= 50709
+            r_unref(r);
+#endif
+        }
+    }
+
+    if (type & R_ANAL_ADDR_TYPE_HEAP) {
+        node.typeName = QStringLiteral("heap");
+    } else if (type & R_ANAL_ADDR_TYPE_STACK) {
+        node.typeName = QStringLiteral("stack");
+    } else if (type & R_ANAL_ADDR_TYPE_PROGRAM) {
+        node.typeName = QStringLiteral("program");
+    } else if (type & R_ANAL_ADDR_TYPE_LIBRARY) {
+        node.typeName = QStringLiteral("library");
+    } else if (type & R_ANAL_ADDR_TYPE_ASCII) {
+        node.typeName = QStringLiteral("ascii");
+    } else if (type & R_ANAL_ADDR_TYPE_SEQUENCE) {
+        node.typeName = QStringLiteral("sequence");
+    }
+
+    if (type & R_ANAL_ADDR_TYPE_READ) {
+        node.perms += "r";
+    }
+    if (type & R_ANAL_ADDR_TYPE_WRITE) {
+        node.perms += "w";
+    }
+    if (type & R_ANAL_ADDR_TYPE_EXEC) {
+        node.perms += "x";
+        char buf[32];
+        read(core, addr, buf, sizeof(buf));
+        r_asm_set_pc(core->rasm, addr);
+#if R2_VERSION_NUMBER >= 50709
+        RAnalOp op;
+        r_anal_op_init(&op);
+        r_asm_disassemble(core->rasm, &op, reinterpret_cast<ut8 *>(buf), sizeof(buf));
+        node.disassembly = op.mnemonic;
+        r_anal_op_fini(&op);
+#else
+        RAsmOp op;
+        r_asm_disassemble(core->rasm, &op, reinterpret_cast<ut8 *>(buf), sizeof(buf));
+        node.disassembly = r_asm_op_get_asm(&op);
+#endif
+    } else if (type & R_ANAL_ADDR_TYPE_READ) {
+        char buf[sizeof(ut64)];
+        read(core, addr, buf, sizeof(buf));
+        node.dereferenceable = true;
+        node.value = pointerIn(buf);
+    }
+    return node;
+}
+
+const QString &AddressTelescope::string(RCore *core, RVA addr)
+{
+    Node &node = nodes[addr];
+    if (!node.stringRead) {
+        QByteArray buf(128, '\0');
+        read(core, addr, buf.data(), buf.size());
+        node.string = QString(buf);
+        // Indicate that the string is longer than the printed value
+        if (node.string.size() == buf.size()) {
+            node.string += "...";
+        }
+        node.stringRead = true;
+    }
+    return node.string;
+}
+
+bool AddressTelescope::hasRef(RCore *core, RVA addr, int depth)
+{
+    return depth >= 1 && addr != UT64_MAX && !node(core, addr).typeName.isEmpty();
+}
+
+bool AddressTelescope::hasString(RCore *core, RVA addr, int depth)
+{
+    const Node &n = node(core, addr);
+    return n.dereferenceable && n.value != addr && hasRef(core, n.value, depth - 1)
+           && node(core, n.value).typeName == QLatin1String("ascii");
+}
+
+RefDescription AddressTelescope::describe(RCore *core, RVA addr, int depth)
+{
+    RefDescription desc;
+    if (depth < 1 || addr == UT64_MAX) {
+        return desc;
+    }
+    const QPair<RVA, int> key(addr, depth);
+    auto cached = descriptions.constFind(key);
+    if (cached != descriptions.constEnd()) {
+        return *cached;
+    }
+    bits = r_config_get_i(core->config, "asm.bits");
+
+    // Ignore refs that only contain addr
+    const Node &first = node(core, addr);
+    if (first.mapName.isEmpty() && first.section.isEmpty() && first.reg.isEmpty()
+        && first.typeName.isEmpty() && first.perms.isEmpty() && !first.dereferenceable) {
+        descriptions.insert(key, desc);
+        return desc;
+    }
+
+    if (hasString(core, addr, depth) && !string(core, addr).isEmpty()) {
+        desc.ref = string(core, addr);
+        desc.refColor = ConfigColor("comment");
+        descriptions.insert(key, desc);
+        return desc;
+    }
+
+    auto append = [&desc](const QString &val, const char *prefix, const char *suffix) {
+        if (!val.isEmpty()) {
+            desc.ref += prefix + val + suffix;
+        }
+    };
+    QString type, string;
+    RVA current = addr;
+    for (int level = depth; level >= 1; level--) {
+        const Node &n = node(core, current);
+        desc.ref += " ->";
+        append(n.reg, " @", "");
+        append(n.mapName, " (", ")");
+        append(n.section, " (", ")");
+        type = n.typeName;
+        append(n.typeName, " ", "");
+        append(n.perms, " ", "");
+        append(n.disassembly, " \"", "\"");
+        if (hasString(core, current, level)) {
+            // There is no point in adding ascii and addr info after a string
+            string = this->string(core, current);
+            append(string, " ", "");
+            break;
+        }
+        if (n.dereferenceable) {
+            append(RAddressString(n.value), " ", "");
+        }
+        if (!n.dereferenceable || n.value == current || !hasRef(core, n.value, level - 1)) {
+            break;
+        }
+        current = n.value;
+    }
+
+    // Set the ref's color according to the last item type
+    if (type == "ascii" || !string.isEmpty()) {
+        desc.refColor = ConfigColor("comment");
+    } else if (type == "program") {
+        desc.refColor = ConfigColor("fname");
+    } else if (type == "library") {
+        desc.refColor = ConfigColor("floc");
+    } else if (type == "stack") {
+#if R2_VERSION_NUMBER >= 50909
+        desc.refColor = ConfigColor("addr");
+#else
+        desc.refColor = ConfigColor("offset");
+#endif
+    }
+    descriptions.insert(key, desc);
+    return desc;
+}
+
+QList<TelescopeDescription> AddressTelescope::stack(
+    RCore *core, RVA sp, const QByteArray &bytes, int size, int depth)
+{
+    QList<TelescopeDescription> stack;
+    bits = r_config_get_i(core->config, "asm.bits");
+    const int step = bits / 8;
+    if (step < 1 || size < 1 || bytes.size() < size + int(sizeof(ut64))) {
+        return stack;
+    }
+
+    // the slots and any reference into the window are served from it
+    windowAddr = sp;
+    window = bytes;
+
+    for (int i = 0; i < size; i += step) {
+        RVA slot = sp + i;
+        if ((bits == 32 && slot >= UT32_MAX) || (bits == 16 && slot >= UT16_MAX)) {
+            break;
+        }
+        TelescopeDescription item;
+        item.addr = slot;
+        const Node &n = node(core, slot);
+        if (n.dereferenceable) {
+            item.value = n.value;
+            if (n.value != slot && hasRef(core, n.value, depth - 1)) {
+                item.refDesc = describe(core, n.value, depth - 1);
+            }
+        }
+        stack << item;
+    }
+    return stack;
+}
@@ -0,0 +1,96 @@
+#ifndef ADDRESSTELESCOPE_H
+#define ADDRESSTELESCOPE_H
+
+#include "core/IaitoCommon.h"
+#include "core/IaitoDescriptions.h"
+
+#include <QByteArray>
+#include <QHash>
+#include <QPair>
+
+#include <unordered_map>
+
+/**
+ * @brief Telescoping of the stack and registers shown by the debug widgets.
+ *
+ * Every address reached while dereferencing is classified once (address
+ * type, debug map, section, register flag, disassembly when executable and the
+ * pointer it holds) and kept together with the formatted reference chains
+ * until the IO generation changes, that is until the next debug stop or
+ * write. Values shared by several stack slots and registers, and the tails of
+ * their chains, are resolved a single time. The stack window is read by the
+ * caller with one IO call and dereferences falling inside it don't read again.
+ *
+ * Produces the same descriptions as IaitoCore::formatRefDesc() applied to
+ * IaitoCore::getAddrRefs(). Not thread safe, IaitoCore only uses it with the
+ * core lock held.
+ */
+class IAITO_EXPORT AddressTelescope
+{
+public:
+    /**
+     * @brief Drops everything if \a ioGeneration differs from the one the
+     * cached data was read at.
+     */
+    void sync(quint64 ioGeneration);
+    void clear();
+
+    /**
+     * @brief The \a size bytes above \a sp with the references of their values
+     * @param bytes memory read at \a sp, \a size bytes and the pointer after
+     * them
+     */
+    QList<TelescopeDescription> stack(
+        RCore *core, RVA sp, const QByteArray &bytes, int size, int depth);
+    /**
+     * @brief Formatted chain of references starting at \a addr
+     */
+    RefDescription describe(RCore *core, RVA addr, int depth);
+
+private:
+    struct Node
+    {
+        ut64 type = 0;
+        QString typeName;
+        QString perms;
+        QString mapName;
+        QString section;
+        QString reg;
+        QString disassembly;
+        /**
+         * readable and not executable, value holds the pointer read at it
+         */
+        bool dereferenceable = false;
+        RVA value = 0;
+        bool stringRead = false;
+        QString string;
+    };
+
+    quint64 ioGeneration = 0;
+    int bits = 0;
+    /**
+     * nodes are referenced while others are added, the map keeps them in place
+     */
+    std::unordered_map<RVA, Node> nodes;
+    QHash<QPair<RVA, int>, RefDescription> descriptions;
+
+    RVA windowAddr = 0;
+    QByteArray window;
+
+    const Node &node(RCore *core, RVA addr);
+    const QString &string(RCore *core, RVA addr);
+    void read(RCore *core, RVA addr, char *buf, int len) const;
+    RVA pointerIn(const char *buf) const;
+    /**
+     * @brief Whether getAddrRefs() would return a reference at \a addr, i.e.
+     * it has a known type
+     */
+    bool hasRef(RCore *core, RVA addr, int depth);
+    /**
+     * @brief Whether getAddrRefs() would show the string at \a addr because
+     * the pointer it holds is ascii
+     */
+    bool hasString(RCore *core, RVA addr, int depth);
+};
+
+#endif // ADDRESSTELESCOPE_H
@@ -74,11 +74,26 @@ AsyncTaskManager::~AsyncTaskManager() {}
 
 void AsyncTaskManager::start(AsyncTask::Ptr task)
 {
-    tasks.append(task);
+    run(task, false);
+    emit tasksChanged();
+}
+
+void AsyncTaskManager::startInternal(AsyncTask::Ptr task)
+{
+    run(task, true);
+}
+
+void AsyncTaskManager::run(AsyncTask::Ptr task, bool internal)
+{
+    (internal ? internalTasks : tasks).append(task);
     task->prepareRun();
 
     QWeakPointer<AsyncTask> weakPtr = task;
-    connect(task.data(), &AsyncTask::finished, this, [this, weakPtr]() {
+    connect(task.data(), &AsyncTask::finished, this, [this, weakPtr, internal]() {
+        if (internal) {
+            internalTasks.removeOne(weakPtr);
+            return;
+        }
         tasks.removeOne(weakPtr);
         emit tasksChanged();
     });
@@ -86,7 +101,6 @@ void AsyncTaskManager::start(AsyncTask::Ptr task)
     threadPool->setStackSize(R2THREAD_STACK_SIZE);
 #endif
     threadPool->start(task.data());
-    emit tasksChanged();
 }
 
 bool AsyncTaskManager::getTasksRunning()
@@ -69,12 +69,20 @@ class AsyncTaskManager : public QObject
 private:
     QThreadPool *threadPool;
     QList<AsyncTask::Ptr> tasks;
+    QList<AsyncTask::Ptr> internalTasks;
+
+    void run(AsyncTask::Ptr task, bool internal);
 
 public:
     explicit AsyncTaskManager(QObject *parent = nullptr);
     ~AsyncTaskManager();
 
     void start(AsyncTask::Ptr task);
+    /**
+     * @brief Run \a task like start() without showing it as running, for
+     * short background work the user did not ask for
+     */
+    void startInternal(AsyncTask::Ptr task);
     bool getTasksRunning();
 
 signals:
@@ -0,0 +1,84 @@
+#include "common/BreakpointIndex.h"
+
+void BreakpointIndex::invalidate()
+{
+    valid = false;
+    staleAddresses.clear();
+}
+
+void BreakpointIndex::invalidateAt(RVA addr)
+{
+    if (valid) {
+        staleAddresses.insert(addr);
+    }
+}
+
+void BreakpointIndex::insert(RVA addr)
+{
+    addressSet.insert(addr);
+    sortedAddresses.insert(addr);
+}
+
+void BreakpointIndex::remove(RVA addr)
+{
+    addressSet.remove(addr);
+    sortedAddresses.erase(addr);
+}
+
+void BreakpointIndex::sync(RCore *core)
+{
+    RBreakpoint *bp = core->dbg->bp;
+    const int current = r_list_length(bp->bps);
+    if (!staleAddresses.isEmpty()) {
+        for (RVA addr : staleAddresses) {
+            remove(addr);
+            if (r_bp_get_at(bp, addr)) {
+                insert(addr);
+            }
+        }
+        staleAddresses.clear();
+        count = current;
+    }
+    if (valid && count == current) {
+        return;
+    }
+
+    addressSet.clear();
+    sortedAddresses.clear();
+    RListIter *it;
+    RBreakpointItem *bpi;
+    IaitoRListForeach(bp->bps, it, RBreakpointItem, bpi)
+    {
+        insert(bpi->addr);
+    }
+    count = current;
+    valid = true;
+}
+
+bool BreakpointIndex::contains(RCore *core, RVA addr)
+{
+    sync(core);
+    return addressSet.contains(addr);
+}
+
+QList<RVA> BreakpointIndex::inRange(RCore *core, RVA from, RVA to)
+{
+    sync(core);
+    QList<RVA> result;
+    for (auto it = sortedAddresses.lower_bound(from); it != sortedAddresses.end() && *it < to;
+         ++it) {
+        result << *it;
+    }
+    return result;
+}
+
+QList<RVA> BreakpointIndex::addresses(RCore *core)
+{
+    sync(core);
+    QList<RVA> result;
+    result.reserve(int(sortedAddresses.size()));
+    for (RVA addr : sortedAddresses) {
+        result << addr;
+    }
+    return result;
+}
@@ -0,0 +1,52 @@
+#ifndef BREAKPOINTINDEX_H
+#define BREAKPOINTINDEX_H
+
+#include "core/IaitoCommon.h"
+
+#include <QList>
+#include <QSet>
+
+#include <set>
+
+/**
+ * @brief Addresses of the breakpoints, hashed for the per line lookups done
+ * while rendering code and sorted for the lookups of a function or range.
+ *
+ * The index is rebuilt from RBreakpoint after invalidate() and updated per
+ * address after invalidateAt(). A different breakpoint count, e.g. after a
+ * "db" typed in the console, also rebuilds it.
+ *
+ * Not thread safe, IaitoCore only uses it with the core lock held.
+ */
+class IAITO_EXPORT BreakpointIndex
+{
+public:
+    void invalidate();
+    /**
+     * @brief Look up again the breakpoint at \a addr only
+     */
+    void invalidateAt(RVA addr);
+
+    bool contains(RCore *core, RVA addr);
+    /**
+     * @return the sorted breakpoint addresses in [from, to)
+     */
+    QList<RVA> inRange(RCore *core, RVA from, RVA to);
+    /**
+     * @return all the breakpoint addresses, sorted
+     */
+    QList<RVA> addresses(RCore *core);
+
+private:
+    bool valid = false;
+    int count = 0;
+    QSet<RVA> staleAddresses;
+    QSet<RVA> addressSet;
+    std::set<RVA> sortedAddresses;
+
+    void sync(RCore *core);
+    void insert(RVA addr);
+    void remove(RVA addr);
+};
+
+#endif // BREAKPOINTINDEX_H
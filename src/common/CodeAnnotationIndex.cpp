@@ -0,0 +1,161 @@
+#include "common/CodeAnnotationIndex.h"
+
+#include <algorithm>
+
+void CodeAnnotationIndex::Intervals::sort()
+{
+    std::sort(entries.begin(), entries.end(), [](const Entry &a, const Entry &b) {
+        return a.start != b.start ? a.start < b.start : a.index < b.index;
+    });
+    maxEnd.resize(entries.size());
+    size_t end = 0;
+    for (size_t i = 0; i < entries.size(); i++) {
+        end = std::max(end, entries[i].end);
+        maxEnd[i] = end;
+    }
+}
+
+void CodeAnnotationIndex::Intervals::clear()
+{
+    entries.clear();
+    maxEnd.clear();
+}
+
+void CodeAnnotationIndex::Intervals::overlapping(
+    size_t from, size_t to, const std::function<bool(const Entry &)> &f) const
+{
+    auto last = std::lower_bound(
+        entries.begin(), entries.end(), to, [](const Entry &e, size_t pos) {
+            return e.start < pos;
+        });
+    for (size_t i = last - entries.begin(); i-- > 0;) {
+        // No entry up to this one reaches the range
+        if (maxEnd[i] <= from) {
+            break;
+        }
+        if (entries[i].end > from && !f(entries[i])) {
+            return;
+        }
+    }
+}
+
+void CodeAnnotationIndex::clear()
+{
+    offsets.clear();
+    syntaxHighlights.clear();
+    others.clear();
+    byOffset.clear();
+}
+
+void CodeAnnotationIndex::build(RCodeMeta *code)
+{
+    clear();
+    if (!code) {
+        return;
+    }
+    int index = 0;
+    void *iter;
+    r_vector_foreach(&code->annotations, iter)
+    {
+        RCodeMetaItem *item = (RCodeMetaItem *) iter;
+        const Entry entry = {item->start, item->end, index++, item};
+        if (item->type == R_CODEMETA_TYPE_OFFSET) {
+            offsets.add(entry);
+            byOffset.push_back(entry);
+        } else if (item->type == R_CODEMETA_TYPE_SYNTAX_HIGHLIGHT) {
+            syntaxHighlights.add(entry);
+        } else {
+            others.add(entry);
+        }
+    }
+    offsets.sort();
+    syntaxHighlights.sort();
+    others.sort();
+    std::sort(byOffset.begin(), byOffset.end(), [](const Entry &a, const Entry &b) {
+        const RVA offsetA = a.item->offset.offset;
+        const RVA offsetB = b.item->offset.offset;
+        return offsetA != offsetB ? offsetA < offsetB : a.index < b.index;
+    });
+}
+
+RVA CodeAnnotationIndex::offsetAt(size_t pos) const
+{
+    // The innermost annotation starts last, the first one in the code wins ties
+    const Entry *found = nullptr;
+    offsets.overlapping(pos, pos + 1, [&found](const Entry &e) {
+        if (found && found->start != e.start) {
+            return false;
+        }
+        found = &e;
+        return true;
+    });
+    return found ? found->item->offset.offset : RVA_INVALID;
+}
+
+size_t CodeAnnotationIndex::positionForOffset(RVA offset) const
+{
+    auto after = std::upper_bound(
+        byOffset.begin(), byOffset.end(), offset, [](RVA value, const Entry &e) {
+            return value < e.item->offset.offset;
+        });
+    if (after == byOffset.begin()) {
+        return SIZE_MAX;
+    }
+    const RVA closest = std::prev(after)->item->offset.offset;
+    auto first = std::lower_bound(byOffset.begin(), after, closest, [](const Entry &e, RVA value) {
+        return e.item->offset.offset < value;
+    });
+    return first->start;
+}
+
+RVA CodeAnnotationIndex::firstOffsetIn(size_t startPos, size_t endPos) const
+{
+    RVA firstOffset = RVA_MAX;
+    // Also visit the empty annotations starting at startPos
+    const size_t from = startPos ? startPos - 1 : 0;
+    offsets.overlapping(from, endPos, [&](const Entry &e) {
+        if ((startPos <= e.start && e.start < endPos) || (startPos < e.end && e.end < endPos)) {
+            firstOffset = std::min(firstOffset, RVA(e.item->offset.offset));
+        }
+        return true;
+    });
+    return firstOffset;
+}
+
+RCodeMetaItem *CodeAnnotationIndex::annotationAt(size_t pos) const
+{
+    const Entry *found = nullptr;
+    others.overlapping(pos, pos + 1, [&found](const Entry &e) {
+        if (!found || e.index < found->index) {
+            found = &e;
+        }
+        return true;
+    });
+    return found ? found->item : nullptr;
+}
+
+void CodeAnnotationIndex::syntaxHighlightsIn(
+    size_t start, size_t end, const std::function<void(const RCodeMetaItem *)> &f) const
+{
+    std::vector<const Entry *> found;
+    syntaxHighlights.overlapping(start, end, [&found](const Entry &e) {
+        found.push_back(&e);
+        return true;
+    });
+    std::sort(found.begin(), found.end(), [](const Entry *a, const Entry *b) {
+        return a->index < b->index;
+    });
+    for (const Entry *e : found) {
+        f(e->item);
+    }
+}
+
+RVA CodeAnnotationIndex::lowestOffset() const
+{
+    return byOffset.empty() ? RVA_MAX : RVA(byOffset.front().item->offset.offset);
+}
+
+RVA CodeAnnotationIndex::highestOffset() const
+{
+    return byOffset.empty() ? 0 : RVA(byOffset.back().item->offset.offset);
+}
@@ -0,0 +1,92 @@
+#ifndef CODEANNOTATIONINDEX_H
+#define CODEANNOTATIONINDEX_H
+
+#include "core/IaitoCommon.h"
+
+#include <functional>
+#include <vector>
+
+/**
+ * @brief Sorted index of the annotations of a decompiled function, answering
+ * the position and offset lookups of the decompiler widget in O(log n) plus
+ * the number of matches instead of walking every annotation.
+ *
+ * It points into the RCodeMeta it was built from and must be rebuilt
+ * whenever that code is replaced. DecompilerWidget builds it in setCode()
+ * and shares it with DecompilerHighlighter and DecompilerContextMenu.
+ */
+class IAITO_EXPORT CodeAnnotationIndex
+{
+public:
+    void build(RCodeMeta *code);
+    void clear();
+
+    /**
+     * @brief Offset of the innermost offset annotation covering \a pos
+     * @return RVA_INVALID if there is none
+     */
+    RVA offsetAt(size_t pos) const;
+    /**
+     * @brief Start of the first annotation of the greatest offset not above
+     * \a offset
+     * @return SIZE_MAX if there is none
+     */
+    size_t positionForOffset(RVA offset) const;
+    /**
+     * @brief Lowest offset of the annotations starting in [startPos, endPos)
+     * or ending in (startPos, endPos)
+     * @return RVA_MAX if there is none
+     */
+    RVA firstOffsetIn(size_t startPos, size_t endPos) const;
+    /**
+     * @brief First annotation covering \a pos that is neither an offset nor a
+     * syntax highlight, i.e. a function, variable or constant
+     */
+    RCodeMetaItem *annotationAt(size_t pos) const;
+    /**
+     * @brief Call \a f with the syntax highlight annotations overlapping
+     * [start, end), in the order of the code annotations
+     */
+    void syntaxHighlightsIn(
+        size_t start, size_t end, const std::function<void(const RCodeMetaItem *)> &f) const;
+
+    RVA lowestOffset() const;
+    RVA highestOffset() const;
+
+private:
+    struct Entry
+    {
+        size_t start;
+        size_t end;
+        int index; //!< in the code annotations
+        RCodeMetaItem *item;
+    };
+
+    /**
+     * @brief Entries sorted by start, with the greatest end up to each one,
+     * to find the ones overlapping a range with a binary search and a walk
+     * back over the candidates only.
+     */
+    struct Intervals
+    {
+        std::vector<Entry> entries;
+        std::vector<size_t> maxEnd;
+
+        void add(const Entry &entry) { entries.push_back(entry); }
+        void sort();
+        void clear();
+        /**
+         * @brief Call \a f with the entries overlapping [from, to), by
+         * decreasing start. Stops when \a f returns false.
+         */
+        void overlapping(size_t from, size_t to, const std::function<bool(const Entry &)> &f) const;
+    };
+
+    Intervals offsets;
+    Intervals syntaxHighlights;
+    Intervals others;
+    /** offset annotations sorted by offset, then by index */
+    std::vector<Entry> byOffset;
+};
+
+#endif // CODEANNOTATIONINDEX_H
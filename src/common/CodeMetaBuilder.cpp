@@ -0,0 +1,174 @@
+#include "common/CodeMetaBuilder.h"
+
+#include <cstring>
+
+namespace {
+
+/**
+ * @brief Line printed by r2dec for an item of its "lines" array if \a code,
+ * else of its "log" or "errors" arrays. nullptr if there is none.
+ */
+const char *r2decLine(const RJson *item, bool code)
+{
+    if (code && item->type == R_JSON_OBJECT) {
+        const RJson *str = r_json_get(item, "str");
+        return str && str->type == R_JSON_STRING ? str->str_value : "";
+    }
+    if (!code && item->type == R_JSON_STRING) {
+        return item->str_value;
+    }
+    return nullptr;
+}
+
+} // namespace
+
+RCodeMeta *CodeMetaBuilder::fromText(char *text)
+{
+    RCodeMeta *code = r_codemeta_new("");
+    R_FREE(code->code);
+    code->code = text ? text : strdup("");
+    return code;
+}
+
+RCodeMeta *CodeMetaBuilder::fromJson(char *json)
+{
+    RJson *root = json ? r_json_parse(json) : nullptr;
+    if (!root || root->type != R_JSON_OBJECT || !root->children.count) {
+        if (root) {
+            r_json_free(root);
+        }
+        r_mem_free(json);
+        return nullptr;
+    }
+
+    RCodeMeta *code = r_codemeta_new("");
+    const RJson *annotations = r_json_get(root, "annotations");
+    if (annotations && annotations->type == R_JSON_ARRAY) {
+        r_vector_reserve(&code->annotations, annotations->children.count);
+        for (const RJson *item = annotations->children.first; item; item = item->next) {
+            const RJson *type = r_json_get(item, "type");
+            if (!type || type->type != R_JSON_STRING || strcmp(type->str_value, "offset")) {
+                continue;
+            }
+            const RJson *start = r_json_get(item, "start");
+            const RJson *end = r_json_get(item, "end");
+            const RJson *offset = r_json_get(item, "offset");
+            RCodeMetaItem *mi = r_codemeta_item_new();
+            mi->type = R_CODEMETA_TYPE_OFFSET;
+            mi->start = start && start->type == R_JSON_INTEGER ? start->num.u_value : 0;
+            mi->end = end && end->type == R_JSON_INTEGER ? end->num.u_value : 0;
+            mi->offset.offset = offset && offset->type == R_JSON_INTEGER ? offset->num.u_value : 0;
+            r_codemeta_add_item(code, mi);
+        }
+    }
+
+    // The strings were unescaped in place, each one inside the buffer
+    const RJson *text = r_json_get(root, "code");
+    const char *codeText = text && text->type == R_JSON_STRING ? text->str_value : "";
+    const size_t codeSize = strlen(codeText);
+    size_t errorsSize = 0;
+    const RJson *errors = r_json_get(root, "errors");
+    if (errors && errors->type == R_JSON_ARRAY) {
+        for (const RJson *error = errors->children.first; error; error = error->next) {
+            if (error->type == R_JSON_STRING) {
+                errorsSize += strlen(error->str_value) + 1;
+            }
+        }
+    }
+
+    R_FREE(code->code);
+    if (!errorsSize) {
+        // Hand the buffer over, moving the code to its start
+        memmove(json, codeText, codeSize + 1);
+        code->code = json;
+        json = nullptr;
+    } else {
+        // The errors may be anywhere in the buffer, assemble them apart
+        char *buf = R_NEWS(char, codeSize + errorsSize + 1);
+        memcpy(buf, codeText, codeSize);
+        char *p = buf + codeSize;
+        for (const RJson *error = errors->children.first; error; error = error->next) {
+            if (error->type == R_JSON_STRING) {
+                const size_t size = strlen(error->str_value);
+                memcpy(p, error->str_value, size);
+                p += size;
+                *p++ = '\n';
+            }
+        }
+        *p = '\0';
+        code->code = buf;
+    }
+    r_json_free(root);
+    r_mem_free(json);
+    return code;
+}
+
+RCodeMeta *CodeMetaBuilder::fromR2DecJson(char *json)
+{
+    RJson *root = json ? r_json_parse(json) : nullptr;
+    if (!root || root->type != R_JSON_OBJECT || !root->children.count) {
+        if (root) {
+            r_json_free(root);
+        }
+        r_mem_free(json);
+        return nullptr;
+    }
+
+    // The log first, then the code lines and the errors, one per line
+    const RJson *arrays[] = {
+        r_json_get(root, "log"),
+        r_json_get(root, "lines"),
+        r_json_get(root, "errors"),
+    };
+    const RJson *codeLines = arrays[1];
+    size_t size = 0;
+    size_t annotationCount = 0;
+    for (const RJson *array : arrays) {
+        if (!array || array->type != R_JSON_ARRAY) {
+            continue;
+        }
+        for (const RJson *item = array->children.first; item; item = item->next) {
+            if (const char *line = r2decLine(item, array == codeLines)) {
+                size += strlen(line) + 1;
+                annotationCount += array == codeLines;
+            }
+        }
+    }
+
+    RCodeMeta *code = r_codemeta_new("");
+    r_vector_reserve(&code->annotations, annotationCount);
+    R_FREE(code->code);
+    char *buf = R_NEWS(char, size + 1);
+    char *p = buf;
+    for (const RJson *array : arrays) {
+        if (!array || array->type != R_JSON_ARRAY) {
+            continue;
+        }
+        for (const RJson *item = array->children.first; item; item = item->next) {
+            const char *line = r2decLine(item, array == codeLines);
+            if (!line) {
+                continue;
+            }
+            const size_t lineSize = strlen(line);
+            memcpy(p, line, lineSize);
+            p[lineSize] = '\n';
+            if (array == codeLines) {
+                const RJson *offset = r_json_get(item, "offset");
+                RCodeMetaItem *mi = r_codemeta_item_new();
+                mi->type = R_CODEMETA_TYPE_OFFSET;
+                mi->start = size_t(p - buf);
+                mi->end = mi->start + lineSize + 1;
+                mi->offset.offset = offset && offset->type == R_JSON_INTEGER
+                                        ? offset->num.u_value
+                                        : 0;
+                r_codemeta_add_item(code, mi);
+            }
+            p += lineSize + 1;
+        }
+    }
+    *p = '\0';
+    code->code = buf;
+    r_json_free(root);
+    r_mem_free(json);
+    return code;
+}
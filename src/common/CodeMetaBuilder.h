@@ -0,0 +1,42 @@
+#ifndef CODEMETABUILDER_H
+#define CODEMETABUILDER_H
+
+#include "core/IaitoCommon.h"
+
+/**
+ * @brief Builds RCodeMeta straight from the output buffer of the decompiler
+ * commands.
+ *
+ * The JSON printed by "pdgj", "pdcj" and "pdzj":
+ * {"code": "...", "annotations": [{"type": "offset", "start": 0, "end": 4,
+ * "offset": 4096}, ...], "errors": ["...", ...]}
+ * is parsed in place with RJson in a single pass, the offset annotations are
+ * added as they are found and the buffer itself becomes the code, so the
+ * pseudo code is neither converted to a QString nor copied around.
+ */
+class IAITO_EXPORT CodeMetaBuilder
+{
+public:
+    /**
+     * @brief Build the code from a decompiler JSON output
+     * @param json buffer allocated by r2, taken over and modified
+     * @return nullptr if \a json is not a decompiler output
+     */
+    static RCodeMeta *fromJson(char *json);
+    /**
+     * @brief Build the code from the JSON printed by "pddj":
+     * {"log": ["...", ...], "lines": [{"str": "...", "offset": 4096}, ...],
+     * "errors": ["...", ...]}
+     * Each string becomes a line, those of "lines" get an offset annotation.
+     * @param json buffer allocated by r2, taken over and modified
+     * @return nullptr if \a json is not a r2dec output
+     */
+    static RCodeMeta *fromR2DecJson(char *json);
+    /**
+     * @brief Code without annotations, for the decompilers printing text
+     * @param text buffer allocated by r2, taken over
+     */
+    static RCodeMeta *fromText(char *text);
+};
+
+#endif // CODEMETABUILDER_H
@@ -13,6 +13,7 @@
 #endif
 
 #include "common/ColorThemeWorker.h"
+#include "common/ConsoleBuffer.h"
 #include "common/ResourcePaths.h"
 #include "common/SyntaxHighlighter.h"
 
@@ -750,6 +751,16 @@ void Configuration::setDecompilerAutoRefreshEnabled(bool enabled)
     s.setValue("decompilerAutoRefresh", enabled);
 }
 
+bool Configuration::getDecompilerPrefetchEnabled()
+{
+    return s.value("decompilerPrefetch", false).toBool();
+}
+
+void Configuration::setDecompilerPrefetchEnabled(bool enabled)
+{
+    s.setValue("decompilerPrefetch", enabled);
+}
+
 void Configuration::enableDecompilerAnnotationHighlighter(bool useDecompilerHighlighter)
 {
     s.setValue("decompilerAnnotationHighlighter", !useDecompilerHighlighter);
@@ -807,6 +818,36 @@ bool Configuration::getOutputRedirectionEnabled() const
     return outputRedirectEnabled;
 }
 
+int Configuration::getConsoleMaxLines() const
+{
+    return s.value("console.maxLines", CONSOLE_MAX_LINES).toInt();
+}
+
+void Configuration::setConsoleMaxLines(int lines)
+{
+    s.setValue("console.maxLines", lines);
+}
+
+qint64 Configuration::getConsoleMaxBytes() const
+{
+    return s.value("console.maxBytes", qint64(CONSOLE_MAX_BYTES)).toLongLong();
+}
+
+void Configuration::setConsoleMaxBytes(qint64 bytes)
+{
+    s.setValue("console.maxBytes", bytes);
+}
+
+bool Configuration::getThreadedModeEnabled() const
+{
+    return s.value("threadedMode", false).toBool();
+}
+
+void Configuration::setThreadedModeEnabled(bool enabled)
+{
+    s.setValue("threadedMode", enabled);
+}
+
 bool Configuration::getGraphBlockEntryOffset()
 {
     return s.value("graphBlockEntryOffset", true).value<bool>();
@@ -162,6 +162,12 @@ public:
 
     bool getDecompilerAutoRefreshEnabled();
     void setDecompilerAutoRefreshEnabled(bool enabled);
+    /**
+     * @brief Whether the decompiler widget decompiles the callers and callees
+     * of the shown function in the background
+     */
+    bool getDecompilerPrefetchEnabled();
+    void setDecompilerPrefetchEnabled(bool enabled);
 
     void enableDecompilerAnnotationHighlighter(bool useDecompilerHighlighter);
     bool isDecompilerAnnotationHighlighterEnabled();
@@ -169,6 +175,12 @@ public:
     // Graph
     int getGraphBlockMaxChars() const { return s.value("graph.maxcols", 100).toInt(); }
     void setGraphBlockMaxChars(int ch) { s.setValue("graph.maxcols", ch); }
+    /**
+     * @brief Levels of callees or callers added when expanding a node of the
+     * function callgraph
+     */
+    int getCallGraphExpandDepth() const { return s.value("graph.callgraph.depth", 2).toInt(); }
+    void setCallGraphExpandDepth(int depth) { s.setValue("graph.callgraph.depth", depth); }
 
     /**
      * @brief Getters and setters for the transaparent option state and scale
@@ -182,6 +194,21 @@ public:
     QPoint getGraphBlockSpacing();
     QPoint getGraphEdgeSpacing();
 
+    /**
+     * @brief Zoom levels below which graph blocks and edges are drawn without
+     * their contents and arrows
+     */
+    double getGraphBlockDetailScale() const
+    {
+        return s.value("graph.lod.blocks", 0.3).toDouble();
+    }
+    void setGraphBlockDetailScale(double scale) { s.setValue("graph.lod.blocks", scale); }
+    double getGraphEdgeDetailScale() const
+    {
+        return s.value("graph.lod.edges", 0.3).toDouble();
+    }
+    void setGraphEdgeDetailScale(double scale) { s.setValue("graph.lod.edges", scale); }
+
     /**
      * @brief Gets whether the entry offset of each block has to be displayed or
      * not
@@ -206,6 +233,22 @@ public:
     void setOutputRedirectionEnabled(bool enabled);
     bool getOutputRedirectionEnabled() const;
 
+    /**
+     * @brief Number of lines and bytes of output kept by the console, the
+     * oldest lines being dropped past either
+     */
+    int getConsoleMaxLines() const;
+    void setConsoleMaxLines(int lines);
+    qint64 getConsoleMaxBytes() const;
+    void setConsoleMaxBytes(qint64 bytes);
+
+    /**
+     * @brief Enable or disable the threaded execution mode, see
+     * IaitoCore::setThreadedMode. The value is read once at startup.
+     */
+    bool getThreadedModeEnabled() const;
+    void setThreadedModeEnabled(bool enabled);
+
 public slots:
     void refreshFont();
 signals:
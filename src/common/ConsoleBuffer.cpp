@@ -0,0 +1,183 @@
+#include "common/ConsoleBuffer.h"
+
+#include <algorithm>
+#include <cstring>
+#include <utility>
+#include <vector>
+
+namespace {
+
+/**
+ * @brief Drop the escapes of a raw line the same way RichTextPainter::fromAnsi
+ * does, without building the colored parts
+ */
+QString stripAnsi(const QByteArray &raw)
+{
+    QByteArray text;
+    text.reserve(raw.size());
+    const char *data = raw.constData();
+    const int size = raw.size();
+    for (int i = 0; i < size; i++) {
+        const char c = data[i];
+        if (c == '\x1b') {
+            if (i + 1 >= size || data[i + 1] != '[') {
+                continue;
+            }
+            int j = i + 2;
+            while (j < size && ((data[j] >= '0' && data[j] <= '9') || data[j] == ';')) {
+                j++;
+            }
+            i = j;
+            continue;
+        }
+        text.append(c == '\t' ? ' ' : c);
+    }
+    return QString::fromUtf8(text);
+}
+
+} // namespace
+
+ConsoleBuffer::ConsoleBuffer()
+    : parsed(CONSOLE_PARSED_LINES)
+{}
+
+void ConsoleBuffer::setLimits(int maxLines, qint64 maxBytes)
+{
+    this->maxLines = std::max(maxLines, 1);
+    this->maxBytes = std::max(maxBytes, qint64(1));
+    trim();
+}
+
+void ConsoleBuffer::append(const char *data, qint64 size)
+{
+    std::vector<std::pair<const char *, qint64>> spans;
+    const char *end = data + size;
+    while (data < end) {
+        const char *eol = static_cast<const char *>(memchr(data, '\n', size_t(end - data)));
+        if (!eol) {
+            spans.emplace_back(data, end - data);
+            break;
+        }
+        spans.emplace_back(data, eol - data);
+        data = eol + 1;
+    }
+
+    // Only copy the lines that will not be dropped right away
+    size_t keep = 0;
+    qint64 keepBytes = 0;
+    while (keep < spans.size() && keep < size_t(maxLines)) {
+        const qint64 lineBytes = std::min(spans[spans.size() - 1 - keep].second, maxBytes);
+        if (keep && keepBytes + lineBytes > maxBytes) {
+            break;
+        }
+        keepBytes += lineBytes;
+        keep++;
+    }
+    if (keep < spans.size()) {
+        first = endLine() + (spans.size() - keep);
+        lines.clear();
+        bytes = 0;
+    }
+    for (size_t i = spans.size() - keep; i < spans.size(); i++) {
+        appendLine(spans[i].first, spans[i].second);
+    }
+    trim();
+}
+
+void ConsoleBuffer::appendLine(const char *data, qint64 size)
+{
+    if (size && data[size - 1] == '\r') {
+        size--;
+    }
+    for (qint64 i = size; i-- > 0;) {
+        if (data[i] == '\r') {
+            data += i + 1;
+            size -= i + 1;
+            break;
+        }
+    }
+    size = std::min(size, maxBytes);
+    lines.emplace_back(data, int(size));
+    bytes += size;
+}
+
+void ConsoleBuffer::trim()
+{
+    while (!lines.empty() && (lines.size() > size_t(maxLines) || bytes > maxBytes)) {
+        bytes -= lines.front().size();
+        lines.pop_front();
+        first++;
+    }
+}
+
+void ConsoleBuffer::clear()
+{
+    // Keep numbering from where it was, so that stale numbers stay invalid
+    first = endLine();
+    lines.clear();
+    bytes = 0;
+    parsed.clear();
+}
+
+ConsoleBuffer::Line ConsoleBuffer::line(quint64 number) const
+{
+    if (const Line *cached = parsed.object(number)) {
+        return *cached;
+    }
+    Line *line = new Line;
+    const QByteArray &raw = lines[size_t(number - first)];
+    line->parts = RichTextPainter::fromAnsi(QString::fromUtf8(raw), &line->plainText);
+    Line result = *line;
+    parsed.insert(number, line);
+    return result;
+}
+
+QString ConsoleBuffer::plainText(quint64 number) const
+{
+    if (const Line *cached = parsed.object(number)) {
+        return cached->plainText;
+    }
+    return stripAnsi(lines[size_t(number - first)]);
+}
+
+bool ConsoleBuffer::find(
+    const QString &text,
+    Qt::CaseSensitivity cs,
+    bool backward,
+    quint64 &number,
+    int &column) const
+{
+    if (text.isEmpty() || lines.empty()) {
+        return false;
+    }
+    if (number < first || number >= endLine()) {
+        number = backward ? endLine() - 1 : first;
+        column = backward ? -1 : 0;
+    }
+
+    // The start line is visited again last for the matches before column
+    quint64 current = number;
+    int from = column;
+    for (size_t i = 0; i <= lines.size(); i++) {
+        const QString lineText = plainText(current);
+        int found = -1;
+        if (!backward) {
+            found = lineText.indexOf(text, from, cs);
+        } else if (from != 0) {
+            found = lineText.lastIndexOf(text, from < 0 ? -1 : from - 1, cs);
+        }
+        if (found >= 0) {
+            number = current;
+            column = found;
+            return true;
+        }
+        if (!backward) {
+            current = current + 1 < endLine() ? current + 1 : first;
+            from = 0;
+        } else {
+            current = current > first ? current - 1 : endLine() - 1;
+            from = -1;
+        }
+    }
+    return false;
+}
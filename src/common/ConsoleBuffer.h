@@ -0,0 +1,96 @@
+#ifndef CONSOLEBUFFER_H
+#define CONSOLEBUFFER_H
+
+#include "common/RichTextPainter.h"
+#include "core/IaitoCommon.h"
+
+#include <QByteArray>
+#include <QCache>
+
+#include <deque>
+
+// Default number of lines kept by the console
+#define CONSOLE_MAX_LINES 100000
+// Default number of bytes of output kept by the console, escapes included
+#define CONSOLE_MAX_BYTES (64 * 1024 * 1024)
+// Number of lines kept parsed for painting
+#define CONSOLE_PARSED_LINES 4096
+
+/**
+ * @brief Output of the console, kept as the raw UTF-8 lines with their ANSI
+ * escapes.
+ *
+ * Once the line or byte limit is reached, the oldest lines are dropped as new
+ * ones come in. Lines are numbered from the first one ever appended, so a
+ * number stays valid until the line is dropped. They are only decoded and
+ * split into colored parts when asked for, that is when ConsoleOutputView
+ * paints them, and the last ones are cached.
+ *
+ * Each line is parsed on its own: colors do not carry over a line break,
+ * which matches r2 resetting them at the end of each line.
+ */
+class IAITO_EXPORT ConsoleBuffer
+{
+public:
+    struct Line
+    {
+        RichTextPainter::List parts;
+        QString plainText;
+    };
+
+    ConsoleBuffer();
+
+    void setLimits(int maxLines, qint64 maxBytes);
+
+    /**
+     * @brief Append the lines of \a size bytes of \a data, the last one
+     * needing no line break. Only what follows the last carriage return of a
+     * line is kept.
+     */
+    void append(const char *data, qint64 size);
+    void append(const QByteArray &data) { append(data.constData(), data.size()); }
+    void clear();
+
+    /** number of the oldest line kept */
+    quint64 firstLine() const { return first; }
+    /** number following the newest line */
+    quint64 endLine() const { return first + lines.size(); }
+    int lineCount() const { return int(lines.size()); }
+    bool isEmpty() const { return lines.empty(); }
+
+    /**
+     * @brief Parsed line \a number, which must be in [firstLine(), endLine())
+     */
+    Line line(quint64 number) const;
+    /**
+     * @brief Text of line \a number without the escapes, not cached
+     */
+    QString plainText(quint64 number) const;
+
+    /**
+     * @brief Look for \a text from \a column of line \a number, wrapping
+     * around at the end of the buffer. Searching backward finds the matches
+     * starting before \a column, -1 standing for the end of the line.
+     * @param number, column the start of the search, set to the match
+     * @return false if there is no match
+     */
+    bool find(
+        const QString &text,
+        Qt::CaseSensitivity cs,
+        bool backward,
+        quint64 &number,
+        int &column) const;
+
+private:
+    std::deque<QByteArray> lines;
+    quint64 first = 0;
+    qint64 bytes = 0;
+    int maxLines = CONSOLE_MAX_LINES;
+    qint64 maxBytes = CONSOLE_MAX_BYTES;
+    mutable QCache<quint64, Line> parsed;
+
+    void appendLine(const char *data, qint64 size);
+    void trim();
+};
+
+#endif // CONSOLEBUFFER_H
@@ -0,0 +1,30 @@
+#include "common/DebugSnapshot.h"
+
+#include <QJsonObject>
+
+QSet<QString> DebugSnapshot::changedRegisters(const DebugSnapshot &previous) const
+{
+    QSet<QString> changed;
+    if (registerRefValues && previous.registerRefValues) {
+        QHash<QString, QString> previousValues;
+        for (const RegisterRefValueDescription &reg : *previous.registerRefValues) {
+            previousValues.insert(reg.name, reg.value);
+        }
+        for (const RegisterRefValueDescription &reg : *registerRefValues) {
+            auto it = previousValues.constFind(reg.name);
+            if (it != previousValues.constEnd() && *it != reg.value) {
+                changed.insert(reg.name);
+            }
+        }
+    } else if (registerValues && previous.registerValues) {
+        const QJsonObject values = registerValues->object();
+        const QJsonObject previousValues = previous.registerValues->object();
+        for (auto it = values.constBegin(); it != values.constEnd(); ++it) {
+            auto previousIt = previousValues.constFind(it.key());
+            if (previousIt != previousValues.constEnd() && *previousIt != it.value()) {
+                changed.insert(it.key());
+            }
+        }
+    }
+    return changed;
+}
@@ -0,0 +1,51 @@
+#ifndef DEBUGSNAPSHOT_H
+#define DEBUGSNAPSHOT_H
+
+#include "core/IaitoCommon.h"
+#include "core/IaitoDescriptions.h"
+
+#include <QByteArray>
+#include <QJsonDocument>
+#include <QSet>
+
+#include <optional>
+
+/**
+ * @brief State of the debugged process at a debug stop, shared by the debug
+ * widgets.
+ *
+ * Each part is queried from r2 the first time a widget asks for it after the
+ * stop and then reused by every other widget showing it, so a step costs one
+ * round trip per kind of data even on remote targets. IaitoCore starts a new
+ * snapshot whenever the registers change, that is after every debug task, and
+ * keeps the previous one to find what changed.
+ *
+ * Not thread safe, IaitoCore only uses it with the core lock held.
+ */
+struct IAITO_EXPORT DebugSnapshot
+{
+    std::optional<QJsonDocument> registerValues;                          //!< drj
+    std::optional<QVector<RegisterRefValueDescription>> registerRefValues; //!< drrj
+    std::optional<RVA> programCounter;
+    std::optional<RVA> stackPointer;
+    std::optional<QJsonDocument> backtrace; //!< dbtj
+    std::optional<QJsonDocument> threads;   //!< dptj
+    std::optional<QList<MemoryMapDescription>> memoryMap;
+    std::optional<QList<BreakpointDescription>> breakpoints;
+
+    /**
+     * bytes read at stackAddr, valid while the IO generation is stackGeneration
+     */
+    QByteArray stack;
+    RVA stackAddr = RVA_INVALID;
+    quint64 stackGeneration = 0;
+
+    bool hasRegisters() const { return registerValues || registerRefValues; }
+    /**
+     * @brief Names of the registers whose value differs in \a previous, if
+     * both snapshots have them
+     */
+    QSet<QString> changedRegisters(const DebugSnapshot &previous) const;
+};
+
+#endif // DEBUGSNAPSHOT_H
@@ -0,0 +1,79 @@
+#include "common/DecompileAllTask.h"
+#include "common/Decompiler.h"
+#include "core/Iaito.h"
+
+DecompileAllTask::DecompileAllTask(Decompiler *decompiler, const DecompiledIndex::Ptr &index)
+    : AsyncTask()
+    , decompiler(decompiler)
+    , index(index)
+{}
+
+void DecompileAllTask::interrupt()
+{
+    AsyncTask::interrupt();
+#if R2_VERSION_NUMBER >= 50909
+    RCore *core = Core()->core_;
+    core->cons->context->breaked = true;
+#else
+    r_cons_singleton()->context->breaked = true;
+#endif
+}
+
+void DecompileAllTask::runTask()
+{
+    QList<RVA> pending;
+    const QList<FunctionDescription> functions = Core()->getAllFunctions();
+    for (const FunctionDescription &function : functions) {
+        if (!index->contains(function.offset)) {
+            pending << function.offset;
+        }
+    }
+    const int total = functions.size();
+    const int skipped = total - pending.size();
+    if (skipped > 0) {
+        log(tr("Resuming, %1 of %2 functions were already decompiled.").arg(skipped).arg(total));
+    }
+    log(tr("Decompiling %1 functions with %2 into %3")
+            .arg(pending.size())
+            .arg(decompiler->getName(), index->getPath()));
+
+    // Every decompiler runs r2 commands, which the core lock serializes
+    QElapsedTimer throughputTimer;
+    throughputTimer.start();
+    qint64 lastReport = 0;
+    int done = 0;
+    int failed = 0;
+    for (RVA addr : pending) {
+        if (isInterrupted()) {
+            log(tr("Interrupted, run it again to resume."));
+            break;
+        }
+        // Taken first: if the function changes while it is decompiled, the
+        // record does not match it anymore and is redone by the next run
+        const QByteArray fingerprint = index->functionFingerprint(addr);
+        RCodeMeta *code = decompiler->decompileSync(addr);
+        // Only a failure returns nothing, text output without annotations is
+        // kept too
+        if (!code || !index->append(addr, code, fingerprint)) {
+            failed++;
+        }
+        if (code) {
+            r_codemeta_free(code);
+        }
+        done++;
+
+        const qint64 elapsed = throughputTimer.elapsed();
+        if (elapsed - lastReport >= DECOMPILE_ALL_REPORT_MS || done == pending.size()) {
+            lastReport = elapsed;
+            const double rate = elapsed ? done * 1000.0 / elapsed : 0.0;
+            log(tr("%1 of %2 functions decompiled, %3 functions/s")
+                    .arg(skipped + done - failed)
+                    .arg(total)
+                    .arg(rate, 0, 'f', 1));
+            emit progress(skipped + done, total);
+        }
+    }
+    if (failed > 0) {
+        log(tr("%1 functions could not be decompiled.").arg(failed));
+    }
+}
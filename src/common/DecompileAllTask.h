@@ -0,0 +1,42 @@
+#ifndef DECOMPILEALLTASK_H
+#define DECOMPILEALLTASK_H
+
+#include "common/AsyncTask.h"
+#include "common/DecompiledIndex.h"
+
+class Decompiler;
+
+// interval between two throughput reports
+#define DECOMPILE_ALL_REPORT_MS 1000
+
+/**
+ * @brief Decompile every function with one decompiler and store the results
+ * in a DecompiledIndex.
+ *
+ * Functions already in the index are skipped, so running the task again on
+ * the same index resumes an interrupted run. Those changed since they were
+ * decompiled are decompiled again.
+ */
+class DecompileAllTask : public AsyncTask
+{
+    Q_OBJECT
+
+public:
+    DecompileAllTask(Decompiler *decompiler, const DecompiledIndex::Ptr &index);
+
+    QString getTitle() override { return tr("Decompiling All Functions"); }
+
+    void interrupt() override;
+
+signals:
+    void progress(int done, int total);
+
+protected:
+    void runTask() override;
+
+private:
+    Decompiler *decompiler;
+    DecompiledIndex::Ptr index;
+};
+
+#endif // DECOMPILEALLTASK_H
@@ -0,0 +1,386 @@
+#include "common/DecompiledIndex.h"
+#include "common/ResourcePaths.h"
+#include "common/TempConfig.h"
+#include "core/Iaito.h"
+
+#include <QCryptographicHash>
+#include <QDateTime>
+#include <QDebug>
+#include <QDir>
+#include <QFileInfo>
+
+#include <algorithm>
+#include <cstring>
+
+namespace {
+
+const char INDEX_MAGIC[8] = {'I', 'A', 'I', 'T', 'O', 'D', 'C', '3'};
+const quint32 RECORD_MAGIC = 0x44434552;
+
+struct FileHeader
+{
+    char magic[8];
+    char fingerprint[24]; //!< SHA-1, zero padded
+};
+
+struct RecordHeader
+{
+    quint32 magic;
+    quint32 recordSize; //!< including this header
+    quint64 functionAddr;
+    quint32 codeSize;
+    quint32 annotationCount;
+    char fingerprint[24]; //!< DecompiledIndex::functionFingerprint(), zero padded
+};
+
+struct AnnotationRecord
+{
+    quint32 type;
+    quint32 nameSize;
+    quint64 start;
+    quint64 end;
+    quint64 value; //!< offset, reference offset or syntax highlight type
+};
+
+qint64 padded(qint64 size)
+{
+    return (size + 7) & ~qint64(7);
+}
+
+const char *annotationName(const RCodeMetaItem *item)
+{
+    if (r_codemeta_item_is_reference(item)) {
+        return item->reference.name;
+    }
+    if (r_codemeta_item_is_variable(item)) {
+        return item->variable.name;
+    }
+    return nullptr;
+}
+
+} // namespace
+
+DecompiledIndex::DecompiledIndex(const QString &path)
+    : path(path)
+    , file(path)
+{}
+
+DecompiledIndex::~DecompiledIndex()
+{
+    QMutexLocker locker(&mutex);
+    unmap();
+}
+
+QString DecompiledIndex::defaultPath(const QString &decompilerId)
+{
+    const QString fileName = decompilerId + QStringLiteral(".decompiled");
+    const QString projectName = Core()->getConfig("prj.name");
+    if (!projectName.isEmpty()) {
+        char *projectsDir = r_file_abspath(Core()->getConfig("dir.projects").toUtf8().constData());
+        const QDir dir(QString::fromUtf8(projectsDir));
+        free(projectsDir);
+        return dir.filePath(projectName + QLatin1Char('/') + fileName);
+    }
+
+    // Without a project, key the file by the binary and its version
+    const QFileInfo binary(Core()->getConfig("file.path"));
+    const QByteArray key = binary.absoluteFilePath().toUtf8() + '\n'
+                           + QByteArray::number(binary.size()) + '\n'
+                           + QByteArray::number(binary.lastModified().toMSecsSinceEpoch());
+    const QString hash = QCryptographicHash::hash(key, QCryptographicHash::Sha1).toHex().left(16);
+    const QDir dir(Iaito::writableLocation(QStandardPaths::AppLocalDataLocation));
+    return dir.filePath(QStringLiteral("decompiled/") + hash + QLatin1Char('-') + fileName);
+}
+
+QByteArray DecompiledIndex::binaryFingerprint()
+{
+    QCryptographicHash hash(QCryptographicHash::Sha1);
+    const QFileInfo binary(Core()->getConfig("file.path"));
+    hash.addData(binary.absoluteFilePath().toUtf8());
+    hash.addData(QByteArray::number(binary.size()));
+    hash.addData(QByteArray::number(binary.lastModified().toMSecsSinceEpoch()));
+    return hash.result();
+}
+
+QByteArray DecompiledIndex::functionFingerprint(RVA functionAddr)
+{
+    const quint64 generation = Core()->getAnalysisGeneration();
+    {
+        QMutexLocker locker(&mutex);
+        if (fingerprintGeneration != generation) {
+            functionFingerprints.clear();
+            fingerprintGeneration = generation;
+        }
+        auto it = functionFingerprints.constFind(functionAddr);
+        if (it != functionFingerprints.constEnd()) {
+            return *it;
+        }
+    }
+
+    // Outside of the index mutex, which must never wait for the core lock
+    QString disassembly;
+    {
+        RCoreLocked core = Core()->core();
+        TempConfig tempConfig;
+        tempConfig.set("scr.color", COLOR_MODE_DISABLED)
+            .set("scr.utf8", false)
+            .set("asm.bytes", false)
+            .set("asm.lines", false);
+        disassembly = Core()->cmdRawAt("pdf", functionAddr);
+    }
+    const QByteArray fingerprint = QCryptographicHash::hash(
+        disassembly.toUtf8(), QCryptographicHash::Sha1);
+
+    QMutexLocker locker(&mutex);
+    if (fingerprintGeneration == generation) {
+        functionFingerprints.insert(functionAddr, fingerprint);
+    }
+    return fingerprint;
+}
+
+void DecompiledIndex::unmap()
+{
+    if (map) {
+        file.unmap(map);
+        map = nullptr;
+        mapSize = 0;
+    }
+}
+
+bool DecompiledIndex::remap()
+{
+    const qint64 size = file.size();
+    if (map && mapSize == size) {
+        return true;
+    }
+    unmap();
+    if (size > 0) {
+        map = file.map(0, size);
+        if (!map) {
+            return false;
+        }
+        mapSize = size;
+    }
+    return true;
+}
+
+bool DecompiledIndex::open(const QByteArray &fingerprint)
+{
+    QMutexLocker locker(&mutex);
+    if (file.isOpen()) {
+        return true;
+    }
+    this->fingerprint = fingerprint;
+    QFileInfo(path).dir().mkpath(QStringLiteral("."));
+    if (!file.open(QIODevice::ReadWrite)) {
+        qWarning() << "Cannot open the decompiled code index" << path << file.errorString();
+        return false;
+    }
+    return indexRecords();
+}
+
+bool DecompiledIndex::indexRecords()
+{
+    records.clear();
+    if (!remap()) {
+        return false;
+    }
+    FileHeader header = {};
+    memcpy(header.magic, INDEX_MAGIC, sizeof(INDEX_MAGIC));
+    memcpy(
+        header.fingerprint,
+        fingerprint.constData(),
+        std::min(size_t(fingerprint.size()), sizeof(header.fingerprint)));
+    if (mapSize < qint64(sizeof(header)) || memcmp(map, &header, sizeof(header))) {
+        // New file, or one from another version or binary: start over
+        unmap();
+        file.resize(0);
+        file.seek(0);
+        return file.write(reinterpret_cast<const char *>(&header), sizeof(header))
+                   == qint64(sizeof(header))
+               && file.flush();
+    }
+
+    qint64 pos = sizeof(header);
+    while (pos + qint64(sizeof(RecordHeader)) <= mapSize) {
+        RecordHeader header;
+        memcpy(&header, map + pos, sizeof(header));
+        if (header.magic != RECORD_MAGIC || header.recordSize < sizeof(header)
+            || pos + header.recordSize > mapSize) {
+            break;
+        }
+        records.insert(header.functionAddr, pos);
+        pos += header.recordSize;
+    }
+    if (pos < mapSize) {
+        // Drop the record being written when the previous run stopped
+        unmap();
+        return file.resize(pos) && remap();
+    }
+    return true;
+}
+
+bool DecompiledIndex::clear()
+{
+    QMutexLocker locker(&mutex);
+    if (!file.isOpen()) {
+        return false;
+    }
+    unmap();
+    file.resize(0);
+    return indexRecords();
+}
+
+qint64 DecompiledIndex::findRecord(RVA functionAddr, const QByteArray &fingerprint)
+{
+    auto it = records.constFind(functionAddr);
+    if (it == records.constEnd() || !remap() || *it + qint64(sizeof(RecordHeader)) > mapSize) {
+        return -1;
+    }
+    RecordHeader header;
+    memcpy(&header, map + *it, sizeof(header));
+    char expected[sizeof(header.fingerprint)] = {};
+    memcpy(
+        expected,
+        fingerprint.constData(),
+        std::min(size_t(fingerprint.size()), sizeof(expected)));
+    if (memcmp(header.fingerprint, expected, sizeof(expected))) {
+        // Decompiled before the function changed
+        return -1;
+    }
+    return *it;
+}
+
+bool DecompiledIndex::contains(RVA functionAddr)
+{
+    const QByteArray fingerprint = functionFingerprint(functionAddr);
+    QMutexLocker locker(&mutex);
+    return findRecord(functionAddr, fingerprint) >= 0;
+}
+
+int DecompiledIndex::count()
+{
+    QMutexLocker locker(&mutex);
+    return records.size();
+}
+
+RCodeMeta *DecompiledIndex::code(RVA functionAddr)
+{
+    const QByteArray fingerprint = functionFingerprint(functionAddr);
+    QMutexLocker locker(&mutex);
+    const qint64 pos = findRecord(functionAddr, fingerprint);
+    if (pos < 0) {
+        return nullptr;
+    }
+    const uchar *data = map + pos;
+    RecordHeader header;
+    memcpy(&header, data, sizeof(header));
+    // A corrupt record is a miss, never read past it
+    const qint64 minimumSize = qint64(sizeof(header)) + padded(header.codeSize)
+                               + qint64(header.annotationCount) * qint64(sizeof(AnnotationRecord));
+    if (header.magic != RECORD_MAGIC || minimumSize > header.recordSize
+        || pos + header.recordSize > mapSize) {
+        return nullptr;
+    }
+    const uchar *end = data + header.recordSize;
+    data += sizeof(header);
+
+    const QByteArray text(reinterpret_cast<const char *>(data), int(header.codeSize));
+    data += padded(header.codeSize);
+    RCodeMeta *code = r_codemeta_new(text.constData());
+    for (quint32 i = 0; i < header.annotationCount; i++) {
+        AnnotationRecord annotation;
+        if (qint64(sizeof(annotation)) > end - data) {
+            r_codemeta_free(code);
+            return nullptr;
+        }
+        memcpy(&annotation, data, sizeof(annotation));
+        data += sizeof(annotation);
+        if (padded(annotation.nameSize) > end - data) {
+            r_codemeta_free(code);
+            return nullptr;
+        }
+
+        RCodeMetaItem *mi = r_codemeta_item_new();
+        mi->type = static_cast<RCodeMetaItemType>(annotation.type);
+        mi->start = annotation.start;
+        mi->end = annotation.end;
+        const char *nameData = reinterpret_cast<const char *>(data);
+        char *name = annotation.nameSize ? r_str_ndup(nameData, int(annotation.nameSize)) : nullptr;
+        data += padded(annotation.nameSize);
+        if (mi->type == R_CODEMETA_TYPE_OFFSET) {
+            mi->offset.offset = annotation.value;
+        } else if (mi->type == R_CODEMETA_TYPE_SYNTAX_HIGHLIGHT) {
+            mi->syntax_highlight.type = static_cast<RSyntaxHighlightType>(annotation.value);
+        } else if (r_codemeta_item_is_reference(mi)) {
+            mi->reference.name = name;
+            mi->reference.offset = annotation.value;
+            name = nullptr;
+        } else if (r_codemeta_item_is_variable(mi)) {
+            mi->variable.name = name;
+            name = nullptr;
+        }
+        free(name);
+        r_codemeta_add_item(code, mi);
+    }
+    return code;
+}
+
+bool DecompiledIndex::append(
+    RVA functionAddr, const RCodeMeta *code, const QByteArray &fingerprint)
+{
+    const char *codeText = code->code ? code->code : "";
+    RecordHeader header = {};
+    header.magic = RECORD_MAGIC;
+    header.functionAddr = functionAddr;
+    header.codeSize = quint32(strlen(codeText));
+    header.annotationCount = 0;
+    memcpy(
+        header.fingerprint,
+        fingerprint.constData(),
+        std::min(size_t(fingerprint.size()), sizeof(header.fingerprint)));
+
+    QByteArray annotations;
+    void *iter;
+    r_vector_foreach(&code->annotations, iter)
+    {
+        const RCodeMetaItem *item = (const RCodeMetaItem *) iter;
+        const char *name = annotationName(item);
+        AnnotationRecord annotation;
+        annotation.type = quint32(item->type);
+        annotation.nameSize = name ? quint32(strlen(name)) : 0;
+        annotation.start = item->start;
+        annotation.end = item->end;
+        annotation.value = 0;
+        if (item->type == R_CODEMETA_TYPE_OFFSET) {
+            annotation.value = item->offset.offset;
+        } else if (item->type == R_CODEMETA_TYPE_SYNTAX_HIGHLIGHT) {
+            annotation.value = quint64(item->syntax_highlight.type);
+        } else if (r_codemeta_item_is_reference(item)) {
+            annotation.value = item->reference.offset;
+        }
+        annotations.append(reinterpret_cast<const char *>(&annotation), sizeof(annotation));
+        annotations.append(name, int(annotation.nameSize));
+        annotations.append(int(padded(annotation.nameSize) - annotation.nameSize), '\0');
+        header.annotationCount++;
+    }
+
+    QByteArray record;
+    header.recordSize = quint32(sizeof(header) + padded(header.codeSize) + annotations.size());
+    record.reserve(int(header.recordSize));
+    record.append(reinterpret_cast<const char *>(&header), sizeof(header));
+    record.append(codeText, int(header.codeSize));
+    record.append(int(padded(header.codeSize) - header.codeSize), '\0');
+    record.append(annotations);
+
+    QMutexLocker locker(&mutex);
+    if (!file.isOpen()) {
+        return false;
+    }
+    const qint64 pos = file.size();
+    if (!file.seek(pos) || file.write(record) != record.size() || !file.flush()) {
+        return false;
+    }
+    records.insert(functionAddr, pos);
+    return true;
+}
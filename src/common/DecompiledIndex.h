@@ -0,0 +1,109 @@
+#ifndef DECOMPILEDINDEX_H
+#define DECOMPILEDINDEX_H
+
+#include "core/IaitoCommon.h"
+
+#include <QFile>
+#include <QHash>
+#include <QList>
+#include <QMutex>
+#include <QSharedPointer>
+
+/**
+ * @brief Decompiled code of many functions, stored in a file that is mapped
+ * in memory.
+ *
+ * The file starts with a header followed by one record per function, each
+ * holding the code and all its annotations. Records are only appended, so an
+ * interrupted DecompileAllTask resumes by skipping the functions already
+ * there. A record cut short by a crash is dropped when the file is opened.
+ *
+ * The file is keyed by the binary and the decompiler. Its header holds a
+ * fingerprint of the binary (see binaryFingerprint()), a file written for
+ * another one is emptied when opened. Each record holds the fingerprint of
+ * its function when it was decompiled (see functionFingerprint()), a record
+ * that no longer matches is a miss and is replaced by the next append.
+ *
+ * Thread safe.
+ */
+class IAITO_EXPORT DecompiledIndex
+{
+public:
+    using Ptr = QSharedPointer<DecompiledIndex>;
+
+    explicit DecompiledIndex(const QString &path);
+    ~DecompiledIndex();
+
+    /**
+     * @brief Path of the index of \a decompilerId for the opened binary: in
+     * the project directory if a project is open, else in the local data
+     * location
+     */
+    static QString defaultPath(const QString &decompilerId);
+
+    /**
+     * @brief Hash of the path, size and modification time of the opened
+     * binary
+     */
+    static QByteArray binaryFingerprint();
+
+    /**
+     * @brief Hash of the function at \a functionAddr as the decompilers see
+     * it: its disassembly, with the bytes, names, variables, comments and
+     * types it refers to. Cached until the analysis generation changes.
+     */
+    QByteArray functionFingerprint(RVA functionAddr);
+
+    const QString &getPath() const { return path; }
+
+    /**
+     * @brief Open or create the file and index its records, dropping them if
+     * they were written for another \a fingerprint
+     */
+    bool open(const QByteArray &fingerprint);
+    /**
+     * @brief Remove every record
+     */
+    bool clear();
+
+    /**
+     * @return whether the record of the function at \a functionAddr matches
+     * its current functionFingerprint()
+     */
+    bool contains(RVA functionAddr);
+    /**
+     * @return the number of records, stale ones included
+     */
+    int count();
+    /**
+     * @return a new RCodeMeta owned by the caller, or nullptr if there is no
+     * record matching the current functionFingerprint()
+     */
+    RCodeMeta *code(RVA functionAddr);
+    /**
+     * @brief Append the record of \a code decompiled for the function at
+     * \a functionAddr, replacing any previous one for lookups
+     * @param fingerprint functionFingerprint() taken before decompiling
+     */
+    bool append(RVA functionAddr, const RCodeMeta *code, const QByteArray &fingerprint);
+
+private:
+    const QString path;
+    QMutex mutex;
+    QFile file;
+    uchar *map = nullptr;
+    qint64 mapSize = 0;
+    QByteArray fingerprint;
+    QHash<RVA, qint64> records;
+    QHash<RVA, QByteArray> functionFingerprints;
+    quint64 fingerprintGeneration = 0;
+
+    /** must be called with the mutex held */
+    bool remap();
+    void unmap();
+    bool indexRecords();
+    /** offset of the record of \a functionAddr matching \a fingerprint, or -1 */
+    qint64 findRecord(RVA functionAddr, const QByteArray &fingerprint);
+};
+
+#endif // DECOMPILEDINDEX_H
@@ -1,14 +1,15 @@
 
 #include "Decompiler.h"
+#include "CodeMetaBuilder.h"
 #include "Iaito.h"
 
-#include <QJsonArray>
-#include <QJsonObject>
+#include <QFileInfo>
 
 Decompiler::Decompiler(const QString &id, const QString &name, QObject *parent)
     : QObject(parent)
     , id(id)
     , name(name)
+    , codeCache(DECOMPILER_CACHE_FUNCTIONS)
 {}
 
 RCodeMeta *Decompiler::makeWarning(QString warningMessage)
@@ -17,63 +18,112 @@ RCodeMeta *Decompiler::makeWarning(QString warningMessage)
     return r_codemeta_new(temporary.c_str());
 }
 
-R2DecDecompiler::R2DecDecompiler(QObject *parent)
-    : Decompiler("r2dec", "r2dec", parent)
+RCodeMeta *Decompiler::cloneCode(const RCodeMeta *code)
 {
-    task = nullptr;
+    RCodeMeta *clone = r_codemeta_new(code->code ? code->code : "");
+    void *iter;
+    r_vector_foreach(&code->annotations, iter)
+    {
+        const RCodeMetaItem *item = (const RCodeMetaItem *) iter;
+        RCodeMetaItem *mi = r_codemeta_item_new();
+        *mi = *item;
+        if (r_codemeta_item_is_reference(mi)) {
+            mi->reference.name = item->reference.name ? strdup(item->reference.name) : nullptr;
+        } else if (r_codemeta_item_is_variable(mi)) {
+            mi->variable.name = item->variable.name ? strdup(item->variable.name) : nullptr;
+        }
+        r_codemeta_add_item(clone, mi);
+    }
+    return clone;
 }
 
-bool R2DecDecompiler::isAvailable()
+void Decompiler::syncCache()
 {
-    return Core()->cmdList("e cmd.pdc=?").contains(QStringLiteral("pdd"));
+    const quint64 generation = Core()->getAnalysisGeneration();
+    if (generation != cacheGeneration) {
+        codeCache.clear();
+        cacheGeneration = generation;
+    }
 }
 
-RCodeMeta *R2DecDecompiler::decompileSync(RVA addr)
+RCodeMeta *Decompiler::cachedCode(RVA functionAddr)
 {
-    // auto document = Core()->cmdj("pddj @ " + QString::number(addr));
-    auto document = Core()->cmdjAt("pddj", addr);
-    QJsonObject json = document.object();
-    if (json.isEmpty()) {
-        //    emit finished(Decompiler::makeWarning(tr("Failed to parse JSON
-        //    from pdc")));
-        return NULL;
+    syncCache();
+    CachedCode *cached = codeCache.object(functionAddr);
+    if (cached) {
+        return cloneCode(cached->code);
     }
-    // note that r2dec doesnt have the "text" object like pdc does. so we cant
-    // reuse code
-    RCodeMeta *code = r_codemeta_new("");
-    QString codeString = "";
-    for (const auto line : json["log"].toArray()) {
-        if (!line.isString()) {
-            continue;
-        }
-        codeString.append(line.toString() + "\n");
+    DecompiledIndex::Ptr diskIndex = getIndex();
+    if (!diskIndex) {
+        return nullptr;
+    }
+    RCodeMeta *code = diskIndex->code(functionAddr);
+    if (code) {
+        codeCache.insert(functionAddr, new CachedCode(cloneCode(code)));
     }
+    return code;
+}
 
-    QJsonArray linesArray = json["lines"].toArray();
-    for (const QJsonValueRef line : linesArray) {
-        QJsonObject lineObject = line.toObject();
-        if (lineObject.isEmpty()) {
-            continue;
-        }
-        RCodeMetaItem *mi = r_codemeta_item_new();
-        mi->start = codeString.length();
-        codeString.append(lineObject["str"].toString() + "\n");
-        mi->end = codeString.length();
-        bool ok;
-        mi->type = R_CODEMETA_TYPE_OFFSET;
-        mi->offset.offset = lineObject["offset"].toVariant().toULongLong(&ok);
-        r_codemeta_add_item(code, mi);
+bool Decompiler::isCached(RVA functionAddr)
+{
+    syncCache();
+    if (codeCache.contains(functionAddr)) {
+        return true;
     }
+    DecompiledIndex::Ptr diskIndex = getIndex();
+    return diskIndex && diskIndex->contains(functionAddr);
+}
 
-    for (const auto line : json["errors"].toArray()) {
-        if (!line.isString()) {
-            continue;
-        }
-        codeString.append(line.toString() + "\n");
+void Decompiler::cacheCode(RVA functionAddr, const RCodeMeta *code, quint64 generation)
+{
+    syncCache();
+    // keep warnings out so a failure is retried, text without annotations is
+    // a valid result
+    if (generation != cacheGeneration || !code || code == pendingWarning) {
+        return;
     }
-    std::string tmp = codeString.toStdString();
-    code->code = strdup(tmp.c_str());
-    return code;
+    codeCache.insert(functionAddr, new CachedCode(cloneCode(code)));
+}
+
+void Decompiler::finishWithWarning(const QString &warningMessage)
+{
+    RCodeMeta *warning = makeWarning(warningMessage);
+    pendingWarning = warning;
+    emit finished(warning);
+    pendingWarning = nullptr;
+}
+
+DecompiledIndex::Ptr Decompiler::getIndex(bool create)
+{
+    const QString path = DecompiledIndex::defaultPath(getId());
+    if (index && index->getPath() == path) {
+        return index;
+    }
+    index.reset();
+    if (!create && !QFileInfo::exists(path)) {
+        return index;
+    }
+    DecompiledIndex::Ptr opened(new DecompiledIndex(path));
+    if (opened->open(DecompiledIndex::binaryFingerprint())) {
+        index = opened;
+    }
+    return index;
+}
+
+R2DecDecompiler::R2DecDecompiler(QObject *parent)
+    : Decompiler("r2dec", "r2dec", parent)
+{
+    task = nullptr;
+}
+
+bool R2DecDecompiler::isAvailable()
+{
+    return Core()->cmdList("e cmd.pdc=?").contains(QStringLiteral("pdd"));
+}
+
+RCodeMeta *R2DecDecompiler::decompileSync(RVA addr)
+{
+    return CodeMetaBuilder::fromR2DecJson(Core()->cmdStr("pddj @ " + QString::number(addr)));
 }
 
 void R2DecDecompiler::decompileAt(RVA addr)
@@ -84,46 +134,13 @@ void R2DecDecompiler::decompileAt(RVA addr)
 
     task = new R2Task("pddj @ " + QString::number(addr));
     connect(task, &R2Task::finished, this, [this]() {
-        QJsonObject json = task->getResultJson().object();
+        RCodeMeta *code = CodeMetaBuilder::fromR2DecJson(task->takeResultRaw());
         delete task;
         task = nullptr;
-        if (json.isEmpty()) {
-            emit finished(Decompiler::makeWarning(tr("Failed to parse JSON from r2dec")));
+        if (!code) {
+            finishWithWarning(tr("Failed to parse JSON from r2dec"));
             return;
         }
-        RCodeMeta *code = r_codemeta_new("");
-        QString codeString = "";
-        for (const auto line : json["log"].toArray()) {
-            if (!line.isString()) {
-                continue;
-            }
-            codeString.append(line.toString() + "\n");
-        }
-
-        QJsonArray linesArray = json["lines"].toArray();
-        for (const QJsonValueRef line : linesArray) {
-            QJsonObject lineObject = line.toObject();
-            if (lineObject.isEmpty()) {
-                continue;
-            }
-            RCodeMetaItem *mi = r_codemeta_item_new();
-            mi->start = codeString.length();
-            codeString.append(lineObject["str"].toString() + "\n");
-            mi->end = codeString.length();
-            bool ok;
-            mi->type = R_CODEMETA_TYPE_OFFSET;
-            mi->offset.offset = lineObject["offset"].toVariant().toULongLong(&ok);
-            r_codemeta_add_item(code, mi);
-        }
-
-        for (const auto line : json["errors"].toArray()) {
-            if (!line.isString()) {
-                continue;
-            }
-            codeString.append(line.toString() + "\n");
-        }
-        std::string tmp = codeString.toStdString();
-        code->code = strdup(tmp.c_str());
         emit finished(code);
     });
     task->startTask();
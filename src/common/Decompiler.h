@@ -1,12 +1,17 @@
 #ifndef DECOMPILER_H
 #define DECOMPILER_H
 
+#include "DecompiledIndex.h"
 #include "IaitoCommon.h"
 #include "R2Task.h"
 
+#include <QCache>
 #include <QObject>
 #include <QString>
 
+// Number of decompiled functions each decompiler keeps for instant redisplay
+#define DECOMPILER_CACHE_FUNCTIONS 64
+
 /**
  * Implements a decompiler that can be registered using
  * IaitoCore::registerDecompiler()
@@ -19,11 +24,61 @@ private:
     const QString id;
     const QString name;
 
+    struct CachedCode
+    {
+        explicit CachedCode(RCodeMeta *code)
+            : code(code)
+        {}
+        ~CachedCode() { r_codemeta_free(code); }
+        Q_DISABLE_COPY(CachedCode)
+
+        RCodeMeta *code;
+    };
+    QCache<RVA, CachedCode> codeCache;
+    quint64 cacheGeneration = 0;
+    DecompiledIndex::Ptr index;
+    /** warning being emitted by finishWithWarning() */
+    const RCodeMeta *pendingWarning = nullptr;
+
+    void syncCache();
+
 public:
     Decompiler(const QString &id, const QString &name, QObject *parent = nullptr);
     virtual ~Decompiler() = default;
 
     static RCodeMeta *makeWarning(QString warningMessage);
+    /**
+     * @brief Deep copy of \a code, including the names of its annotations
+     */
+    static RCodeMeta *cloneCode(const RCodeMeta *code);
+
+    /**
+     * @brief Copy of the code decompiled for the function at \a functionAddr,
+     * if the analysis did not change since. Falls back to the index filled by
+     * DecompileAllTask if its record still matches the function.
+     * @return a new RCodeMeta owned by the caller or nullptr
+     */
+    RCodeMeta *cachedCode(RVA functionAddr);
+    bool isCached(RVA functionAddr);
+    /**
+     * @brief Keep a copy of \a code decompiled for the function at
+     * \a functionAddr
+     * @param generation IaitoCore::getAnalysisGeneration() when the
+     * decompilation started, a result computed from an older analysis is
+     * dropped
+     */
+    void cacheCode(RVA functionAddr, const RCodeMeta *code, quint64 generation);
+    /**
+     * @brief On-disk index of this decompiler's code for the opened binary
+     *
+     * An index left by a previous session is only kept if it was written for
+     * the same binary. Records of functions changed since are ignored, see
+     * DecompiledIndex::functionFingerprint().
+     *
+     * @param create create the file if it does not exist yet
+     * @return nullptr if the index does not exist or cannot be opened
+     */
+    DecompiledIndex::Ptr getIndex(bool create = false);
 
     QString getId() const { return id; }
     QString getName() const { return name; }
@@ -36,6 +91,13 @@ public:
 
 signals:
     void finished(RCodeMeta *codeDecompiled);
+
+protected:
+    /**
+     * @brief Emit finished() with a warning, which cacheCode() ignores so
+     * that the function is decompiled again next time
+     */
+    void finishWithWarning(const QString &warningMessage);
 };
 
 class R2DecDecompiler : public Decompiler
@@ -1,5 +1,6 @@
 
 #include "DecompilerHighlighter.h"
+#include "common/CodeAnnotationIndex.h"
 #include "common/Configuration.h"
 
 DecompilerHighlighter::DecompilerHighlighter(QTextDocument *parent)
@@ -12,9 +13,9 @@ DecompilerHighlighter::DecompilerHighlighter(QTextDocument *parent)
     });
 }
 
-void DecompilerHighlighter::setAnnotations(RCodeMeta *code)
+void DecompilerHighlighter::setAnnotationIndex(const CodeAnnotationIndex *index)
 {
-    this->code = code;
+    this->index = index;
 }
 
 void DecompilerHighlighter::setupTheme()
@@ -41,28 +42,17 @@ void DecompilerHighlighter::setupTheme()
 
 void DecompilerHighlighter::highlightBlock(const QString &)
 {
-    if (!code) {
+    if (!index) {
         return;
     }
     auto block = currentBlock();
     size_t start = block.position();
     size_t end = block.position() + block.length();
 
-    auto cm = r_codemeta_in(code, start, end);
-    if (cm == nullptr) {
-        return;
-    }
-    std::unique_ptr<RPVector, decltype(&r_pvector_free)> annotations(cm, &r_pvector_free);
-    void **iter;
-    r_pvector_foreach(annotations.get(), iter)
-    {
-        RCodeMetaItem *annotation = static_cast<RCodeMetaItem *>(*iter);
-        if (annotation->type != R_CODEMETA_TYPE_SYNTAX_HIGHLIGHT) {
-            continue;
-        }
+    index->syntaxHighlightsIn(start, end, [this, start](const RCodeMetaItem *annotation) {
         auto type = annotation->syntax_highlight.type;
         if (size_t(type) >= HIGHLIGHT_COUNT) {
-            continue;
+            return;
         }
         auto annotationStart = annotation->start;
         if (annotationStart < start) {
@@ -73,5 +63,5 @@ void DecompilerHighlighter::highlightBlock(const QString &)
         auto annotationEnd = annotation->end - start;
 
         setFormat(annotationStart, annotationEnd - annotationStart, format[type]);
-    }
+    });
 }
@@ -7,6 +7,8 @@
 #include <QTextCharFormat>
 #include <QTextDocument>
 
+class CodeAnnotationIndex;
+
 /**
  * \brief SyntaxHighlighter based on annotations from decompiled code.
  * Can be only used in combination with DecompilerWidget.
@@ -20,14 +22,14 @@ public:
     virtual ~DecompilerHighlighter() = default;
 
     /**
-     * @brief Set the code with annotations to be used for highlighting.
+     * @brief Set the index of the annotations to be used for highlighting.
      *
      * It is callers responsibility to ensure that it is synchronized with
      * currentTextDocument and has sufficiently long lifetime.
      *
-     * @param code
+     * @param index
      */
-    void setAnnotations(RCodeMeta *code);
+    void setAnnotationIndex(const CodeAnnotationIndex *index);
 
 protected:
     void highlightBlock(const QString &text) override;
@@ -37,7 +39,7 @@ private:
 
     static const int HIGHLIGHT_COUNT = R_SYNTAX_HIGHLIGHT_TYPE_GLOBAL_VARIABLE + 1;
     std::array<QTextCharFormat, HIGHLIGHT_COUNT> format;
-    RCodeMeta *code = nullptr;
+    const CodeAnnotationIndex *index = nullptr;
 };
 
 #endif
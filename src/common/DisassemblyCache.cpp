@@ -0,0 +1,80 @@
+#include "common/DisassemblyCache.h"
+
+DisassemblyCache::DisassemblyCache(int capacity)
+    : capacity(capacity)
+    , instructions(capacity)
+    , singleInstructions(capacity)
+{}
+
+void DisassemblyCache::sync(quint64 ioGeneration)
+{
+    if (ioGeneration != this->ioGeneration) {
+        clear();
+        this->ioGeneration = ioGeneration;
+    }
+}
+
+void DisassemblyCache::clear()
+{
+    instructions.clear();
+    singleInstructions.clear();
+    nextAddr.clear();
+    prevAddr.clear();
+}
+
+bool DisassemblyCache::lines(RVA addr, uint profile, Instruction *out)
+{
+    Instruction *instruction = instructions.object(Key(addr, profile));
+    if (!instruction) {
+        return false;
+    }
+    *out = *instruction;
+    return true;
+}
+
+void DisassemblyCache::insertLines(RVA addr, uint profile, const Instruction &instruction)
+{
+    instructions.insert(Key(addr, profile), new Instruction(instruction));
+    insertBoundary(addr, instruction.next);
+}
+
+bool DisassemblyCache::singleInstruction(RVA addr, uint profile, QString *out)
+{
+    QString *text = singleInstructions.object(Key(addr, profile));
+    if (!text) {
+        return false;
+    }
+    *out = *text;
+    return true;
+}
+
+void DisassemblyCache::insertSingleInstruction(RVA addr, uint profile, const QString &text)
+{
+    singleInstructions.insert(Key(addr, profile), new QString(text));
+}
+
+RVA DisassemblyCache::next(RVA addr) const
+{
+    return nextAddr.value(addr, RVA_INVALID);
+}
+
+RVA DisassemblyCache::prev(RVA addr) const
+{
+    return prevAddr.value(addr, RVA_INVALID);
+}
+
+void DisassemblyCache::insertBoundary(RVA addr, RVA next, bool fromBlock)
+{
+    if (next <= addr || next == RVA_INVALID) {
+        return;
+    }
+    // the boundaries are tiny, keep them bounded without an LRU
+    if (nextAddr.size() >= capacity * 8) {
+        nextAddr.clear();
+        prevAddr.clear();
+    }
+    nextAddr.insert(addr, next);
+    if (fromBlock || !prevAddr.contains(next)) {
+        prevAddr.insert(next, addr);
+    }
+}
@@ -0,0 +1,91 @@
+#ifndef DISASSEMBLYCACHE_H
+#define DISASSEMBLYCACHE_H
+
+#include "core/IaitoCommon.h"
+#include "core/IaitoDescriptions.h"
+
+#include <QCache>
+#include <QHash>
+#include <QPair>
+
+// number of instructions kept per kind of cached data
+#define DISASSEMBLY_CACHE_ENTRIES 8192
+
+/**
+ * @brief Cache of disassembled instructions shared by the disassembly,
+ * graph, xrefs and tooltip previews.
+ *
+ * Text is keyed by instruction address and by a profile, a hash of the asm.*
+ * and scr.* configuration and of the hints at the address it was produced
+ * with, so views disassembling with different temporary options don't clash.
+ * Instruction boundaries don't depend on the profile and are shared by all
+ * views.
+ *
+ * Everything is dropped when the IO generation changes or when clear() is
+ * called because of an analysis or asm options change or a console command.
+ * The cache itself is not thread safe, IaitoCore only uses it with the core
+ * lock held.
+ */
+class IAITO_EXPORT DisassemblyCache
+{
+public:
+    struct Instruction
+    {
+        /**
+         * address of the following instruction
+         */
+        RVA next;
+        /**
+         * all the disassembly lines printed for this address (flags,
+         * comments, the instruction itself)
+         */
+        QList<DisassemblyLine> lines;
+    };
+
+    explicit DisassemblyCache(int capacity = DISASSEMBLY_CACHE_ENTRIES);
+
+    /**
+     * @brief Drops everything if \a ioGeneration differs from the one the
+     * cached data was read at.
+     */
+    void sync(quint64 ioGeneration);
+    void clear();
+
+    bool lines(RVA addr, uint profile, Instruction *out);
+    void insertLines(RVA addr, uint profile, const Instruction &instruction);
+
+    bool singleInstruction(RVA addr, uint profile, QString *out);
+    void insertSingleInstruction(RVA addr, uint profile, const QString &text);
+
+    /**
+     * @return the address of the instruction after \a addr or RVA_INVALID
+     */
+    RVA next(RVA addr) const;
+    /**
+     * @return the address of the instruction before \a addr or RVA_INVALID
+     */
+    RVA prev(RVA addr) const;
+    /**
+     * @brief Record that the instruction at \a addr ends at \a next
+     *
+     * A linear sweep started in the middle of an instruction may decode
+     * another instruction ending at the same address, so a known previous
+     * instruction is only replaced by one decoded from a function or basic
+     * block start.
+     * @param fromBlock whether \a addr was reached from a function or basic
+     * block start
+     */
+    void insertBoundary(RVA addr, RVA next, bool fromBlock = false);
+
+private:
+    using Key = QPair<RVA, uint>;
+
+    int capacity;
+    quint64 ioGeneration = 0;
+    QCache<Key, Instruction> instructions;
+    QCache<Key, QString> singleInstructions;
+    QHash<RVA, RVA> nextAddr;
+    QHash<RVA, RVA> prevAddr;
+};
+
+#endif // DISASSEMBLYCACHE_H
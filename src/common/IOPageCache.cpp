@@ -0,0 +1,120 @@
+#include "common/IOPageCache.h"
+
+IOPageCache::IOPageCache(int capacity)
+    : pages(capacity)
+    , generation(Core()->getIOGeneration())
+{}
+
+IOPageCache::~IOPageCache()
+{
+    if (prefetchTask) {
+        prefetchTask->interrupt();
+    }
+}
+
+void IOPageCache::syncGeneration()
+{
+    quint64 current = Core()->getIOGeneration();
+    if (current != generation) {
+        pages.clear();
+        generation = current;
+    }
+}
+
+QByteArray IOPageCache::page(uint64_t addr)
+{
+    {
+        QMutexLocker locker(&mutex);
+        syncGeneration();
+        if (QByteArray *cached = pages.object(addr)) {
+            return *cached;
+        }
+    }
+    // read outside of our lock, prefetch tasks may be waiting for the core
+    quint64 readGeneration = Core()->getIOGeneration();
+    QByteArray data = Core()->ioRead(addr, PAGE_SIZE);
+    insert(addr, data, readGeneration);
+    return data;
+}
+
+bool IOPageCache::contains(uint64_t addr)
+{
+    QMutexLocker locker(&mutex);
+    syncGeneration();
+    return pages.contains(addr);
+}
+
+void IOPageCache::insert(uint64_t addr, const QByteArray &data, quint64 generation)
+{
+    QMutexLocker locker(&mutex);
+    syncGeneration();
+    if (generation != this->generation || data.size() != static_cast<int>(PAGE_SIZE)) {
+        return;
+    }
+    pages.insert(addr, new QByteArray(data));
+}
+
+void IOPageCache::clear()
+{
+    QMutexLocker locker(&mutex);
+    pages.clear();
+}
+
+void IOPageCache::prefetch(const Ptr &cache, uint64_t addr, int count)
+{
+    if (!Core()->isThreadedMode()) {
+        return;
+    }
+    // ptrace based IO must be driven from the thread that attached
+    if (Core()->currentlyDebugging && !Core()->currentlyEmulating) {
+        return;
+    }
+    count = qMin(count, cache->pages.maxCost() / 2);
+    if (count <= 0) {
+        return;
+    }
+    if (cache->prefetchTask) {
+        cache->prefetchTask->interrupt();
+    }
+    cache->prefetchTask = AsyncTask::Ptr(new IOPrefetchTask(cache, addr, count));
+    // not listed with the tasks, the user did not start it
+    Core()->getAsyncTaskManager()->startInternal(cache->prefetchTask);
+}
+
+void IOPageCache::readAhead(const Ptr &cache, uint64_t first, uint64_t last)
+{
+    uint64_t previous = cache->lastWindow;
+    cache->lastWindow = first;
+    uint64_t count = (last - first) / PAGE_SIZE + 1;
+    if (first > previous && last < UINT64_MAX) {
+        prefetch(cache, last + 1, static_cast<int>(count));
+    } else if (first < previous && first > 0) {
+        count = qMin(count, first / PAGE_SIZE);
+        prefetch(cache, first - count * PAGE_SIZE, static_cast<int>(count));
+    }
+}
+
+IOPrefetchTask::IOPrefetchTask(const IOPageCache::Ptr &cache, uint64_t addr, int count)
+    : cache(cache)
+    , addr(addr)
+    , count(count)
+{}
+
+void IOPrefetchTask::runTask()
+{
+    uint64_t pageAddr = addr;
+    for (int i = 0; i < count && !isInterrupted(); i++, pageAddr += IOPageCache::PAGE_SIZE) {
+        IOPageCache::Ptr pageCache = cache.toStrongRef();
+        if (!pageCache) {
+            return;
+        }
+        if (!pageCache->contains(pageAddr)) {
+            quint64 generation = Core()->getIOGeneration();
+            QByteArray data = Core()->ioRead(pageAddr, IOPageCache::PAGE_SIZE);
+            pageCache->insert(pageAddr, data, generation);
+        }
+        if (pageAddr > UINT64_MAX - IOPageCache::PAGE_SIZE) {
+            break;
+        }
+    }
+}
@@ -0,0 +1,96 @@
+#ifndef IOPAGECACHE_H
+#define IOPAGECACHE_H
+
+#include "common/AsyncTask.h"
+#include "core/Iaito.h"
+
+#include <QCache>
+#include <QMutex>
+#include <QSharedPointer>
+#include <QWeakPointer>
+
+// number of pages kept by default, 1 MiB with 4 KiB pages
+#define IO_PAGE_CACHE_PAGES 256
+
+/**
+ * @brief Bounded LRU cache of fixed size pages read through r_io.
+ *
+ * Pages are keyed by their aligned address and tagged with the
+ * IaitoCore::getIOGeneration() value they were read at. Whenever the core
+ * generation moves (writes, io.cache or write mode changes, debugger stops,
+ * rebases) every cached page is dropped on the next access.
+ *
+ * The returned QByteArrays are implicitly shared, so callers can keep them
+ * after the cache evicted or invalidated the page.
+ *
+ * The cache is thread safe; in threaded mode pages can be prefetched in the
+ * background with prefetch().
+ */
+class IAITO_EXPORT IOPageCache
+{
+public:
+    using Ptr = QSharedPointer<IOPageCache>;
+
+    static constexpr uint64_t PAGE_SIZE = 0x1000ULL;
+
+    explicit IOPageCache(int capacity = IO_PAGE_CACHE_PAGES);
+    ~IOPageCache();
+
+    /**
+     * @brief Returns the page starting at the aligned address \a addr,
+     * reading it with Core()->ioRead() if it is not cached.
+     */
+    QByteArray page(uint64_t addr);
+
+    bool contains(uint64_t addr);
+
+    /**
+     * @brief Stores a page read at \a generation. The page is discarded if
+     * the IO generation moved in the meantime.
+     */
+    void insert(uint64_t addr, const QByteArray &data, quint64 generation);
+
+    void clear();
+
+    /**
+     * @brief Reads up to \a count pages starting at the aligned address
+     * \a addr in the background, if they are not already cached. A pending
+     * prefetch is interrupted by the next one. Does nothing in monothread
+     * mode.
+     */
+    static void prefetch(const Ptr &cache, uint64_t addr, int count);
+
+    /**
+     * @brief Prefetches one window worth of pages past [\a first, \a last]
+     * in the direction the window moved since the previous call.
+     */
+    static void readAhead(const Ptr &cache, uint64_t first, uint64_t last);
+
+private:
+    /** must be called with the mutex held */
+    void syncGeneration();
+
+    QMutex mutex;
+    QCache<uint64_t, QByteArray> pages;
+    quint64 generation;
+    uint64_t lastWindow = 0;
+    AsyncTask::Ptr prefetchTask;
+};
+
+class IOPrefetchTask : public AsyncTask
+{
+    Q_OBJECT
+
+public:
+    IOPrefetchTask(const IOPageCache::Ptr &cache, uint64_t addr, int count);
+
+protected:
+    void runTask() override;
+
+private:
+    QWeakPointer<IOPageCache> cache;
+    uint64_t addr;
+    int count;
+};
+
+#endif // IOPAGECACHE_H
@@ -1,10 +1,8 @@
 
 #include "R2DecaiDecompiler.h"
+#include "CodeMetaBuilder.h"
 #include "Iaito.h"
 
-#include <QJsonArray>
-#include <QJsonObject>
-
 R2DecaiDecompiler::R2DecaiDecompiler(QObject *parent)
     : Decompiler("decai", "decai", parent)
 {
@@ -18,11 +16,8 @@ bool R2DecaiDecompiler::isAvailable()
 
 RCodeMeta *R2DecaiDecompiler::decompileSync(RVA addr)
 {
-    auto document = Core()->cmd("decai -d @ " + QString::number(addr));
-    RCodeMeta *code = r_codemeta_new("");
     // TODO: decai have no json output or source-line information
-    code->code = strdup(document.toStdString().c_str());
-    return code;
+    return CodeMetaBuilder::fromText(Core()->cmdStr("decai -d @ " + QString::number(addr)));
 }
 
 void R2DecaiDecompiler::decompileAt(RVA addr)
@@ -32,11 +27,9 @@ void R2DecaiDecompiler::decompileAt(RVA addr)
     }
     task = new R2Task("decai -d @ " + QString::number(addr));
     connect(task, &R2Task::finished, this, [this]() {
-        QString text = task->getResult();
+        RCodeMeta *code = CodeMetaBuilder::fromText(task->takeResultRaw());
         delete task;
         task = nullptr;
-        RCodeMeta *code = r_codemeta_new("");
-        code->code = strdup(text.toStdString().c_str());
         emit finished(code);
     });
     task->startTask();
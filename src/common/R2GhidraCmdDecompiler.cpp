@@ -1,10 +1,8 @@
 
 #include "R2GhidraCmdDecompiler.h"
+#include "CodeMetaBuilder.h"
 #include "Iaito.h"
 
-#include <QJsonArray>
-#include <QJsonObject>
-
 /*
 RCodeMeta *Decompiler::makeWarning(QString warningMessage){
     std::string temporary = warningMessage.toStdString();
@@ -25,42 +23,7 @@ bool R2GhidraCmdDecompiler::isAvailable()
 
 RCodeMeta *R2GhidraCmdDecompiler::decompileSync(RVA addr)
 {
-    auto document = Core()->cmdj("pdgj @ " + QString::number(addr));
-    QJsonObject json = document.object();
-    if (json.isEmpty()) {
-        //    emit finished(Decompiler::makeWarning(tr("Failed to parse JSON
-        //    from pdc")));
-        return NULL;
-    }
-    QString codeString = json["code"].toString();
-    RCodeMeta *code = r_codemeta_new("");
-    QJsonArray linesArray = json["annotations"].toArray();
-    for (const QJsonValueRef line : linesArray) {
-        QJsonObject lineObject = line.toObject();
-        if (lineObject.isEmpty()) {
-            continue;
-        }
-        if (lineObject["type"].toString() != "offset") {
-            continue;
-        }
-        RCodeMetaItem *mi = r_codemeta_item_new();
-        mi->start = lineObject["start"].toInt();
-        mi->end = lineObject["end"].toInt();
-        bool ok;
-        mi->type = R_CODEMETA_TYPE_OFFSET;
-        mi->offset.offset = lineObject["offset"].toVariant().toULongLong(&ok);
-        r_codemeta_add_item(code, mi);
-    }
-
-    for (const auto line : json["errors"].toArray()) {
-        if (!line.isString()) {
-            continue;
-        }
-        codeString.append(line.toString() + "\n");
-    }
-    std::string tmp = codeString.toStdString();
-    code->code = strdup(tmp.c_str());
-    return code;
+    return CodeMetaBuilder::fromJson(Core()->cmdStr("pdgj @ " + QString::number(addr)));
 }
 
 void R2GhidraCmdDecompiler::decompileAt(RVA addr)
@@ -70,41 +33,13 @@ void R2GhidraCmdDecompiler::decompileAt(RVA addr)
     }
     task = new R2Task("pdgj @ " + QString::number(addr));
     connect(task, &R2Task::finished, this, [this]() {
-        QJsonObject json = task->getResultJson().object();
+        RCodeMeta *code = CodeMetaBuilder::fromJson(task->takeResultRaw());
         delete task;
         task = nullptr;
-        if (json.isEmpty()) {
-            emit finished(Decompiler::makeWarning(tr("Failed to parse JSON from r2ghidra")));
+        if (!code) {
+            finishWithWarning(tr("Failed to parse JSON from r2ghidra"));
             return;
         }
-        RCodeMeta *code = r_codemeta_new("");
-        QString codeString = json["code"].toString();
-        QJsonArray linesArray = json["annotations"].toArray();
-        for (const QJsonValueRef line : linesArray) {
-            QJsonObject lineObject = line.toObject();
-            if (lineObject.isEmpty()) {
-                continue;
-            }
-            if (lineObject["type"].toString() != "offset") {
-                continue;
-            }
-            RCodeMetaItem *mi = r_codemeta_item_new();
-            mi->start = lineObject["start"].toInt();
-            mi->end = lineObject["end"].toInt();
-            bool ok;
-            mi->type = R_CODEMETA_TYPE_OFFSET;
-            mi->offset.offset = lineObject["offset"].toVariant().toULongLong(&ok);
-            r_codemeta_add_item(code, mi);
-        }
-
-        for (const auto line : json["errors"].toArray()) {
-            if (!line.isString()) {
-                continue;
-            }
-            codeString.append(line.toString() + "\n");
-        }
-        std::string tmp = codeString.toStdString();
-        code->code = strdup(tmp.c_str());
         emit finished(code);
     });
     task->startTask();
@@ -0,0 +1,111 @@
+#include "common/R2Native.h"
+#include "common/R2Shims.h"
+#include "core/Iaito.h"
+
+#include <r_core.h>
+
+// sections bigger than this are not hashed when computing the entropy
+#define R2NATIVE_ENTROPY_MAXSIZE (64 * 1024 * 1024)
+
+namespace r2native {
+
+QString toQString(const char *str)
+{
+    return str ? QString::fromUtf8(str) : QString();
+}
+
+QString permString(int perm)
+{
+    return QString::fromLatin1(r_str_rwx_i(perm));
+}
+
+QString sectionEntropy(RCore *core, const RBinSection *section)
+{
+    if (!section->size || section->size > R2NATIVE_ENTROPY_MAXSIZE) {
+        return QString();
+    }
+    QByteArray data(static_cast<int>(section->size), '\0');
+    r_io_pread_at(core->io, section->paddr, reinterpret_cast<ut8 *>(data.data()), data.size());
+    double entropy = r_hash_entropy(reinterpret_cast<const ut8 *>(data.constData()), data.size());
+    return QString::number(entropy, 'f', 8);
+}
+
+StringDescription stringDescription(RBinObject *bo, const RBinString *str)
+{
+    StringDescription string;
+    string.string = toQString(str->string);
+    string.vaddr = str->vaddr;
+    string.type = toQString(r_bin_string_type(str->type));
+    string.size = str->size;
+    string.length = str->length;
+    RBinSection *section = bo ? r_bin_get_section_at(bo, str->paddr, false) : nullptr;
+    string.section = section ? toQString(section->name) : QString();
+    return string;
+}
+
+SectionDescription sectionDescription(const RBinSection *section)
+{
+    SectionDescription desc;
+    desc.name = toQString(section->name);
+    desc.vaddr = section->vaddr;
+    desc.vsize = section->vsize;
+    desc.paddr = section->paddr;
+    desc.size = section->size;
+    desc.perm = permString(section->perm);
+    return desc;
+}
+
+SegmentDescription segmentDescription(const RBinSection *segment)
+{
+    SegmentDescription desc;
+    desc.name = toQString(segment->name);
+    desc.vaddr = segment->vaddr;
+    desc.paddr = segment->paddr;
+    desc.size = segment->size;
+    desc.vsize = segment->vsize;
+    desc.perm = permString(segment->perm);
+    return desc;
+}
+
+bool isExport(const RBinSymbol *symbol)
+{
+    return symbol->bind && !strcmp(symbol->bind, R_BIN_BIND_GLOBAL_STR) && !symbol->is_imported;
+}
+
+ExportDescription exportDescription(RCore *core, const RBinSymbol *symbol)
+{
+    ExportDescription exp;
+    exp.vaddr = symbol->vaddr;
+    exp.paddr = symbol->paddr;
+    exp.size = symbol->size;
+    exp.type = toQString(symbol->type);
+    exp.name = toQString(r_bin_name_tostring(symbol->name));
+    RFlagItem *fi = r_flag_get_i(core->flags, symbol->vaddr);
+    exp.flag_name = fi ? toQString(fi->name) : QString();
+    return exp;
+}
+
+FlagDescription flagDescription(const RFlagItem *item)
+{
+    FlagDescription flag;
+    flag.offset = ADDRESS_OF(item);
+    flag.size = item->size;
+    flag.name = toQString(item->name);
+    flag.realname = toQString(item->realname);
+    return flag;
+}
+
+QString flagWithDelta(RCore *core, RVA addr)
+{
+    RFlagItem *fi = r_flag_get_at(core->flags, addr, true);
+    if (!fi) {
+        return QString();
+    }
+    RVA flagAddr = ADDRESS_OF(fi);
+    if (flagAddr == addr) {
+        return toQString(fi->name);
+    }
+    return QStringLiteral("%1 + %2").arg(toQString(fi->name)).arg(addr - flagAddr);
+}
+
+} // namespace r2native
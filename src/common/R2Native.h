@@ -0,0 +1,48 @@
+#ifndef R2NATIVE_H
+#define R2NATIVE_H
+
+#include "core/IaitoCommon.h"
+#include "core/IaitoDescriptions.h"
+
+/**
+ * @brief Conversion layer from radare2 structures to Iaito descriptions.
+ *
+ * These helpers are used by the IaitoCore list getters to walk RBin, RFlag
+ * and RAnal data directly instead of serializing it to JSON with a command
+ * and parsing it back. None of them lock the core, the caller is expected to
+ * hold CORE_LOCK() while the radare2 structures are accessed.
+ */
+namespace r2native {
+
+IAITO_EXPORT QString toQString(const char *str);
+
+/**
+ * @brief Permission string as printed by r2 (e.g. "-r-x")
+ */
+IAITO_EXPORT QString permString(int perm);
+
+/**
+ * @brief Shannon entropy of the section contents as printed by "iS entropy"
+ * @return empty string if the section is empty or too big to be hashed
+ */
+IAITO_EXPORT QString sectionEntropy(RCore *core, const RBinSection *section);
+
+IAITO_EXPORT StringDescription stringDescription(RBinObject *bo, const RBinString *str);
+IAITO_EXPORT SectionDescription sectionDescription(const RBinSection *section);
+IAITO_EXPORT SegmentDescription segmentDescription(const RBinSection *segment);
+/**
+ * @brief Whether \a symbol is listed by "iE"
+ */
+IAITO_EXPORT bool isExport(const RBinSymbol *symbol);
+IAITO_EXPORT ExportDescription exportDescription(RCore *core, const RBinSymbol *symbol);
+IAITO_EXPORT FlagDescription flagDescription(const RFlagItem *item);
+
+/**
+ * @brief Nearest flag at or before \a addr with its delta, like the "fd"
+ * command (e.g. "sym.main + 4")
+ */
+IAITO_EXPORT QString flagWithDelta(RCore *core, RVA addr);
+
+} // namespace r2native
+
+#endif // R2NATIVE_H
@@ -69,3 +69,13 @@ const char *R2Task::getResultRaw()
 {
     return task != nullptr ? task->res : nullptr;
 }
+
+char *R2Task::takeResultRaw()
+{
+    if (task == nullptr) {
+        return nullptr;
+    }
+    char *res = task->res;
+    task->res = nullptr;
+    return res;
+}
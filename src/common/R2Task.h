@@ -27,6 +27,10 @@ public:
     QString getResult();
     QJsonDocument getResultJson();
     const char *getResultRaw();
+    /**
+     * @brief Take over the output buffer, to free with r_mem_free()
+     */
+    char *takeResultRaw();
 
 signals:
     void finished();
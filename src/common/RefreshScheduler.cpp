@@ -0,0 +1,199 @@
+#include "common/RefreshScheduler.h"
+#include "core/Iaito.h"
+#include "widgets/IaitoDockWidget.h"
+
+#include <QElapsedTimer>
+#include <QWidget>
+
+#include <algorithm>
+
+RefreshScheduler::RefreshScheduler(IaitoCore *core)
+    : QObject(core)
+{
+    timer.setSingleShot(true);
+    timer.setInterval(0);
+    connect(&timer, &QTimer::timeout, this, &RefreshScheduler::flush);
+
+    auto mark = [this](Kinds kinds) { return [this, kinds]() { markDirty(kinds); }; };
+    connect(core, &IaitoCore::refreshAll, this, mark(Everything));
+    connect(core, &IaitoCore::functionsChanged, this, mark(Functions));
+    connect(core, &IaitoCore::functionRenamed, this, mark(FunctionRenamed));
+    connect(core, &IaitoCore::varsChanged, this, mark(Vars));
+    connect(core, &IaitoCore::flagsChanged, this, mark(Flags));
+    connect(core, &IaitoCore::commentsChanged, this, mark(Comments));
+    connect(core, &IaitoCore::registersChanged, this, mark(Registers));
+    connect(core, &IaitoCore::stackChanged, this, mark(Stack));
+    connect(core, &IaitoCore::breakpointsChanged, this, mark(Breakpoints));
+    connect(core, &IaitoCore::instructionChanged, this, mark(Instructions));
+    connect(core, &IaitoCore::refreshCodeViews, this, mark(CodeViews));
+    connect(core, &IaitoCore::codeRebased, this, mark(Rebased));
+    connect(core, &IaitoCore::debugTaskStateChanged, this, mark(Debug));
+    connect(core, &IaitoCore::switchedThread, this, mark(Debug));
+    connect(core, &IaitoCore::switchedProcess, this, mark(Debug));
+}
+
+RefreshScheduler::~RefreshScheduler() {}
+
+void RefreshScheduler::subscribe(
+    QObject *receiver, Kinds kinds, std::function<void()> refresh, const QString &name)
+{
+    auto subscription = std::make_unique<Subscription>();
+    subscription->receiver = receiver;
+    subscription->kinds = kinds;
+    subscription->refresh = std::move(refresh);
+    subscription->timing.name = name.isEmpty() ? receiver->metaObject()->className() : name;
+    subscriptions.push_back(std::move(subscription));
+    connect(receiver, &QObject::destroyed, this, &RefreshScheduler::forget, Qt::UniqueConnection);
+}
+
+void RefreshScheduler::markDirty(Kinds kinds)
+{
+    dirty |= kinds;
+    if (!timer.isActive()) {
+        timer.start();
+    }
+}
+
+void RefreshScheduler::flush()
+{
+    timer.stop();
+    if (!dirty || dispatching) {
+        return;
+    }
+    Kinds kinds = dirty;
+    dirty = {};
+    dispatching = true;
+
+    // subscribers may be added while refreshing, only look at the current ones
+    std::vector<Subscription *> visible;
+    std::vector<Subscription *> others;
+    for (auto &subscription : subscriptions) {
+        if (!subscription->receiver
+            || !(kinds.testFlag(Everything) || (subscription->kinds & kinds))) {
+            continue;
+        }
+        switch (visibility(*subscription)) {
+        case Visibility::Visible:
+            visible.push_back(subscription.get());
+            break;
+        case Visibility::Unknown:
+            others.push_back(subscription.get());
+            break;
+        case Visibility::Hidden:
+            defer(*subscription, kinds);
+            break;
+        }
+    }
+
+    qint64 elapsedNs = 0;
+    for (auto list : {&visible, &others}) {
+        for (Subscription *subscription : *list) {
+            elapsedNs += run(*subscription, kinds);
+        }
+    }
+
+    dispatching = false;
+    removeDead();
+    emit batchDispatched(elapsedNs);
+
+    // events emitted by the refreshes themselves go to the next batch
+    if (dirty) {
+        timer.start();
+    }
+}
+
+QList<RefreshScheduler::Timing> RefreshScheduler::timings() const
+{
+    QList<Timing> result;
+    for (const auto &subscription : subscriptions) {
+        if (subscription->timing.count) {
+            result.append(subscription->timing);
+        }
+    }
+    std::sort(result.begin(), result.end(), [](const Timing &a, const Timing &b) {
+        return a.totalNs > b.totalNs;
+    });
+    return result;
+}
+
+IaitoDockWidget *RefreshScheduler::dockOf(QObject *object)
+{
+    for (; object; object = object->parent()) {
+        if (auto dock = qobject_cast<IaitoDockWidget *>(object)) {
+            return dock;
+        }
+    }
+    return nullptr;
+}
+
+RefreshScheduler::Visibility RefreshScheduler::visibility(const Subscription &subscription) const
+{
+    if (IaitoDockWidget *dock = dockOf(subscription.receiver)) {
+        return dock->isVisibleToUser() ? Visibility::Visible : Visibility::Hidden;
+    }
+    // toolbars and other widgets can't tell us when they get shown, never skip them
+    auto widget = qobject_cast<QWidget *>(subscription.receiver);
+    return widget && widget->isVisible() ? Visibility::Visible : Visibility::Unknown;
+}
+
+qint64 RefreshScheduler::run(Subscription &subscription, Kinds kinds)
+{
+    if (!subscription.receiver) {
+        // destroyed by a previous refresh of this batch
+        return 0;
+    }
+    QElapsedTimer elapsed;
+    elapsed.start();
+    Kinds previous = current;
+    current = kinds;
+    subscription.refresh();
+    current = previous;
+    qint64 ns = elapsed.nsecsElapsed();
+    subscription.timing.count++;
+    subscription.timing.lastNs = ns;
+    subscription.timing.totalNs += ns;
+    return ns;
+}
+
+void RefreshScheduler::defer(Subscription &subscription, Kinds kinds)
+{
+    subscription.deferred |= kinds;
+    if (subscription.deferredConnected) {
+        return;
+    }
+    IaitoDockWidget *dock = dockOf(subscription.receiver);
+    subscription.deferredConnected = true;
+    Subscription *s = &subscription;
+    // the receiver is the context, the connection goes away together with it
+    connect(dock, &IaitoDockWidget::becameVisibleToUser, subscription.receiver, [this, s]() {
+        if (s->deferred) {
+            Kinds kinds = s->deferred;
+            s->deferred = {};
+            run(*s, kinds);
+        }
+    });
+}
+
+void RefreshScheduler::forget(QObject *receiver)
+{
+    // QPointer is not cleared yet when a QWidget emits destroyed()
+    for (auto &subscription : subscriptions) {
+        if (subscription->receiver == receiver) {
+            subscription->receiver = nullptr;
+        }
+    }
+    removeDead();
+}
+
+void RefreshScheduler::removeDead()
+{
+    if (dispatching) {
+        return;
+    }
+    subscriptions.erase(
+        std::remove_if(
+            subscriptions.begin(),
+            subscriptions.end(),
+            [](const std::unique_ptr<Subscription> &s) { return !s->receiver; }),
+        subscriptions.end());
+}
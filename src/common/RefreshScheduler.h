@@ -0,0 +1,159 @@
+#ifndef REFRESHSCHEDULER_H
+#define REFRESHSCHEDULER_H
+
+#include "core/IaitoCommon.h"
+
+#include <QFlags>
+#include <QList>
+#include <QObject>
+#include <QPointer>
+#include <QString>
+#include <QTimer>
+
+#include <functional>
+#include <memory>
+#include <vector>
+
+class IaitoCore;
+class IaitoDockWidget;
+
+/**
+ * @brief Central scheduler for the refreshes triggered by core events.
+ *
+ * Widgets subscribe with the kinds of data they show instead of connecting
+ * their reload slot to every IaitoCore signal. The events received while the
+ * event loop is busy (refreshAll, functionsChanged, flagsChanged...) are merged
+ * and each subscriber is called at most once per batch: F5 or the end of an
+ * analysis emitting several signals results in a single reload per widget.
+ *
+ * Subscribers inside a dock visible to the user are refreshed first. Those
+ * inside a hidden dock are not refreshed at all until it becomes visible, the
+ * kinds they missed are kept until then.
+ *
+ * The time spent in each subscriber is recorded, see timings().
+ */
+class IAITO_EXPORT RefreshScheduler : public QObject
+{
+    Q_OBJECT
+
+public:
+    enum Kind {
+        /**
+         * only refresh on refreshAll
+         */
+        Nothing = 0,
+        Functions = 1 << 0,
+        FunctionRenamed = 1 << 1,
+        Vars = 1 << 2,
+        Flags = 1 << 3,
+        Comments = 1 << 4,
+        Registers = 1 << 5,
+        Stack = 1 << 6,
+        Breakpoints = 1 << 7,
+        /**
+         * instructionChanged, bytes were written at some address
+         */
+        Instructions = 1 << 8,
+        CodeViews = 1 << 9,
+        Rebased = 1 << 10,
+        /**
+         * debugger task state, thread or process switched
+         */
+        Debug = 1 << 11,
+        /**
+         * refreshAll, anything may have changed
+         */
+        Everything = 0xffff
+    };
+    Q_DECLARE_FLAGS(Kinds, Kind)
+
+    struct Timing
+    {
+        QString name;
+        int count = 0;
+        qint64 lastNs = 0;
+        qint64 totalNs = 0;
+    };
+
+    explicit RefreshScheduler(IaitoCore *core);
+    ~RefreshScheduler() override;
+
+    /**
+     * @brief Call \a refresh whenever any of \a kinds is marked dirty, until
+     * \a receiver is destroyed. Every subscriber is refreshed on Everything.
+     * @param name shown in timings(), defaults to the class of \a receiver
+     */
+    void subscribe(
+        QObject *receiver,
+        Kinds kinds,
+        std::function<void()> refresh,
+        const QString &name = QString());
+
+    template<class Receiver>
+    void subscribe(Receiver *receiver, Kinds kinds, void (Receiver::*slot)())
+    {
+        subscribe(receiver, kinds, [receiver, slot]() { (receiver->*slot)(); });
+    }
+
+    /**
+     * @brief Schedule a refresh of the subscribers of \a kinds once control
+     * returns to the event loop.
+     */
+    void markDirty(Kinds kinds);
+
+    /**
+     * @brief Dispatch the pending refreshes right away.
+     */
+    void flush();
+
+    /**
+     * @brief Kinds that caused the refresh being dispatched, for subscribers
+     * reacting differently to a full refresh
+     */
+    Kinds dispatchedKinds() const { return current; }
+
+    /**
+     * @brief Time spent refreshing, per subscriber, slowest first
+     */
+    QList<Timing> timings() const;
+
+signals:
+    /**
+     * @brief Emitted after a batch was dispatched
+     * @param elapsedNs time spent in the subscribers of this batch
+     */
+    void batchDispatched(qint64 elapsedNs);
+
+private:
+    struct Subscription
+    {
+        QPointer<QObject> receiver;
+        Kinds kinds;
+        std::function<void()> refresh;
+        Timing timing;
+        /**
+         * kinds missed while the dock was hidden
+         */
+        Kinds deferred;
+        bool deferredConnected = false;
+    };
+
+    enum class Visibility { Visible, Unknown, Hidden };
+
+    std::vector<std::unique_ptr<Subscription>> subscriptions;
+    Kinds dirty;
+    Kinds current;
+    QTimer timer;
+    bool dispatching = false;
+
+    static IaitoDockWidget *dockOf(QObject *object);
+    Visibility visibility(const Subscription &subscription) const;
+    qint64 run(Subscription &subscription, Kinds kinds);
+    void defer(Subscription &subscription, Kinds kinds);
+    void forget(QObject *receiver);
+    void removeDead();
+};
+
+Q_DECLARE_OPERATORS_FOR_FLAGS(RefreshScheduler::Kinds)
+
+#endif // REFRESHSCHEDULER_H
@@ -5,6 +5,9 @@
 #include <QPainter>
 #include <QTextBlock>
 #include <QTextFragment>
+#include <QVector>
+
+#include <utility>
 
 // TODO: fix performance (possibly use QTextLayout?)
 
@@ -173,6 +176,179 @@ RichTextPainter::List RichTextPainter::fromTextDocument(const QTextDocument &doc
     return r;
 }
 
+static QColor ansiBasicColor(int index)
+{
+    static const QColor colors[16] = {
+        QColor(0x00, 0x00, 0x00),
+        QColor(0x80, 0x00, 0x00),
+        QColor(0x00, 0x80, 0x00),
+        QColor(0x80, 0x80, 0x00),
+        QColor(0x00, 0x00, 0x80),
+        QColor(0x80, 0x00, 0x80),
+        QColor(0x00, 0x80, 0x80),
+        QColor(0xc0, 0xc0, 0xc0),
+        QColor(0x80, 0x80, 0x80),
+        QColor(0xff, 0x00, 0x00),
+        QColor(0x00, 0xff, 0x00),
+        QColor(0xff, 0xff, 0x00),
+        QColor(0x00, 0x00, 0xff),
+        QColor(0xff, 0x00, 0xff),
+        QColor(0x00, 0xff, 0xff),
+        QColor(0xff, 0xff, 0xff),
+    };
+    return colors[index & 15];
+}
+
+static QColor ansi256Color(int index)
+{
+    if (index < 16) {
+        return ansiBasicColor(index);
+    }
+    if (index < 232) {
+        static const int levels[6] = {0x00, 0x5f, 0x87, 0xaf, 0xd7, 0xff};
+        index -= 16;
+        return QColor(levels[(index / 36) % 6], levels[(index / 6) % 6], levels[index % 6]);
+    }
+    int gray = 8 + (index - 232) * 10;
+    return QColor(gray, gray, gray);
+}
+
+/**
+ * @brief Apply the parameters of a "\e[...m" sequence to the current colors,
+ * an invalid color means the default one.
+ */
+static void applyAnsiSgr(const QVector<int> &params, QColor &foreground, QColor &background)
+{
+    if (params.isEmpty()) {
+        foreground = background = QColor();
+        return;
+    }
+    for (int i = 0; i < params.size(); i++) {
+        int p = params[i];
+        if (p == 0) {
+            foreground = background = QColor();
+        } else if (p >= 30 && p <= 37) {
+            foreground = ansiBasicColor(p - 30);
+        } else if (p >= 90 && p <= 97) {
+            foreground = ansiBasicColor(p - 90 + 8);
+        } else if (p == 39) {
+            foreground = QColor();
+        } else if (p >= 40 && p <= 47) {
+            background = ansiBasicColor(p - 40);
+        } else if (p >= 100 && p <= 107) {
+            background = ansiBasicColor(p - 100 + 8);
+        } else if (p == 49) {
+            background = QColor();
+        } else if (p == 38 || p == 48) {
+            QColor &color = p == 38 ? foreground : background;
+            if (i + 2 < params.size() && params[i + 1] == 5) {
+                color = ansi256Color(params[i + 2] & 0xff);
+                i += 2;
+            } else if (i + 4 < params.size() && params[i + 1] == 2) {
+                color = QColor(params[i + 2] & 0xff, params[i + 3] & 0xff, params[i + 4] & 0xff);
+                i += 4;
+            } else {
+                // malformed, ignore the rest of the sequence
+                return;
+            }
+        }
+        // bold, underline, inverse and friends can't be represented, ignore them
+    }
+}
+
+RichTextPainter::List RichTextPainter::fromAnsi(const QString &text, QString *plainText)
+{
+    List r;
+    QColor foreground;
+    QColor background;
+    QString current;
+    QVector<int> params;
+
+    if (plainText) {
+        plainText->clear();
+    }
+
+    auto flush = [&]() {
+        if (current.isEmpty()) {
+            return;
+        }
+        if (plainText) {
+            plainText->append(current);
+        }
+        CustomRichText_t part;
+        part.text = current;
+        part.textColor = foreground;
+        part.textBackground = background;
+        if (foreground.isValid() && background.isValid()) {
+            part.flags = FlagAll;
+        } else if (foreground.isValid()) {
+            part.flags = FlagColor;
+        } else if (background.isValid()) {
+            part.flags = FlagBackground;
+        } else {
+            part.flags = FlagNone;
+        }
+        r.push_back(part);
+        current.clear();
+    };
+
+    const QChar *data = text.constData();
+    const int size = text.size();
+    for (int i = 0; i < size; i++) {
+        QChar c = data[i];
+        if (c == QChar(0x1b)) {
+            if (i + 1 >= size || data[i + 1] != QLatin1Char('[')) {
+                continue;
+            }
+            // CSI: parameters, then a final byte in the @ to ~ range
+            params.clear();
+            int value = 0;
+            bool hasValue = false;
+            int j = i + 2;
+            for (; j < size; j++) {
+                QChar p = data[j];
+                if (p.isDigit()) {
+                    value = value * 10 + p.digitValue();
+                    hasValue = true;
+                } else if (p == QLatin1Char(';')) {
+                    params.append(hasValue ? value : 0);
+                    value = 0;
+                    hasValue = false;
+                } else {
+                    break;
+                }
+            }
+            if (hasValue || !params.isEmpty()) {
+                params.append(value);
+            }
+            if (j < size && data[j] == QLatin1Char('m')) {
+                QColor oldForeground = foreground;
+                QColor oldBackground = background;
+                applyAnsiSgr(params, foreground, background);
+                if (foreground != oldForeground || background != oldBackground) {
+                    // flush with the colors the pending text was written with
+                    std::swap(foreground, oldForeground);
+                    std::swap(background, oldBackground);
+                    flush();
+                    foreground = oldForeground;
+                    background = oldBackground;
+                }
+            }
+            // other sequences (cursor movement, clear screen...) are dropped
+            i = j;
+            continue;
+        }
+        if (c == QLatin1Char('\t')) {
+            // like the HTML conversion, which collapses it to a single space
+            c = QLatin1Char(' ');
+        }
+        current.append(c);
+    }
+    flush();
+
+    return r;
+}
+
 RichTextPainter::List RichTextPainter::cropped(
     const RichTextPainter::List &richText, int maxCols, const QString &indicator, bool *croppedOut)
 {
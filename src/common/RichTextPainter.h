@@ -48,6 +48,12 @@ public:
     static void htmlRichText(const List &richText, QString &textHtml, QString &textPlain);
 
     static List fromTextDocument(const QTextDocument &doc);
+    /**
+     * @brief Split text colored with ANSI escape sequences (SGR) into rich
+     * text parts, without going through HTML and QTextDocument.
+     * @param plainText if not null, receives the text without the escapes
+     */
+    static List fromAnsi(const QString &text, QString *plainText = nullptr);
 
     static List cropped(
         const List &richText,
@@ -1,10 +1,12 @@
-
 #ifndef STRINGSASYNCTASK_H
 #define STRINGSASYNCTASK_H
 
 #include "common/AsyncTask.h"
 #include "core/Iaito.h"
 
+// number of strings delivered to the widget at once
+#define STRINGS_TASK_BATCH_SIZE 4096
+
 class StringsTask : public AsyncTask
 {
     Q_OBJECT
@@ -13,17 +15,25 @@ public:
     QString getTitle() override { return tr("Searching for Strings"); }
 
 signals:
-    void stringSearchFinished(const QList<StringDescription> &strings);
+    void stringsFound(const QList<StringDescription> &strings, qint64 done, qint64 total);
+    void stringSearchFinished();
 
 protected:
     void runTask() override
     {
-#if MONOTHREAD
-        QList<StringDescription> strings;
-#else
-        auto strings = Core()->getAllStrings();
-#endif
-        emit stringSearchFinished(strings);
+        const bool complete = Core()->getAllStrings(
+            STRINGS_TASK_BATCH_SIZE,
+            [this](const QList<StringDescription> &strings, qint64 done, qint64 total) {
+                if (isInterrupted()) {
+                    return false;
+                }
+                emit stringsFound(strings, done, total);
+                return true;
+            });
+        if (!complete && !isInterrupted()) {
+            log(tr("The binary changed while its strings were listed."));
+        }
+        emit stringSearchFinished();
     }
 };
 
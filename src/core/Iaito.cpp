@@ -10,6 +10,7 @@
 #include <QVector>
 
 #include <cassert>
+#include <climits>
 #include <memory>
 
 #include "Decompiler.h"
@@ -17,8 +18,10 @@
 #include "common/BasicInstructionHighlighter.h"
 #include "common/Configuration.h"
 #include "common/Json.h"
+#include "common/R2Native.h"
 #include "common/R2Shims.h"
 #include "common/R2Task.h"
+#include "common/RefreshScheduler.h"
 #include "common/TempConfig.h"
 #include "core/Iaito.h"
 #include "plugins/PluginManager.h"
@@ -273,6 +276,81 @@ void IaitoCore::initialize(bool loadPlugins)
 
     // Initialize Async tasks manager
     asyncTaskManager = new AsyncTaskManager(this);
+
+    // Initialize the refresh scheduler, widgets subscribe to it
+    refreshScheduler = new RefreshScheduler(this);
+
+    connect(this, &IaitoCore::commentsChanged, this, &IaitoCore::invalidateComment);
+    connect(this, &IaitoCore::codeRebased, this, &IaitoCore::invalidateCommentIndex);
+
+    // the navbar statistics are updated per source, or per function when known
+    connect(this, &IaitoCore::refreshAll, this, [this]() {
+        invalidateAddressCoverage(AddressCoverage::AllSources);
+    });
+    connect(this, &IaitoCore::codeRebased, this, [this]() {
+        invalidateAddressCoverage(AddressCoverage::AllSources);
+    });
+    connect(this, &IaitoCore::functionsChanged, this, [this]() {
+        if (!singleFunctionChanged) {
+            invalidateAddressCoverage(AddressCoverage::Functions);
+        }
+    });
+    connect(this, &IaitoCore::flagsChanged, this, [this]() {
+        invalidateAddressCoverage(AddressCoverage::Flags);
+    });
+
+    // anything that may change the bytes read through r_io
+    connect(this, &IaitoCore::refreshAll, this, &IaitoCore::bumpIOGeneration);
+    connect(this, &IaitoCore::instructionChanged, this, &IaitoCore::bumpIOGeneration);
+    connect(this, &IaitoCore::registersChanged, this, &IaitoCore::bumpIOGeneration);
+    connect(this, &IaitoCore::stackChanged, this, &IaitoCore::bumpIOGeneration);
+    connect(this, &IaitoCore::codeRebased, this, &IaitoCore::bumpIOGeneration);
+    connect(this, &IaitoCore::switchedThread, this, &IaitoCore::bumpIOGeneration);
+    connect(this, &IaitoCore::switchedProcess, this, &IaitoCore::bumpIOGeneration);
+    connect(this, &IaitoCore::debugProcessFinished, this, &IaitoCore::bumpIOGeneration);
+    connect(this, &IaitoCore::ioModeChanged, this, &IaitoCore::bumpIOGeneration);
+    connect(this, &IaitoCore::writeModeChanged, this, &IaitoCore::bumpIOGeneration);
+
+    // anything that may change the decompiled code of unchanged functions
+    connect(this, &IaitoCore::refreshAll, this, &IaitoCore::bumpAnalysisGeneration);
+    connect(this, &IaitoCore::instructionChanged, this, &IaitoCore::bumpAnalysisGeneration);
+    connect(this, &IaitoCore::functionRenamed, this, &IaitoCore::bumpAnalysisGeneration);
+    connect(this, &IaitoCore::varsChanged, this, &IaitoCore::bumpAnalysisGeneration);
+    connect(this, &IaitoCore::typesChanged, this, &IaitoCore::bumpAnalysisGeneration);
+    connect(this, &IaitoCore::functionsChanged, this, &IaitoCore::bumpAnalysisGeneration);
+    connect(this, &IaitoCore::flagsChanged, this, &IaitoCore::bumpAnalysisGeneration);
+    connect(this, &IaitoCore::commentsChanged, this, &IaitoCore::bumpAnalysisGeneration);
+    connect(this, &IaitoCore::codeRebased, this, &IaitoCore::bumpAnalysisGeneration);
+    connect(this, &IaitoCore::refreshCodeViews, this, &IaitoCore::bumpAnalysisGeneration);
+
+    // anything that may change the disassembly text of unchanged bytes
+    connect(this, &IaitoCore::asmOptionsChanged, this, &IaitoCore::clearDisassemblyCache);
+    connect(this, &IaitoCore::commentsChanged, this, &IaitoCore::clearDisassemblyCache);
+    connect(this, &IaitoCore::flagsChanged, this, &IaitoCore::clearDisassemblyCache);
+    connect(this, &IaitoCore::functionsChanged, this, &IaitoCore::clearDisassemblyCache);
+    connect(this, &IaitoCore::functionRenamed, this, &IaitoCore::clearDisassemblyCache);
+    connect(this, &IaitoCore::varsChanged, this, &IaitoCore::clearDisassemblyCache);
+    connect(this, &IaitoCore::breakpointsChanged, this, &IaitoCore::clearDisassemblyCache);
+    connect(this, &IaitoCore::refreshCodeViews, this, &IaitoCore::clearDisassemblyCache);
+
+    // every debug task ends changing the registers, the widgets refreshing
+    // afterwards share what they query about the new stop
+    connect(this, &IaitoCore::registersChanged, this, &IaitoCore::startDebugSnapshot);
+    connect(this, &IaitoCore::refreshAll, this, [this]() {
+        CORE_LOCK();
+        debugSnapshot = DebugSnapshot();
+        breakpointIndex.invalidate();
+    });
+    connect(this, &IaitoCore::breakpointsChanged, this, [this](RVA addr) {
+        CORE_LOCK();
+        debugSnapshot.breakpoints.reset();
+        breakpointIndex.invalidateAt(addr);
+    });
+    connect(this, &IaitoCore::toggleDebugView, this, [this]() {
+        CORE_LOCK();
+        debugSnapshot = DebugSnapshot();
+        previousDebugSnapshot = DebugSnapshot();
+    });
 }
 
 IaitoCore::~IaitoCore()
@@ -582,13 +660,19 @@ QString IaitoCore::cmdRaw(const char *rcmd)
     return res;
 }
 
-QJsonDocument IaitoCore::cmdj(const char *str)
+char *IaitoCore::cmdStr(const char *str)
 {
     CORE_LOCK();
     const bool html = r_config_get_b(core->config, "scr.html");
     r_config_set_b(core->config, "scr.html", false);
     char *res = r_core_cmd_str(core, str);
     r_config_set_b(core->config, "scr.html", html);
+    return res;
+}
+
+QJsonDocument IaitoCore::cmdj(const char *str)
+{
+    char *res = cmdStr(str);
     QJsonDocument doc = parseJson(res, str);
     r_mem_free(res);
     return doc;
@@ -613,14 +697,13 @@ QString IaitoCore::cmdTask(const QString &str)
 
 QJsonDocument IaitoCore::cmdjTask(const QString &str)
 {
-#if MONOTHREAD
-    return cmdj(str);
-#else
+    if (!threadedMode) {
+        return cmdj(str);
+    }
     R2Task task(str);
     task.startTask();
     task.joinTask();
     return parseJson(task.getResultRaw(), str);
-#endif
 }
 
 QJsonDocument IaitoCore::parseJson(const char *res, const char *cmd)
@@ -817,7 +900,7 @@ void IaitoCore::renameFunction(const RVA offset, const QString &newName)
 void IaitoCore::delFunction(RVA addr)
 {
     cmdRaw("af- " + RAddressString(addr));
-    emit functionsChanged();
+    emitFunctionChangedAt(addr);
 }
 
 void IaitoCore::renameFlag(QString old_name, QString new_name)
@@ -994,7 +1077,71 @@ void IaitoCore::delComment(RVA addr)
 QString IaitoCore::getCommentAt(RVA addr)
 {
     CORE_LOCK();
-    return r_meta_get_string(core->anal, R_META_TYPE_COMMENT, addr);
+    if (!commentIndexValid) {
+        buildCommentIndex();
+    } else if (staleComments.remove(addr)) {
+        QString comment = r2native::toQString(
+            r_meta_get_string(core->anal, R_META_TYPE_COMMENT, addr));
+        if (comment.isEmpty()) {
+            commentIndex.remove(addr);
+        } else {
+            commentIndex.insert(addr, comment);
+        }
+    }
+    return commentIndex.value(addr);
+}
+
+void IaitoCore::buildCommentIndex()
+{
+    CORE_LOCK();
+    commentIndex.clear();
+    staleComments.clear();
+
+    const RSpace *space = r_spaces_current(&core->anal->meta_spaces);
+    RIntervalTreeIter it;
+    RAnalMetaItem *item;
+    r_interval_tree_foreach(&core->anal->meta, it, item)
+    {
+        if (item->type != R_META_TYPE_COMMENT || !item->str) {
+            continue;
+        }
+        if (space && item->space && item->space != space) {
+            continue;
+        }
+        commentIndex.insert(r_interval_tree_iter_get(&it)->start, QString::fromUtf8(item->str));
+    }
+    commentIndexValid = true;
+}
+
+void IaitoCore::invalidateComment(RVA addr)
+{
+    CORE_LOCK();
+    if (commentIndexValid) {
+        staleComments.insert(addr);
+    }
+}
+
+void IaitoCore::invalidateCommentIndex()
+{
+    CORE_LOCK();
+    commentIndexValid = false;
+}
+
+void IaitoCore::emitFunctionChangedAt(RVA addr)
+{
+    {
+        CORE_LOCK();
+        addressCoverage.invalidateFunction(addr);
+    }
+    singleFunctionChanged = true;
+    emit functionsChanged();
+    singleFunctionChanged = false;
+}
+
+void IaitoCore::invalidateAddressCoverage(int sources)
+{
+    CORE_LOCK();
+    addressCoverage.invalidate(sources);
 }
 
 void IaitoCore::setImmediateBase(const QString &r2BaseName, RVA offset)
@@ -1094,6 +1241,15 @@ void IaitoCore::updateSeek()
 RVA IaitoCore::prevOpAddr(RVA startAddr, int count)
 {
     CORE_LOCK();
+    disassemblyCache.sync(getIOGeneration());
+    RVA addr = startAddr;
+    for (int i = 0; i < count && addr != RVA_INVALID; i++) {
+        addr = disassemblyCache.prev(addr);
+    }
+    if (addr != RVA_INVALID) {
+        return addr;
+    }
+
     bool ok;
     RVA offset = cmdRawAt(QStringLiteral("/O %1").arg(count), startAddr).toULongLong(&ok, 16);
     return ok ? offset : startAddr - count;
@@ -1102,6 +1258,14 @@ RVA IaitoCore::prevOpAddr(RVA startAddr, int count)
 RVA IaitoCore::nextOpAddr(RVA startAddr, int count)
 {
     CORE_LOCK();
+    disassemblyCache.sync(getIOGeneration());
+    RVA addr = startAddr;
+    for (int i = 0; i < count && addr != RVA_INVALID; i++) {
+        addr = disassemblyCache.next(addr);
+    }
+    if (addr != RVA_INVALID) {
+        return addr;
+    }
 
     QJsonArray array
         = Core()
@@ -1111,6 +1275,19 @@ RVA IaitoCore::nextOpAddr(RVA startAddr, int count)
         return startAddr + 1;
     }
 
+    RVA prevOffset = RVA_INVALID;
+    for (const QJsonValue value : array) {
+        bool ok;
+        RVA offset = getOffsetOrAddr(value.toObject(), &ok);
+        if (!ok) {
+            break;
+        }
+        if (prevOffset != RVA_INVALID) {
+            disassemblyCache.insertBoundary(prevOffset, offset);
+        }
+        prevOffset = offset;
+    }
+
     QJsonValue instValue = array.last();
     if (!instValue.isObject()) {
         return startAddr + 1;
@@ -1151,30 +1328,35 @@ void IaitoCore::setConfig(const char *k, const char *v)
 {
     CORE_LOCK();
     r_config_set(core->config, k, v);
+    disassemblyProfileValid = false;
 }
 
 void IaitoCore::setConfig(const QString &k, const char *v)
 {
     CORE_LOCK();
     r_config_set(core->config, k.toUtf8().constData(), v);
+    disassemblyProfileValid = false;
 }
 
 void IaitoCore::setConfig(const char *k, const QString &v)
 {
     CORE_LOCK();
     r_config_set(core->config, k, v.toUtf8().constData());
+    disassemblyProfileValid = false;
 }
 
 void IaitoCore::setConfig(const char *k, int v)
 {
     CORE_LOCK();
     r_config_set_i(core->config, k, static_cast<ut64>(v));
+    disassemblyProfileValid = false;
 }
 
 void IaitoCore::setConfig(const char *k, bool v)
 {
     CORE_LOCK();
     r_config_set_b(core->config, k, v);
+    disassemblyProfileValid = false;
 }
 
 int IaitoCore::getConfigi(const char *k)
@@ -1204,6 +1386,7 @@ QString IaitoCore::getConfigDescription(const char *k)
 
 void IaitoCore::triggerRefreshAll()
 {
+    invalidateCommentIndex();
     emit refreshAll();
 }
 
@@ -1317,7 +1500,91 @@ QString IaitoCore::disassemble(const QByteArray &data)
 
 QString IaitoCore::disassembleSingleInstruction(RVA addr)
 {
-    return cmdRawAt("pi 1", addr).simplified();
+    CORE_LOCK();
+    disassemblyCache.sync(getIOGeneration());
+    uint profile = disassemblyProfile(addr);
+    QString text;
+    if (!disassemblyCache.singleInstruction(addr, profile, &text)) {
+        text = cmdRawAt("pi 1", addr).simplified();
+        disassemblyCache.insertSingleInstruction(addr, profile, text);
+    }
+    return text;
+}
+
+void IaitoCore::cacheInstructionSize(RVA addr, RVA size)
+{
+    CORE_LOCK();
+    disassemblyCache.sync(getIOGeneration());
+    disassemblyCache.insertBoundary(addr, addr + size, true);
+}
+
+uint IaitoCore::disassemblyProfile(RVA addr)
+{
+    CORE_LOCK();
+    auto hashString = [](const char *str, uint seed) {
+        return str ? qHash(QByteArray::fromRawData(str, strlen(str)), seed) : qHash(0, seed);
+    };
+    // r2 switches these on its own, e.g. when seeking into code with other
+    // hints, so they are not part of the cached hash
+    auto isVolatile = [](const char *name) {
+        return !strcmp(name, "asm.arch") || !strcmp(name, "asm.bits") || !strcmp(name, "asm.cpu");
+    };
+    if (!disassemblyProfileValid) {
+        uint profile = 0;
+        RListIter *it;
+        RConfigNode *node;
+        IaitoRListForeach(core->config->nodes, it, RConfigNode, node)
+        {
+            if (!node->name || !node->value || isVolatile(node->name)) {
+                continue;
+            }
+            if (r_str_startswith(node->name, "asm.") || r_str_startswith(node->name, "scr.color")
+                || r_str_startswith(node->name, "scr.utf8")
+                || r_str_startswith(node->name, "scr.html")
+                || r_str_startswith(node->name, "emu.")) {
+                profile = hashString(node->name, profile);
+                profile = hashString(node->value, profile);
+            }
+        }
+        disassemblyProfileHash = profile;
+        disassemblyProfileValid = true;
+    }
+
+    uint profile = disassemblyProfileHash;
+    profile = hashString(r_config_get(core->config, "asm.arch"), profile);
+    profile = hashString(r_config_get(core->config, "asm.cpu"), profile);
+    profile = qHash(r_config_get_i(core->config, "asm.bits"), profile);
+    // hints set with "ahb", "aha" and the like override them per address
+    RAnalHint *hint = r_anal_hint_get(core->anal, addr);
+    if (hint) {
+        profile = hashString(hint->arch, profile);
+        profile = hashString(hint->syntax, profile);
+        profile = hashString(hint->opcode, profile);
+        profile = qHash(hint->bits, profile);
+        profile = qHash(hint->immbase, profile);
+        r_anal_hint_free(hint);
+    }
+    return profile;
+}
+
+void IaitoCore::clearDisassemblyCache()
+{
+    CORE_LOCK();
+    disassemblyProfileValid = false;
+    disassemblyCache.clear();
+}
+
+void IaitoCore::consoleCommandExecuted()
+{
+    CORE_LOCK();
+    clearDisassemblyCache();
+    // the command may have stepped, written registers or changed breakpoints
+    debugSnapshot = DebugSnapshot();
+    breakpointIndex.invalidate();
+    // or written memory, switched io.cache or mapped files
+    bumpIOGeneration();
+    // or renamed, commented, typed or analyzed code
+    bumpAnalysisGeneration();
 }
 
 RAnalFunction *IaitoCore::functionIn(ut64 addr)
@@ -1405,7 +1672,7 @@ void IaitoCore::cmdEsil(const char *command)
 QString IaitoCore::createFunctionAt(RVA addr)
 {
     QString ret = cmdRaw(QStringLiteral("af %1").arg(addr));
-    emit functionsChanged();
+    emitFunctionChangedAt(addr);
     return ret;
 }
 
@@ -1414,7 +1681,7 @@ QString IaitoCore::createFunctionAt(RVA addr, QString name)
     static const QRegularExpression regExp("[^a-zA-Z0-9_]");
     name.remove(regExp);
     QString ret = cmdRawAt(QStringLiteral("af %1").arg(name), addr);
-    emit functionsChanged();
+    emitFunctionChangedAt(addr);
     return ret;
 }
 
@@ -1550,50 +1817,58 @@ RefDescription IaitoCore::formatRefDesc(QJsonObject refItem)
     return desc;
 }
 
-QList<QJsonObject> IaitoCore::getRegisterRefs(int depth)
+QList<TelescopeDescription> IaitoCore::getRegisterRefs(int depth)
 {
-    QList<QJsonObject> ret;
+    QList<TelescopeDescription> ret;
     if (!currentlyDebugging) {
         return ret;
     }
 
-    QJsonObject registers = cmdj("drj").object();
+    QJsonObject registers = getRegisterValues().object();
 
+    CORE_LOCK();
+    addressTelescope.sync(getIOGeneration());
     for (const QString &key : registers.keys()) {
-        QJsonObject reg;
-        reg["value"] = registers.value(key);
-        reg["ref"] = getAddrRefs(registers.value(key).toVariant().toULongLong(), depth);
-        reg["name"] = key;
+        TelescopeDescription reg;
+        reg.reg = key;
+        reg.value = registers.value(key).toVariant().toULongLong();
+        reg.refDesc = addressTelescope.describe(core, reg.value, depth);
         ret.append(reg);
     }
 
     return ret;
 }
 
-QList<QJsonObject> IaitoCore::getStack(int size, int depth)
+QList<TelescopeDescription> IaitoCore::getStack(int size, int depth)
 {
-    QList<QJsonObject> stack;
     if (!currentlyDebugging) {
-        return stack;
+        return {};
     }
 
     CORE_LOCK();
-    bool ret;
-    RVA addr = cmdRaw("dr SP").toULongLong(&ret, 16);
-    if (!ret) {
-        return stack;
+    if (!debugSnapshot.stackPointer) {
+        bool ret;
+        RVA addr = cmdRaw("dr SP").toULongLong(&ret, 16);
+        debugSnapshot.stackPointer = ret ? addr : RVA_INVALID;
+    }
+    RVA addr = *debugSnapshot.stackPointer;
+    if (addr == RVA_INVALID) {
+        return {};
     }
 
-    int base = r_config_get_i(core->config, "asm.bits");
-    for (int i = 0; i < size; i += base / 8) {
-        if ((base == 32 && addr + i >= UT32_MAX) || (base == 16 && addr + i >= UT16_MAX)) {
-            break;
-        }
-
-        stack.append(getAddrRefs(addr + i, depth));
+    // the window and the pointer after it in a single read
+    const int windowSize = size + int(sizeof(ut64));
+    if (debugSnapshot.stackAddr != addr || debugSnapshot.stackGeneration != getIOGeneration()
+        || debugSnapshot.stack.size() < windowSize) {
+        debugSnapshot.stack.resize(windowSize);
+        r_io_read_at(
+            core->io, addr, reinterpret_cast<ut8 *>(debugSnapshot.stack.data()), windowSize);
+        debugSnapshot.stackAddr = addr;
+        debugSnapshot.stackGeneration = getIOGeneration();
     }
 
-    return stack;
+    addressTelescope.sync(getIOGeneration());
+    return addressTelescope.stack(core, addr, debugSnapshot.stack, size, depth);
 }
 
 QJsonObject IaitoCore::getAddrRefs(RVA addr, int depth)
@@ -1732,7 +2007,14 @@ QJsonDocument IaitoCore::getProcessThreads(int pid)
 {
     if (-1 == pid) {
         // Return threads list of the currently debugged PID
-        return cmdj("dptj");
+        if (!currentlyDebugging) {
+            return cmdj("dptj");
+        }
+        CORE_LOCK();
+        if (!debugSnapshot.threads) {
+            debugSnapshot.threads = cmdj("dptj");
+        }
+        return *debugSnapshot.threads;
     } else {
         return cmdj("dptj " + QString::number(pid));
     }
@@ -1750,7 +2032,30 @@ QJsonDocument IaitoCore::getChildProcesses(int pid)
 
 QJsonDocument IaitoCore::getRegisterValues()
 {
-    return cmdj("drj");
+    if (!currentlyDebugging) {
+        return cmdj("drj");
+    }
+    CORE_LOCK();
+    if (!debugSnapshot.registerValues) {
+        debugSnapshot.registerValues = cmdj("drj");
+    }
+    return *debugSnapshot.registerValues;
+}
+
+QSet<QString> IaitoCore::getChangedRegisters()
+{
+    CORE_LOCK();
+    return debugSnapshot.changedRegisters(previousDebugSnapshot);
+}
+
+void IaitoCore::startDebugSnapshot()
+{
+    CORE_LOCK();
+    // keep the last stop the registers were shown at to compare with
+    if (debugSnapshot.hasRegisters()) {
+        previousDebugSnapshot = std::move(debugSnapshot);
+    }
+    debugSnapshot = DebugSnapshot();
 }
 
 QList<VariableDescription> IaitoCore::getVariables(RVA at)
@@ -1778,6 +2083,10 @@ QList<VariableDescription> IaitoCore::getVariables(RVA at)
 
 QVector<RegisterRefValueDescription> IaitoCore::getRegisterRefValues()
 {
+    CORE_LOCK();
+    if (currentlyDebugging && debugSnapshot.registerRefValues) {
+        return *debugSnapshot.registerRefValues;
+    }
     QJsonArray registerRefArray = cmdj("drrj").array();
     QVector<RegisterRefValueDescription> result;
 
@@ -1791,6 +2100,9 @@ QVector<RegisterRefValueDescription> IaitoCore::getRegisterRefValues()
 
         result.push_back(desc);
     }
+    if (currentlyDebugging) {
+        debugSnapshot.registerRefValues = result;
+    }
     return result;
 }
 
@@ -1801,16 +2113,18 @@ QString IaitoCore::getRegisterName(QString registerRole)
 
 RVA IaitoCore::getProgramCounterValue()
 {
-    bool ok;
-    if (currentlyDebugging) {
+    if (!currentlyDebugging) {
+        return RVA_INVALID;
+    }
+    CORE_LOCK();
+    if (!debugSnapshot.programCounter) {
+        bool ok;
         // Use cmd because cmdRaw would not work with inner command backticked
         // TODO: Risky command due to changes in API, search for something safer
         RVA addr = cmd("dr `drn PC`").toULongLong(&ok, 16);
-        if (ok) {
-            return addr;
-        }
+        debugSnapshot.programCounter = ok ? addr : RVA_INVALID;
     }
-    return RVA_INVALID;
+    return *debugSnapshot.programCounter;
 }
 
 void IaitoCore::setRegister(QString regName, QString regValue)
@@ -2356,9 +2670,8 @@ void IaitoCore::addBreakpoint(const BreakpointDescription &config)
                 - core->dbg->bp->bps_idx;
 
     breakpoint->enabled = config.enabled;
-    if (config.trace) {
-        setBreakpointTrace(index, config.trace);
-    }
+    // what dbite does, without notifying the breakpoint twice
+    breakpoint->trace = config.trace;
     if (!config.condition.isEmpty()) {
         updateOwnedCharPtr(breakpoint->cond, config.condition);
     }
@@ -2372,6 +2685,8 @@ void IaitoCore::updateBreakpoint(int index, const BreakpointDescription &config)
 {
     CORE_LOCK();
     if (auto bp = r_bp_get_index(core->dbg->bp, index)) {
+        // only the new address is notified
+        breakpointIndex.invalidateAt(bp->addr);
         r_bp_del(core->dbg->bp, bp->addr);
     }
     // Delete by index currently buggy,
@@ -2389,6 +2704,11 @@ void IaitoCore::delBreakpoint(RVA addr)
 void IaitoCore::delAllBreakpoints()
 {
     cmdRaw("db-*");
+    {
+        CORE_LOCK();
+        breakpointIndex.invalidate();
+        debugSnapshot.breakpoints.reset();
+    }
     emit refreshCodeViews();
 }
 
@@ -2411,6 +2731,16 @@ void IaitoCore::setBreakpointTrace(int index, bool enabled)
     } else {
         cmdRaw(QStringLiteral("dbitd %1").arg(index));
     }
+    RVA addr = RVA_INVALID;
+    {
+        CORE_LOCK();
+        if (auto bp = r_bp_get_index(core->dbg->bp, index)) {
+            addr = bp->addr;
+        }
+    }
+    if (addr != RVA_INVALID) {
+        emit breakpointsChanged(addr);
+    }
 }
 
 static BreakpointDescription breakpointDescriptionFromR2(int index, r_bp_item_t *bpi)
@@ -2453,6 +2783,9 @@ BreakpointDescription IaitoCore::getBreakpointAt(RVA addr)
 QList<BreakpointDescription> IaitoCore::getBreakpoints()
 {
     CORE_LOCK();
+    if (currentlyDebugging && debugSnapshot.breakpoints) {
+        return *debugSnapshot.breakpoints;
+    }
     QList<BreakpointDescription> ret;
     for (int i = 0; i < core->dbg->bp->bps_idx_count; i++) {
         RBreakpointItem *bpi = r_bp_get_index(core->dbg->bp, i);
@@ -2461,42 +2794,61 @@ QList<BreakpointDescription> IaitoCore::getBreakpoints()
         ret.push_back(breakpointDescriptionFromR2(i, bpi));
     }
 
+    if (currentlyDebugging) {
+        debugSnapshot.breakpoints = ret;
+    }
     return ret;
 }
 
 QList<RVA> IaitoCore::getBreakpointsAddresses()
 {
-    QList<RVA> bpAddresses;
-    for (const BreakpointDescription &bp : getBreakpoints()) {
-        bpAddresses << bp.addr;
-    }
+    CORE_LOCK();
+    return breakpointIndex.addresses(core);
+}
 
-    return bpAddresses;
+QList<RVA> IaitoCore::getBreakpointsInRange(RVA from, RVA to)
+{
+    CORE_LOCK();
+    return breakpointIndex.inRange(core, from, to);
 }
 
 QList<RVA> IaitoCore::getBreakpointsInFunction(RVA funcAddr)
 {
-    QList<RVA> allBreakpoints = getBreakpointsAddresses();
+    CORE_LOCK();
+    RAnalFunction *fcn = r_anal_get_function_at(core->anal, funcAddr);
+    if (!fcn) {
+        return {};
+    }
+    QList<RVA> rangeBreakpoints = breakpointIndex.inRange(
+        core, r_anal_function_min_addr(fcn), r_anal_function_max_addr(fcn));
     QList<RVA> functionBreakpoints;
 
     // Use std manipulations to take only the breakpoints that belong to this
-    // function
+    // function, functions may overlap
     std::copy_if(
-        allBreakpoints.begin(),
-        allBreakpoints.end(),
+        rangeBreakpoints.begin(),
+        rangeBreakpoints.end(),
         std::back_inserter(functionBreakpoints),
         [this, funcAddr](RVA BPadd) { return getFunctionStart(BPadd) == funcAddr; });
     return functionBreakpoints;
 }
 
-bool IaitoCore::isBreakpoint(const QList<RVA> &breakpoints, RVA addr)
+bool IaitoCore::isBreakpoint(RVA addr)
 {
-    return breakpoints.contains(addr);
+    CORE_LOCK();
+    return breakpointIndex.contains(core, addr);
 }
 
 QJsonDocument IaitoCore::getBacktrace()
 {
-    return cmdj("dbtj");
+    if (!currentlyDebugging) {
+        return cmdj("dbtj");
+    }
+    CORE_LOCK();
+    if (!debugSnapshot.backtrace) {
+        debugSnapshot.backtrace = cmdj("dbtj");
+    }
+    return *debugSnapshot.backtrace;
 }
 
 QList<ProcessDescription> IaitoCore::getAllProcesses()
@@ -2522,6 +2874,10 @@ QList<ProcessDescription> IaitoCore::getAllProcesses()
 
 QList<MemoryMapDescription> IaitoCore::getMemoryMap()
 {
+    CORE_LOCK();
+    if (currentlyDebugging && debugSnapshot.memoryMap) {
+        return *debugSnapshot.memoryMap;
+    }
     QList<MemoryMapDescription> ret;
     QJsonArray memoryMapArray = cmdj("dmj").array();
 
@@ -2540,6 +2896,9 @@ QList<MemoryMapDescription> IaitoCore::getMemoryMap()
         ret << memMap;
     }
 
+    if (currentlyDebugging) {
+        debugSnapshot.memoryMap = ret;
+    }
     return ret;
 }
 
@@ -2949,21 +3308,14 @@ QList<ExportDescription> IaitoCore::getAllExports()
     CORE_LOCK();
     QList<ExportDescription> ret;
 
-    QJsonArray exportsArray = cmdj("iEj").array();
-
-    for (const QJsonValue value : exportsArray) {
-        QJsonObject exportObject = value.toObject();
-
-        ExportDescription exp;
-
-        exp.vaddr = exportObject[RJsonKey::vaddr].toVariant().toULongLong();
-        exp.paddr = exportObject[RJsonKey::paddr].toVariant().toULongLong();
-        exp.size = exportObject[RJsonKey::size].toVariant().toULongLong();
-        exp.type = exportObject[RJsonKey::type].toString();
-        exp.name = exportObject[RJsonKey::name].toString();
-        exp.flag_name = exportObject[RJsonKey::flagname].toString();
-
-        ret << exp;
+    RListIter *it;
+    RBinSymbol *bs;
+    const RList *symbols = r_bin_get_symbols(core->bin);
+    IaitoRListForeach(symbols, it, RBinSymbol, bs)
+    {
+        if (r2native::isExport(bs)) {
+            ret << r2native::exportDescription(core, bs);
+        }
     }
 
     return ret;
@@ -3066,17 +3418,16 @@ QList<CommentDescription> IaitoCore::getAllComments(const QString &filterType)
     CORE_LOCK();
     QList<CommentDescription> ret;
 
-    QJsonArray commentsArray = cmdj("CCj").array();
-    for (const QJsonValue value : commentsArray) {
-        QJsonObject commentObject = value.toObject();
-
-        QString type = commentObject[RJsonKey::type].toString();
-        if (type != filterType)
+    RIntervalTreeIter it;
+    RAnalMetaItem *item;
+    r_interval_tree_foreach(&core->anal->meta, it, item)
+    {
+        if (filterType != QLatin1String(r_meta_type_to_string(item->type))) {
             continue;
-
+        }
         CommentDescription comment;
-        comment.offset = getOffsetOrAddr(commentObject);
-        comment.name = commentObject[RJsonKey::name].toString();
+        comment.offset = r_interval_tree_iter_get(&it)->start;
+        comment.name = r2native::toQString(item->str);
 
         ret << comment;
     }
@@ -3155,7 +3506,61 @@ QList<RelocDescription> IaitoCore::getAllRelocs()
 
 QList<StringDescription> IaitoCore::getAllStrings()
 {
-    return parseStringsJson(cmdjTask("izzj"));
+    QList<StringDescription> ret;
+    getAllStrings(INT_MAX, [&ret](const QList<StringDescription> &batch, qint64, qint64) {
+        ret << batch;
+        return true;
+    });
+    return ret;
+}
+
+bool IaitoCore::getAllStrings(
+    int batchSize,
+    const std::function<bool(const QList<StringDescription> &, qint64, qint64)> &callback)
+{
+    const quint64 generation = getIOGeneration();
+    RList *strings;
+    {
+        CORE_LOCK();
+        RBinFile *bf = r_bin_cur(core->bin);
+        if (!bf) {
+            return true;
+        }
+        // the list of "izz", with the bin.str.* settings and filters applied
+        strings = r_bin_raw_strings(bf, 0);
+    }
+    if (!strings) {
+        return true;
+    }
+
+    const qint64 total = r_list_length(strings);
+    qint64 done = 0;
+    bool complete = true;
+    RListIter *it = strings->head;
+    while (it) {
+        QList<StringDescription> batch;
+        batch.reserve(static_cast<int>(qMin<qint64>(batchSize, total - done)));
+        {
+            CORE_LOCK();
+            // the binary may have been closed or reloaded while the core was
+            // unlocked, the sections of the current one would not match
+            RBinFile *bf = r_bin_cur(core->bin);
+            if (!bf || getIOGeneration() != generation) {
+                complete = false;
+                break;
+            }
+            for (; it && batch.size() < batchSize; it = it->n) {
+                batch << r2native::stringDescription(bf->BO, static_cast<RBinString *>(it->data));
+            }
+        }
+        done += batch.size();
+        if (!callback(batch, done, total)) {
+            complete = false;
+            break;
+        }
+    }
+    r_list_free(strings);
+    return complete;
 }
 
 QList<StringDescription> IaitoCore::parseStringsJson(const QJsonDocument &doc)
@@ -3186,42 +3591,38 @@ QList<FlagspaceDescription> IaitoCore::getAllFlagspaces()
     CORE_LOCK();
     QList<FlagspaceDescription> ret;
 
-    QJsonArray flagspacesArray = cmdj("fsj").array();
-    for (const QJsonValue value : flagspacesArray) {
-        QJsonObject flagspaceObject = value.toObject();
-
+    RSpaceIter it;
+    RSpace *space;
+    r_flag_space_foreach(core->flags, it, space)
+    {
         FlagspaceDescription flagspace;
-
-        flagspace.name = flagspaceObject[RJsonKey::name].toString();
+        flagspace.name = r2native::toQString(space->name);
 
         ret << flagspace;
     }
     return ret;
 }
 
+static bool appendFlagDescription(RFlagItem *fi, void *user)
+{
+    static_cast<QList<FlagDescription> *>(user)->append(r2native::flagDescription(fi));
+    return true;
+}
+
 QList<FlagDescription> IaitoCore::getAllFlags(QString flagspace)
 {
     CORE_LOCK();
     QList<FlagDescription> ret;
 
-    if (!flagspace.isEmpty())
-        cmdRaw("fs " + flagspace);
-    else
-        cmdRaw("fs *");
-
-    QJsonArray flagsArray = cmdj("fj").array();
-    for (const QJsonValue value : flagsArray) {
-        QJsonObject flagObject = value.toObject();
-
-        FlagDescription flag;
-
-        flag.offset = getOffsetOrAddr(flagObject);
-        flag.size = flagObject[RJsonKey::size].toVariant().toULongLong();
-        flag.name = flagObject[RJsonKey::name].toString();
-        flag.realname = flagObject[RJsonKey::realname].toString();
-
-        ret << flag;
+    // a null space iterates over all the flags
+    const RSpace *space = nullptr;
+    if (!flagspace.isEmpty()) {
+        space = r_flag_space_get(core->flags, flagspace.toUtf8().constData());
+        if (!space) {
+            return ret;
+        }
     }
+    r_flag_foreach_space(core->flags, space, appendFlagDescription, &ret);
     return ret;
 }
 
@@ -3230,25 +3631,16 @@ QList<SectionDescription> IaitoCore::getAllSections()
     CORE_LOCK();
     QList<SectionDescription> sections;
 
-    QJsonDocument sectionsDoc = cmdj("iSj entropy");
-    QJsonObject sectionsObj = sectionsDoc.object();
-    QJsonArray sectionsArray = sectionsObj[RJsonKey::sections].toArray();
-
-    for (const QJsonValue value : sectionsArray) {
-        QJsonObject sectionObject = value.toObject();
-
-        QString name = sectionObject[RJsonKey::name].toString();
-        if (name.isEmpty())
+    RListIter *it;
+    RBinSection *bs;
+    const RList *binSections = r_bin_get_sections(core->bin);
+    IaitoRListForeach(binSections, it, RBinSection, bs)
+    {
+        if (bs->is_segment || R_STR_ISEMPTY(bs->name)) {
             continue;
-
-        SectionDescription section;
-        section.name = name;
-        section.vaddr = sectionObject[RJsonKey::vaddr].toVariant().toULongLong();
-        section.vsize = sectionObject[RJsonKey::vsize].toVariant().toULongLong();
-        section.paddr = sectionObject[RJsonKey::paddr].toVariant().toULongLong();
-        section.size = sectionObject[RJsonKey::size].toVariant().toULongLong();
-        section.perm = sectionObject[RJsonKey::perm].toString();
-        section.entropy = sectionObject[RJsonKey::entropy].toString();
+        }
+        SectionDescription section = r2native::sectionDescription(bs);
+        section.entropy = r2native::sectionEntropy(core, bs);
 
         sections << section;
     }
@@ -3260,9 +3652,14 @@ QStringList IaitoCore::getSectionList()
     CORE_LOCK();
     QStringList ret;
 
-    QJsonArray sectionsArray = cmdj("iSj").array();
-    for (const QJsonValue value : sectionsArray) {
-        ret << value.toObject()[RJsonKey::name].toString();
+    RListIter *it;
+    RBinSection *bs;
+    const RList *binSections = r_bin_get_sections(core->bin);
+    IaitoRListForeach(binSections, it, RBinSection, bs)
+    {
+        if (!bs->is_segment) {
+            ret << r2native::toQString(bs->name);
+        }
     }
     return ret;
 }
@@ -3272,24 +3669,15 @@ QList<SegmentDescription> IaitoCore::getAllSegments()
     CORE_LOCK();
     QList<SegmentDescription> ret;
 
-    QJsonArray segments = cmdj("iSSj").array();
-
-    for (const QJsonValue value : segments) {
-        QJsonObject segmentObject = value.toObject();
-
-        QString name = segmentObject[RJsonKey::name].toString();
-        if (name.isEmpty())
+    RListIter *it;
+    RBinSection *bs;
+    const RList *binSections = r_bin_get_sections(core->bin);
+    IaitoRListForeach(binSections, it, RBinSection, bs)
+    {
+        if (!bs->is_segment || R_STR_ISEMPTY(bs->name)) {
             continue;
-
-        SegmentDescription segment;
-        segment.name = name;
-        segment.vaddr = segmentObject[RJsonKey::vaddr].toVariant().toULongLong();
-        segment.paddr = segmentObject[RJsonKey::paddr].toVariant().toULongLong();
-        segment.size = segmentObject[RJsonKey::size].toVariant().toULongLong();
-        segment.vsize = segmentObject[RJsonKey::vsize].toVariant().toULongLong();
-        segment.perm = segmentObject[RJsonKey::perm].toString();
-
-        ret << segment;
+        }
+        ret << r2native::segmentDescription(bs);
     }
     return ret;
 }
@@ -3415,11 +3803,8 @@ QList<BinClassDescription> IaitoCore::getAllClassesFromFlags()
     QList<BinClassDescription> ret;
     QMap<QString, BinClassDescription *> classesCache;
 
-    QJsonArray flagsArray = cmdj("fj@F:classes").array();
-    for (const QJsonValue value : flagsArray) {
-        QJsonObject flagObject = value.toObject();
-
-        QString flagName = flagObject[RJsonKey::name].toString();
+    for (const FlagDescription &flag : getAllFlags(QStringLiteral("classes"))) {
+        const QString &flagName = flag.name;
 
         QRegularExpressionMatch match = classFlagRegExp.match(flagName);
         if (match.hasMatch()) {
@@ -3435,7 +3820,7 @@ QList<BinClassDescription> IaitoCore::getAllClassesFromFlags()
                 desc = it.value();
             }
             desc->name = match.captured(1);
-            desc->addr = getOffsetOrAddr(flagObject);
+            desc->addr = flag.offset;
             desc->index = RVA_INVALID;
             continue;
         }
@@ -3461,7 +3846,7 @@ QList<BinClassDescription> IaitoCore::getAllClassesFromFlags()
 
             BinClassMethodDescription meth;
             meth.name = match.captured(2);
-            meth.addr = getOffsetOrAddr(flagObject);
+            meth.addr = flag.offset;
             classDesc->methods << meth;
             continue;
         }
@@ -3804,6 +4189,7 @@ QString IaitoCore::addTypes(const char *str)
 
     r_anal_save_parsed_type(core->anal, parsed);
     r_mem_free(parsed);
+    emit typesChanged();
 
     if (error_msg) {
         error = error_msg;
@@ -3884,60 +4270,8 @@ QList<SearchDescription> IaitoCore::getAllSearch(QString search_for, QString spa
 
 BlockStatistics IaitoCore::getBlockStatistics(unsigned int blocksCount)
 {
-    BlockStatistics blockStats;
-    if (blocksCount == 0) {
-        blockStats.from = blockStats.to = blockStats.blocksize = 0;
-        return blockStats;
-    }
-
-    QJsonObject statsObj;
-
-    // User TempConfig here to set the search boundaries to all sections. This
-    // makes sure that the Visual Navbar will show all the relevant addresses.
-    {
-        TempConfig tempConfig;
-        tempConfig.set("search.in", "bin.sections");
-        statsObj = cmdj("p-j " + QString::number(blocksCount)).object();
-    }
-
-    blockStats.from = statsObj[RJsonKey::from].toVariant().toULongLong();
-    blockStats.to = statsObj[RJsonKey::to].toVariant().toULongLong();
-    blockStats.blocksize = statsObj[RJsonKey::blocksize].toVariant().toULongLong();
-
-    QJsonArray blocksArray = statsObj[RJsonKey::blocks].toArray();
-
-    for (const QJsonValue value : blocksArray) {
-        QJsonObject blockObj = value.toObject();
-
-        BlockDescription block;
-
-        block.addr = getOffsetOrAddr(blockObj);
-        block.size = blockObj[RJsonKey::size].toVariant().toULongLong();
-        block.flags = blockObj[RJsonKey::flags].toInt(0);
-        block.functions = blockObj[RJsonKey::functions].toInt(0);
-        block.inFunctions = blockObj[RJsonKey::in_functions].toInt(0);
-        block.comments = blockObj[RJsonKey::comments].toInt(0);
-        block.symbols = blockObj[RJsonKey::symbols].toInt(0);
-        block.strings = blockObj[RJsonKey::strings].toInt(0);
-
-        block.rwx = 0;
-        QString rwxStr = blockObj[RJsonKey::rwx].toString();
-        if (rwxStr.length() == 3) {
-            if (rwxStr[0] == 'r') {
-                block.rwx |= (1 << 0);
-            }
-            if (rwxStr[1] == 'w') {
-                block.rwx |= (1 << 1);
-            }
-            if (rwxStr[2] == 'x') {
-                block.rwx |= (1 << 2);
-            }
-        }
-
-        blockStats.blocks << block;
-    }
-
-    return blockStats;
+    CORE_LOCK();
+    return addressCoverage.statistics(core, blocksCount);
 }
 
 QList<XrefDescription> IaitoCore::getXRefsForVariable(
@@ -3972,11 +4306,171 @@ QList<XrefDescription> IaitoCore::getXRefsForVariable(
     return xrefList;
 }
 
+#if R2_VERSION_NUMBER >= 50809
+#ifndef R_ANAL_REF_TYPE_MASK
+#define R_ANAL_REF_TYPE_MASK(x) ((x) & 0xff)
+#endif
+
+static void appendCallees(RAnalFunction *fcn, QList<RVA> &callees)
+{
+    QSet<RVA> seen;
+    RVecAnalRef *refs = r_anal_function_get_refs(fcn);
+    if (!refs) {
+        return;
+    }
+    RAnalRef *ref;
+    R_VEC_FOREACH(refs, ref)
+    {
+        if (R_ANAL_REF_TYPE_MASK(ref->type) != R_ANAL_REF_TYPE_CALL) {
+            continue;
+        }
+        if (!seen.contains(ref->addr)) {
+            seen.insert(ref->addr);
+            callees << ref->addr;
+        }
+    }
+    RVecAnalRef_free(refs);
+}
+#endif
+
+QList<RVA> IaitoCore::getFunctionCallees(RVA addr)
+{
+    QList<RVA> callees;
+#if R2_VERSION_NUMBER >= 50809
+    CORE_LOCK();
+    // like agc, the function containing addr
+    RAnalFunction *fcn = r_anal_get_fcn_in(core->anal, addr, 0);
+    if (fcn) {
+        appendCallees(fcn, callees);
+    }
+#else
+    QJsonArray functions = cmdjAt("afij", addr).array();
+    if (functions.isEmpty()) {
+        return callees;
+    }
+    QJsonArray callrefs = functions.first().toObject()["callrefs"].toArray();
+    for (const QJsonValue value : callrefs) {
+        QJsonObject ref = value.toObject();
+        RVA target = ref[RJsonKey::addr].toVariant().toULongLong();
+        if (ref[RJsonKey::type].toString() == "CALL" && !callees.contains(target)) {
+            callees << target;
+        }
+    }
+#endif
+    return callees;
+}
+
+QList<RVA> IaitoCore::getFunctionCallers(RVA addr)
+{
+    QList<RVA> callers;
+#if R2_VERSION_NUMBER >= 50809
+    CORE_LOCK();
+    RVecAnalRef *refs = r_anal_xrefs_get(core->anal, addr);
+    if (!refs) {
+        return callers;
+    }
+    RAnalRef *ref;
+    R_VEC_FOREACH(refs, ref)
+    {
+        if (R_ANAL_REF_TYPE_MASK(ref->type) != R_ANAL_REF_TYPE_CALL) {
+            continue;
+        }
+        RAnalFunction *fcn = r_anal_get_fcn_in(core->anal, ref->at, 0);
+        if (fcn && !callers.contains(fcn->addr)) {
+            callers << fcn->addr;
+        }
+    }
+    RVecAnalRef_free(refs);
+#else
+    for (const XrefDescription &xref : getXRefs(addr, true, false, "CALL")) {
+        RAnalFunction *fcn = functionIn(xref.from);
+        if (fcn && !callers.contains(fcn->addr)) {
+            callers << fcn->addr;
+        }
+    }
+#endif
+    return callers;
+}
+
+QHash<RVA, QList<RVA>> IaitoCore::getGlobalCallGraph()
+{
+    CORE_LOCK();
+    QHash<RVA, QList<RVA>> graph;
+    graph.reserve(r_list_length(core->anal->fcns));
+
+    RListIter *iter;
+    RAnalFunction *fcn;
+    IaitoRListForeach(core->anal->fcns, iter, RAnalFunction, fcn)
+    {
+#if R2_VERSION_NUMBER >= 50809
+        appendCallees(fcn, graph[fcn->addr]);
+#else
+        graph[fcn->addr] = getFunctionCallees(fcn->addr);
+#endif
+    }
+    return graph;
+}
+
+QString IaitoCore::getCallGraphNodeName(RVA addr)
+{
+    CORE_LOCK();
+    RAnalFunction *fcn = r_anal_get_function_at(core->anal, addr);
+    if (fcn && fcn->name) {
+        return QString::fromUtf8(fcn->name);
+    }
+    RFlagItem *fi = r_flag_get_at(core->flags, addr, false);
+    if (fi && fi->name) {
+        return QString::fromUtf8(fi->name);
+    }
+    return RAddressString(addr);
+}
+
 QList<XrefDescription> IaitoCore::getXRefs(
     RVA addr, bool to, bool whole_function, const QString &filterType)
 {
     QList<XrefDescription> xrefList = QList<XrefDescription>();
 
+#if R2_VERSION_NUMBER >= 50809
+    CORE_LOCK();
+    RVecAnalRef *refs = to ? r_anal_xrefs_get(core->anal, addr) : r_anal_refs_get(core->anal, addr);
+    if (!refs) {
+        return xrefList;
+    }
+
+    RAnalRef *ref;
+    R_VEC_FOREACH(refs, ref)
+    {
+        XrefDescription xref;
+
+        xref.type = r2native::toQString(r_anal_ref_type_tostring(ref->type));
+
+        if (!filterType.isNull() && filterType != xref.type)
+            continue;
+
+        xref.from = ref->at;
+        if (!to) {
+            xref.from_str = RAddressString(xref.from);
+        } else {
+            RAnalFunction *fcn = functionIn(xref.from);
+            if (fcn && fcn->name) {
+                xref.from_str = QString::fromUtf8(fcn->name) + " + 0x"
+                                + QString::number(xref.from - fcn->addr, 16);
+            } else {
+                xref.from_str = RAddressString(xref.from);
+            }
+        }
+
+        if (!whole_function && !to && xref.from != addr) {
+            continue;
+        }
+
+        xref.to = ref->addr;
+        xref.to_str = r2native::flagWithDelta(core, xref.to);
+
+        xrefList << xref;
+    }
+    RVecAnalRef_free(refs);
+#else
     QJsonArray xrefsArray;
 
     if (to) {
@@ -4021,6 +4515,7 @@ QList<XrefDescription> IaitoCore::getXRefs(
 
         xrefList << xref;
     }
+#endif
 
     return xrefList;
 }
@@ -4116,6 +4611,20 @@ void IaitoCore::handleREvent(int type, void *data)
         emit classAttrsChanged(QString::fromUtf8(ev->attr.class_name));
         break;
     }
+    case R_EVENT_META_SET:
+    case R_EVENT_META_DEL: {
+        auto ev = reinterpret_cast<REventMeta *>(data);
+        if (ev->type == R_META_TYPE_COMMENT || ev->type == R_META_TYPE_ANY) {
+            invalidateComment(ev->addr);
+        }
+        CORE_LOCK();
+        addressCoverage.invalidateMeta(ev->addr);
+        break;
+    }
+    case R_EVENT_META_CLEAR:
+        invalidateCommentIndex();
+        invalidateAddressCoverage(AddressCoverage::Meta);
+        break;
     case R_EVENT_DEBUG_PROCESS_FINISHED: {
         auto ev = reinterpret_cast<REventDebugProcessFinished *>(data);
         emit debugProcessFinished(ev->pid);
@@ -4149,6 +4658,7 @@ void IaitoCore::loadPDB(const QString &file)
 void IaitoCore::openProject(const QString &name)
 {
     bool ok = cmdRaw0(QStringLiteral("'P ") + name); //  + "@e:scr.interactive=false");
+    invalidateCommentIndex();
     if (ok) {
         notes = QString::fromUtf8(QByteArray::fromBase64(cmdRaw("Pnj").toUtf8()));
     } else {
@@ -4194,12 +4704,31 @@ bool IaitoCore::isProjectNameValid(const QString &name)
 
 QList<DisassemblyLine> IaitoCore::disassembleLines(RVA offset, int lines)
 {
+    CORE_LOCK();
+    disassemblyCache.sync(getIOGeneration());
+    // asm.emu comments depend on the instructions emulated before, which
+    // differ with where the disassembly starts
+    const bool cacheable = !r_config_get_b(core->config, "asm.emu");
+    QList<DisassemblyLine> r;
+
+    // take as many instructions as possible from the cache
+    RVA addr = offset;
+    DisassemblyCache::Instruction instruction;
+    while (cacheable && r.size() < lines
+           && disassemblyCache.lines(addr, disassemblyProfile(addr), &instruction)) {
+        r << instruction.lines;
+        addr = instruction.next;
+    }
+    if (r.size() >= lines) {
+        return r.mid(0, lines);
+    }
+
     QJsonArray array = cmdj(
-                           QStringLiteral("pdJ ") + QString::number(lines) + QStringLiteral(" @ ")
-                           + QString::number(offset))
+                           QStringLiteral("pdJ ") + QString::number(lines - r.size())
+                           + QStringLiteral(" @ ") + QString::number(addr))
                            .array();
-    QList<DisassemblyLine> r;
 
+    instruction.lines.clear();
     for (const QJsonValueRef value : array) {
         QJsonObject object = value.toObject();
         DisassemblyLine line;
@@ -4209,6 +4738,21 @@ QList<DisassemblyLine> IaitoCore::disassembleLines(RVA offset, int lines)
         const auto &arrow = object[RJsonKey::arrow];
         line.arrow = arrow.isNull() ? RVA_INVALID : arrow.toVariant().toULongLong();
         r << line;
+
+        // all the lines of an address are complete once the next one starts,
+        // the last address may be cut by the line count and is not cached
+        if (!instruction.lines.isEmpty() && instruction.lines.first().offset != line.offset) {
+            RVA instructionAddr = instruction.lines.first().offset;
+            instruction.next = line.offset;
+            if (cacheable && instruction.next > instructionAddr) {
+                disassemblyCache.insertLines(
+                    instructionAddr, disassemblyProfile(instructionAddr), instruction);
+            } else {
+                disassemblyCache.insertBoundary(instructionAddr, instruction.next);
+            }
+            instruction.lines.clear();
+        }
+        instruction.lines << line;
     }
 
     return r;
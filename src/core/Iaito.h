@@ -1,9 +1,6 @@
 #ifndef IAITO_H
 #define IAITO_H
 
-#define MONOTHREAD 1
-// #define MONOTHREAD 0
-
 #include "common/BasicInstructionHighlighter.h"
 #include "core/IaitoCommon.h"
 #include "core/IaitoDescriptions.h"
@@ -11,22 +8,33 @@
 #include <QDebug>
 #include <QDir>
 #include <QErrorMessage>
+#include <QHash>
 #include <QJsonDocument>
 #include <QMap>
 #include <QMenu>
 #include <QMessageBox>
 #include <QMutex>
 #include <QObject>
+#include <QSet>
 #include <QStringList>
 
+#include <atomic>
+#include <functional>
+
 class AsyncTaskManager;
 class BasicInstructionHighlighter;
 class IaitoCore;
 class Decompiler;
 class R2Task;
 class R2TaskDialog;
+class RefreshScheduler;
 
 #include "common/BasicBlockHighlighter.h"
+#include "common/AddressCoverage.h"
+#include "common/AddressTelescope.h"
+#include "common/BreakpointIndex.h"
+#include "common/DebugSnapshot.h"
+#include "common/DisassemblyCache.h"
 #include "common/Helpers.h"
 #include "common/R2Task.h"
 #include "dialogs/R2TaskDialog.h"
@@ -70,6 +78,23 @@ public:
     QDir getIaitoRCDefaultDirectory() const;
 
     AsyncTaskManager *getAsyncTaskManager() { return asyncTaskManager; }
+    /**
+     * @brief Batches the refreshes of the widgets after refreshAll and the
+     * other change signals, see RefreshScheduler
+     */
+    RefreshScheduler *getRefreshScheduler() { return refreshScheduler; }
+
+    /**
+     * @brief Select between the monothread and the threaded execution mode.
+     * In threaded mode long running r2 work (strings, functions, decompiler,
+     * console commands, analysis) is run through the AsyncTaskManager and
+     * R2Task under the core lock and the results are delivered back to the
+     * widgets through queued signals. Monothread mode runs everything on the
+     * GUI thread and is the default.
+     * @note must be called before any file is loaded
+     */
+    void setThreadedMode(bool enabled) { threadedMode = enabled; }
+    bool isThreadedMode() const { return threadedMode; }
 
     RVA getOffset() const { return ADDRESS_OF(core_); }
 
@@ -153,6 +178,13 @@ public:
 
     QJsonDocument cmdj(const char *str);
     QJsonDocument cmdj(const QString &str) { return cmdj(str.toUtf8().constData()); }
+    /**
+     * @brief Output of \a str as printed by r2, without html, for the parsers
+     * working in place on the buffer
+     * @return a string to free with r_mem_free(), or nullptr
+     */
+    char *cmdStr(const char *str);
+    char *cmdStr(const QString &str) { return cmdStr(str.toUtf8().constData()); }
     QJsonDocument cmdjAt(const char *str, RVA address);
     QStringList cmdList(const char *str)
     {
@@ -282,6 +314,13 @@ public:
     /* Comments */
     void setComment(RVA addr, const QString &cmt);
     void delComment(RVA addr);
+    /**
+     * @brief Gets the comment at \a addr from the address to comment index.
+     * The index is built in a single pass over the RAnal meta data the first
+     * time it is needed and kept up to date through commentsChanged(RVA) and
+     * the r2 meta events, so it is cheap enough for model data() and sort
+     * comparisons.
+     */
     QString getCommentAt(RVA addr);
     void setImmediateBase(const QString &r2BaseName, RVA offset = RVA_INVALID);
     void setCurrentBits(int bits, RVA offset = RVA_INVALID);
@@ -348,6 +387,11 @@ public:
      */
     void seekAndShow(QString thing);
     RVA getOffset();
+    /**
+     * @brief Address of the instruction \a count instructions before or after
+     * \a startAddr. Boundaries already known from the disassembly cache are
+     * used before asking r2.
+     */
     RVA prevOpAddr(RVA startAddr, int count);
     RVA nextOpAddr(RVA startAddr, int count);
 
@@ -384,7 +428,19 @@ public:
     QByteArray assemble(const QString &code);
     QString disassemble(const QByteArray &data);
     QString disassembleSingleInstruction(RVA addr);
+    /**
+     * @brief Disassembles \a lines lines starting at \a offset like pdJ.
+     * Results are kept in a cache keyed by address and by the current asm
+     * configuration, so scrolling and repeated previews reuse them until the
+     * bytes, the analysis or the asm options change. Nothing is cached while
+     * asm.emu is enabled.
+     */
     QList<DisassemblyLine> disassembleLines(RVA offset, int lines);
+    /**
+     * @brief Records the size of an instruction of a basic block disassembled
+     * by other means (e.g. the graph) for prevOpAddr() and nextOpAddr()
+     */
+    void cacheInstructionSize(RVA addr, RVA size);
 
     static QByteArray hexStringToBytes(const QString &hex);
     static QString bytesToHexString(const QByteArray &bytes);
@@ -404,6 +460,11 @@ public:
     /* Debug */
     QJsonDocument getRegistersInfo();
     QJsonDocument getRegisterValues();
+    /**
+     * @brief Names of the registers changed since the previous debug stop
+     * their values were shown at
+     */
+    QSet<QString> getChangedRegisters();
     QString getRegisterName(QString registerRole);
     RVA getProgramCounterValue();
     void setRegister(QString regName, QString regValue);
@@ -417,7 +478,7 @@ public:
      * @param size number of bytes to scan
      * @param depth telescoping depth
      */
-    QList<QJsonObject> getStack(int size = 0x100, int depth = 6);
+    QList<TelescopeDescription> getStack(int size = 0x100, int depth = 6);
     /**
      * @brief Recursively dereferences pointers starting at the specified
      * address up to a given depth
@@ -480,8 +541,15 @@ public:
     int breakpointIndexAt(RVA addr);
     BreakpointDescription getBreakpointAt(RVA addr);
 
-    bool isBreakpoint(const QList<RVA> &breakpoints, RVA addr);
+    bool isBreakpoint(RVA addr);
+    /**
+     * @brief Sorted addresses of all the breakpoints
+     */
     QList<RVA> getBreakpointsAddresses();
+    /**
+     * @brief Sorted addresses of the breakpoints in [from, to)
+     */
+    QList<RVA> getBreakpointsInRange(RVA from, RVA to);
 
     /**
      * @brief Get all breakpoinst that are belong to a functions at this address
@@ -532,6 +600,26 @@ public:
     void loadPDB(const QString &file);
 
     QByteArray ioRead(RVA addr, int len);
+    /**
+     * @brief Counter incremented whenever the bytes visible through r_io may
+     * have changed: writes, io.cache and write mode switches, debugger stops,
+     * rebases and console commands. Caches of ioRead() results compare it to
+     * drop stale data.
+     */
+    quint64 getIOGeneration() const { return ioGeneration; }
+    void bumpIOGeneration() { ++ioGeneration; }
+    /**
+     * @brief Counter incremented whenever the analysis behind unchanged code
+     * may have changed: renames, variables, types, comments, functions, flags
+     * and patches. Caches of decompiled code compare it to drop stale results.
+     */
+    quint64 getAnalysisGeneration() const { return analysisGeneration; }
+    void bumpAnalysisGeneration() { ++analysisGeneration; }
+    /**
+     * @brief Drop what is cached about the session after a command typed in
+     * the console, which may change anything without any notification.
+     */
+    void consoleCommandExecuted();
 
     QList<RVA> getSeekHistory();
 
@@ -561,6 +649,19 @@ public:
     QList<CommentDescription> getAllComments(const QString &filterType);
     QList<RelocDescription> getAllRelocs();
     QList<StringDescription> getAllStrings();
+    /**
+     * @brief Enumerate the same strings as getAllStrings() in batches, so that
+     * callers can show the first strings before the whole table is converted.
+     * The core is only locked while a batch is being built, the enumeration
+     * stops if the IO generation moves meanwhile.
+     * @param batchSize maximum number of strings passed to each \a callback call
+     * @param callback receives a batch, the number of strings delivered so far
+     * and the total number of strings. Returning false stops the enumeration.
+     * @return false if the enumeration was stopped before the last string
+     */
+    bool getAllStrings(
+        int batchSize,
+        const std::function<bool(const QList<StringDescription> &, qint64, qint64)> &callback);
     QList<FlagspaceDescription> getAllFlagspaces();
     QList<FlagDescription> getAllFlags(QString flagspace = QString());
     QList<SectionDescription> getAllSections();
@@ -639,7 +740,7 @@ public:
      * @brief returns a list of reg values and their telescoped references
      * @param depth telescoping depth
      */
-    QList<QJsonObject> getRegisterRefs(int depth = 6);
+    QList<TelescopeDescription> getRegisterRefs(int depth = 6);
     QVector<RegisterRefValueDescription> getRegisterRefValues();
     QList<VariableDescription> getVariables(RVA at);
     /**
@@ -659,6 +760,26 @@ public:
     QList<XrefDescription> getXRefs(
         RVA addr, bool to, bool whole_function, const QString &filterType = QString());
 
+    /**
+     * @brief Targets of the calls made by the function at \a addr, in the order
+     * they are first called
+     */
+    QList<RVA> getFunctionCallees(RVA addr);
+    /**
+     * @brief Entry points of the functions calling the function at \a addr
+     */
+    QList<RVA> getFunctionCallers(RVA addr);
+    /**
+     * @brief Callees of every function, keyed by function address. Functions
+     * that don't call anything are included with an empty list.
+     */
+    QHash<RVA, QList<RVA>> getGlobalCallGraph();
+    /**
+     * @brief Label of \a addr in call graphs: the function or flag name, or the
+     * address itself
+     */
+    QString getCallGraphNodeName(RVA addr);
+
     QList<StringDescription> parseStringsJson(const QJsonDocument &doc);
 
     void handleREvent(int type, void *data);
@@ -717,6 +838,10 @@ signals:
 
     void functionRenamed(const RVA offset, const QString &new_name);
     void varsChanged();
+    /**
+     * @brief a type was added, changed or removed
+     */
+    void typesChanged();
     void functionsChanged();
     void flagsChanged();
     void commentsChanged(RVA addr);
@@ -796,12 +921,70 @@ private:
     void *coreBed = nullptr;
 
     AsyncTaskManager *asyncTaskManager;
+    RefreshScheduler *refreshScheduler;
     RVA offsetPriorDebugging = RVA_INVALID;
     QErrorMessage msgBox;
 
     QList<Decompiler *> decompilers;
 
     bool emptyGraph = false;
+    bool threadedMode = false;
+    std::atomic<quint64> ioGeneration{0};
+    std::atomic<quint64> analysisGeneration{0};
+
+    DisassemblyCache disassemblyCache;
+    /**
+     * @brief Hash of the configuration and of the hints affecting the
+     * disassembly text at \a addr. The configuration is hashed again after
+     * setConfig() or a console command, except for the asm.arch, asm.bits and
+     * asm.cpu values r2 switches by itself, which are read every time.
+     */
+    uint disassemblyProfile(RVA addr);
+    uint disassemblyProfileHash = 0;
+    bool disassemblyProfileValid = false;
+    void clearDisassemblyCache();
+
+    /**
+     * Address to comment index used by getCommentAt(). Protected by the core
+     * lock. Addresses in staleComments are looked up again on the next access.
+     */
+    QHash<RVA, QString> commentIndex;
+    QSet<RVA> staleComments;
+    bool commentIndexValid = false;
+    void buildCommentIndex();
+    void invalidateComment(RVA addr);
+    void invalidateCommentIndex();
+
+    /**
+     * Addresses of functions, flags, symbols and meta in the sections, used
+     * by getBlockStatistics(). Protected by the core lock.
+     */
+    AddressCoverage addressCoverage;
+    /**
+     * Telescoped stack and register references of the current debug stop,
+     * used by getStack() and getRegisterRefs(). Protected by the core lock.
+     */
+    AddressTelescope addressTelescope;
+    /**
+     * Registers, stack, backtrace, threads, maps and breakpoints of the
+     * current and of the previous debug stop, shared by the debug widgets.
+     * Protected by the core lock.
+     */
+    DebugSnapshot debugSnapshot;
+    DebugSnapshot previousDebugSnapshot;
+    void startDebugSnapshot();
+    /**
+     * Breakpoint addresses for isBreakpoint() and the range queries.
+     * Protected by the core lock.
+     */
+    BreakpointIndex breakpointIndex;
+    /**
+     * set while functionsChanged is emitted for a single known function
+     */
+    bool singleFunctionChanged = false;
+    void emitFunctionChangedAt(RVA addr);
+    void invalidateAddressCoverage(int sources);
+
     BasicBlockHighlighter *bbHighlighter;
     bool iocache = false;
     BasicInstructionHighlighter biHighlighter;
@@ -353,6 +353,17 @@ struct RefDescription
     QColor refColor;
 };
 
+/**
+ * @brief Stack slot or register and the references telescoped from its value
+ */
+struct TelescopeDescription
+{
+    RVA addr = RVA_INVALID; //!< stack slot, RVA_INVALID for registers
+    QString reg;            //!< register name, empty for stack slots
+    RVA value = 0;
+    RefDescription refDesc;
+};
+
 struct VariableDescription
 {
     enum class RefType { SP, BP, Reg };
@@ -1745,9 +1745,10 @@ void MainWindow::on_actionRefresh_Panels_triggered()
  */
 void MainWindow::on_actionAnalyze_triggered()
 {
-#if MONOTHREAD
-    R_LOG_ERROR("monothread for auto-reanalysis disabled");
-#else
+    if (!Core()->isThreadedMode()) {
+        R_LOG_ERROR("monothread for auto-reanalysis disabled");
+        return;
+    }
     InitialOptions options;
     options.analCmd = {{"aaa", "Auto analysis"}};
     auto *analTask = new AnalTask();
@@ -1760,7 +1761,6 @@ void MainWindow::on_actionAnalyze_triggered()
     connect(analTask, &AnalTask::finished, this, &MainWindow::refreshAll);
 
     Core()->getAsyncTaskManager()->start(analTaskPtr);
-#endif
 }
 
 void MainWindow::on_actionImportPDB_triggered()
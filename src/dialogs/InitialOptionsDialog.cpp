@@ -338,44 +338,46 @@ void InitialOptionsDialog::setupAndStartAnalysis(
         break;
     }
 
+    if (options.filename.endsWith("://") || options.filename == "") {
+        QMessageBox::warning(this, tr("Error"), tr("Please select a file"));
+        return;
+    }
+    if (options.filename.startsWith("malloc:")) {
+        options.loadBinInfo = false;
+    }
+    // Demangle (must be before file Core()->loadFile)
+    Core()->setConfig("bin.demangle", options.demangle);
+
     MainWindow *main = this->main;
-#if 0
-    AnalTask *analTask = new AnalTask();
-    analTask->setOptions(options);
-    connect(analTask, &AnalTask::openFileFailed, main, &MainWindow::openNewFileFailed);
-    connect(analTask, &AsyncTask::finished, main, [analTask, main]() {
-        if (analTask->getOpenFileFailed()) {
-            return;
-        }
-        main->finalizeOpen();
-    });
+    if (Core()->isThreadedMode()) {
+        AnalTask *analTask = new AnalTask();
+        analTask->setOptions(options);
+        connect(analTask, &AnalTask::openFileFailed, main, &MainWindow::openNewFileFailed);
+        connect(analTask, &AsyncTask::finished, main, [analTask, main]() {
+            if (analTask->getOpenFileFailed()) {
+                return;
+            }
+            main->finalizeOpen();
+        });
 
-    AsyncTask::Ptr analTaskPtr(analTask);
+        AsyncTask::Ptr analTaskPtr(analTask);
 
-    AsyncTaskDialog *taskDialog = new AsyncTaskDialog(analTaskPtr);
-    taskDialog->setInterruptOnClose(true);
-    taskDialog->setAttribute(Qt::WA_DeleteOnClose);
-    taskDialog->show();
+        AsyncTaskDialog *taskDialog = new AsyncTaskDialog(analTaskPtr);
+        taskDialog->setInterruptOnClose(true);
+        taskDialog->setAttribute(Qt::WA_DeleteOnClose);
+        taskDialog->show();
 
-    Core()->getAsyncTaskManager()->start(analTaskPtr);
-#endif
+        Core()->getAsyncTaskManager()->start(analTaskPtr);
+        done(0);
+        return;
+    }
 
-#if MONOTHREAD
     int perms = R_PERM_RX;
     if (options.writeEnabled) {
         perms |= R_PERM_W;
         emit Core() -> ioModeChanged();
     }
 
-    // Demangle (must be before file Core()->loadFile)
-    Core()->setConfig("bin.demangle", options.demangle);
-    if (options.filename.endsWith("://") || options.filename == "") {
-        QMessageBox::warning(this, tr("Error"), tr("Please select a file"));
-        return;
-    }
-    if (options.filename.startsWith("malloc:")) {
-        options.loadBinInfo = false;
-    }
     // Do not reload the file if already loaded
     // QJsonArray openedFiles = Core()->getOpenedFiles();
     // if (true)  { // !openedFiles.size() && options.filename.length()) {
@@ -435,7 +437,6 @@ void InitialOptionsDialog::setupAndStartAnalysis(
         }
         Core()->setConfig("esil.breakoninvalid", boi);
     }
-#endif
     main->finalizeOpen();
 }
 
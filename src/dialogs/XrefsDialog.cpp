@@ -141,15 +141,21 @@ void XrefsDialog::onToTreeWidgetItemSelectionChanged()
 
 void XrefsDialog::updatePreview(RVA addr)
 {
-    TempConfig tempConfig;
-    tempConfig.set("scr.html", true);
-    tempConfig.set("scr.color", COLOR_MODE_16M);
-    tempConfig.set("asm.lines", false);
-    tempConfig.set("asm.bytes", false);
-
-    // Use cmd because cmRaw cannot handle the output properly. Why?
-    QString disas = Core()->cmd("pd--20 @ " + QString::number(addr));
-    ui->previewTextEdit->document()->setHtml(disas);
+    // 20 instructions around addr like "pd--20", through the disassembly
+    // cache so that moving between xrefs of the same area is cheap
+    QList<DisassemblyLine> lines;
+    {
+        TempConfig tempConfig;
+        tempConfig.set("scr.color", COLOR_MODE_16M);
+        tempConfig.set("asm.lines", false);
+        tempConfig.set("asm.bytes", false);
+        lines = Core()->disassembleLines(Core()->prevOpAddr(addr, 20), 40);
+    }
+    QStringList disas;
+    for (const DisassemblyLine &line : lines) {
+        disas << line.text;
+    }
+    ui->previewTextEdit->document()->setHtml(disas.join(QStringLiteral("<br />")));
 
     // Does it make any sense?
     ui->previewTextEdit->find(normalizeAddr(RAddressString(addr)), QTextDocument::FindBackward);
@@ -81,6 +81,11 @@ AppearanceOptionsWidget::AppearanceOptionsWidget(PreferencesDialog *dialog)
     connect(ui->useDecompilerHighlighter, &QCheckBox::toggled, this, [](bool checked) {
         Config()->enableDecompilerAnnotationHighlighter(checked);
     });
+
+    ui->threadedModeCheckBox->setChecked(Config()->getThreadedModeEnabled());
+    connect(ui->threadedModeCheckBox, &QCheckBox::toggled, this, [](bool checked) {
+        Config()->setThreadedModeEnabled(checked);
+    });
 }
 
 AppearanceOptionsWidget::~AppearanceOptionsWidget() {}
@@ -1,5 +1,6 @@
 #include "DecompilerContextMenu.h"
 #include "MainWindow.h"
+#include "common/CodeAnnotationIndex.h"
 #include "common/Configuration.h"
 #include "dialogs/BreakpointsDialog.h"
 #include "dialogs/CommentsDialog.h"
@@ -81,6 +82,16 @@ void DecompilerContextMenu::setAnnotationHere(RCodeMetaItem *annotation)
     annotationHere = annotation;
 }
 
+void DecompilerContextMenu::setAnnotationIndex(const CodeAnnotationIndex *index)
+{
+    annotationIndex = index;
+}
+
+void DecompilerContextMenu::setAnnotationsAt(size_t pos)
+{
+    annotationHere = annotationIndex ? annotationIndex->annotationAt(pos) : nullptr;
+}
+
 void DecompilerContextMenu::setCurHighlightedWord(QString word)
 {
     curHighlightedWord = word;
@@ -7,6 +7,7 @@
 #include <QMenu>
 
 class MainWindow;
+class CodeAnnotationIndex;
 
 class DecompilerContextMenu : public QMenu
 {
@@ -18,6 +19,15 @@ public:
 
     bool getIsTogglingBreakpoints();
     void setAnnotationHere(RCodeMetaItem *annotation);
+    /**
+     * @brief Share the index of the annotations of the decompiled code
+     */
+    void setAnnotationIndex(const CodeAnnotationIndex *index);
+    /**
+     * @brief Set annotationHere to the context-related annotation covering
+     * \a pos in the decompiled code, or to nullptr
+     */
+    void setAnnotationsAt(size_t pos);
     RVA getFirstOffsetInLine();
 
 signals:
@@ -82,6 +92,7 @@ private:
      * widget. If such an annotation doesn't exist, its value is nullptr.
      */
     RCodeMetaItem *annotationHere;
+    const CodeAnnotationIndex *annotationIndex = nullptr;
 
     // Actions and menus in the context menu
     QAction actionCopy;
@@ -1,6 +1,7 @@
 #include "BacktraceWidget.h"
 #include "QHeaderView"
 #include "common/JsonModel.h"
+#include "common/RefreshScheduler.h"
 #include "ui_BacktraceWidget.h"
 
 #include "core/MainWindow.h"
@@ -27,8 +28,8 @@ BacktraceWidget::BacktraceWidget(MainWindow *main)
 
     refreshDeferrer = createRefreshDeferrer([this]() { updateContents(); });
 
-    connect(Core(), &IaitoCore::refreshAll, this, &BacktraceWidget::updateContents);
-    connect(Core(), &IaitoCore::registersChanged, this, &BacktraceWidget::updateContents);
+    Core()->getRefreshScheduler()->subscribe(
+        this, RefreshScheduler::Registers, &BacktraceWidget::updateContents);
     connect(Config(), &Configuration::fontsUpdated, this, &BacktraceWidget::fontsUpdatedSlot);
 }
 
@@ -1,5 +1,6 @@
 #include "widgets/BinariesWidget.h"
 #include "common/Helpers.h"
+#include "common/RefreshScheduler.h"
 #include <QAbstractItemView>
 #include <QFileDialog>
 #include <QHBoxLayout>
@@ -52,7 +53,8 @@ BinariesWidget::BinariesWidget(MainWindow *main)
     mainLayout->addLayout(openLayout);
 
     setWidget(container);
-    connect(Core(), &IaitoCore::refreshAll, this, &BinariesWidget::loadBinaries);
+    Core()->getRefreshScheduler()->subscribe(
+        this, RefreshScheduler::Nothing, &BinariesWidget::loadBinaries);
     loadBinaries();
 }
 
@@ -1,5 +1,6 @@
 #include "BreakpointWidget.h"
 #include "common/Helpers.h"
+#include "common/RefreshScheduler.h"
 #include "core/MainWindow.h"
 #include "dialogs/BreakpointsDialog.h"
 #include "ui_BreakpointWidget.h"
@@ -214,10 +215,10 @@ BreakpointWidget::BreakpointWidget(MainWindow *main)
     contextMenu->addAction(actionToggleBreakpoint);
     contextMenu->addAction(actionDelBreakpoint);
 
-    connect(Core(), &IaitoCore::refreshAll, this, &BreakpointWidget::refreshBreakpoint);
-    connect(Core(), &IaitoCore::breakpointsChanged, this, &BreakpointWidget::refreshBreakpoint);
-    connect(Core(), &IaitoCore::codeRebased, this, &BreakpointWidget::refreshBreakpoint);
-    connect(Core(), &IaitoCore::refreshCodeViews, this, &BreakpointWidget::refreshBreakpoint);
+    Core()->getRefreshScheduler()->subscribe(
+        this,
+        RefreshScheduler::Breakpoints | RefreshScheduler::Rebased | RefreshScheduler::CodeViews,
+        &BreakpointWidget::refreshBreakpoint);
     connect(Core(), &IaitoCore::commentsChanged, this, [this]() {
         qhelpers::emitColumnChanged(breakpointModel, BreakpointModel::CommentColumn);
     });
@@ -1,11 +1,9 @@
 #include "CallGraph.h"
+#include "common/Configuration.h"
+#include "common/RefreshScheduler.h"
 
 #include "MainWindow.h"
 
-#include <QJsonArray>
-#include <QJsonObject>
-#include <QJsonValue>
-
 CallGraphWidget::CallGraphWidget(MainWindow *main, bool global)
     : AddressableDockWidget(main)
     , graphView(new CallGraphView(this, main, global))
@@ -36,11 +34,28 @@ CallGraphView::CallGraphView(IaitoDockWidget *parent, MainWindow *main, bool glo
     : SimpleTextGraphView(parent, main)
     , global(global)
     , refreshDeferrer(nullptr, this)
+    , actionExpandCallees(tr("Expand callees"), this)
+    , actionExpandCallers(tr("Expand callers"), this)
 {
     enableAddresses(true);
     refreshDeferrer.registerFor(parent);
     connect(&refreshDeferrer, &RefreshDeferrer::refreshNow, this, &CallGraphView::refreshView);
-    connect(Core(), &IaitoCore::refreshAll, this, &SimpleTextGraphView::refreshView);
+    Core()->getRefreshScheduler()->subscribe(
+        this, RefreshScheduler::Nothing, [this]() { refreshView(); });
+
+    if (!global) {
+        addressableItemContextMenu.insertSeparator(addressableItemContextMenu.actions().first());
+        addressableItemContextMenu.insertAction(
+            addressableItemContextMenu.actions().first(), &actionExpandCallers);
+        addressableItemContextMenu.insertAction(
+            addressableItemContextMenu.actions().first(), &actionExpandCallees);
+        connect(&actionExpandCallees, &QAction::triggered, this, [this]() {
+            expand(expandedCallees);
+        });
+        connect(&actionExpandCallers, &QAction::triggered, this, [this]() {
+            expand(expandedCallers);
+        });
+    }
 }
 
 void CallGraphView::showExportDialog()
@@ -57,14 +72,23 @@ void CallGraphView::showExportDialog()
 void CallGraphView::showAddress(RVA address)
 {
     if (global) {
-        auto addressMappingIt = addressMapping.find(address);
-        if (addressMappingIt != addressMapping.end()) {
-            selectBlockWithId(addressMappingIt->second);
-            showBlock(blocks[addressMappingIt->second]);
+        // blocks are identified by the address of their function
+        auto blockIt = blocks.find(address);
+        if (blockIt != blocks.end()) {
+            selectBlockWithId(address);
+            showBlock(blockIt->second);
+        }
+    } else {
+        // the graph and its expansions belong to the function, not the seek
+        if (RAnalFunction *function = Core()->functionIn(address)) {
+            address = function->addr;
+        }
+        if (address != this->address) {
+            this->address = address;
+            expandedCallees.clear();
+            expandedCallers.clear();
+            refreshView();
         }
-    } else if (address != this->address) {
-        this->address = address;
-        refreshView();
     }
 }
 
@@ -81,55 +105,116 @@ void CallGraphView::loadCurrentGraph()
     blockContent.clear();
     blocks.clear();
 
-    QJsonDocument functionsDoc = Core()->cmdj(
-        global ? "agCj" : QStringLiteral("agcj @ %1").arg(address));
-    auto nodes = functionsDoc.array();
+    if (global) {
+        loadGlobalGraph();
+    } else {
+        loadFunctionGraph();
+    }
 
-    QHash<QString, uint64_t> idMapping;
+    computeGraphPlacement();
+}
 
-    auto getId = [&](const QString &name) -> uint64_t {
-        auto nextId = idMapping.size();
-        auto &itemId = idMapping[name];
-        if (idMapping.size() != nextId) {
-            itemId = nextId;
+void CallGraphView::loadGlobalGraph()
+{
+    QHash<RVA, QList<RVA>> callGraph = Core()->getGlobalCallGraph();
+    std::unordered_map<RVA, GraphLayout::GraphBlock> layoutBlocks;
+    layoutBlocks.reserve(callGraph.size());
+
+    for (auto it = callGraph.constBegin(); it != callGraph.constEnd(); ++it) {
+        GraphLayout::GraphBlock &block = layoutBlocks[it.key()];
+        block.entry = it.key();
+        for (RVA callee : it.value()) {
+            block.edges.emplace_back(callee);
+            // imports and other call targets without a function
+            layoutBlocks[callee].entry = callee;
         }
-        return itemId;
+    }
+    for (auto &it : layoutBlocks) {
+        addBlock(std::move(it.second), Core()->getCallGraphNodeName(it.first), it.first);
+    }
+}
+
+void CallGraphView::loadFunctionGraph()
+{
+    std::unordered_map<RVA, GraphLayout::GraphBlock> layoutBlocks;
+    auto node = [&](RVA addr) -> GraphLayout::GraphBlock & {
+        GraphLayout::GraphBlock &block = layoutBlocks[addr];
+        block.entry = addr;
+        return block;
     };
 
-    for (const QJsonValueRef value : nodes) {
-        QJsonObject block = value.toObject();
-        QString name = block["name"].toVariant().toString();
-
-        auto edges = block["imports"].toArray();
-        GraphLayout::GraphBlock layoutBlock;
-        layoutBlock.entry = getId(name);
-        for (auto edge : edges) {
-            auto targetName = edge.toString();
-            auto targetId = getId(targetName);
-            layoutBlock.edges.emplace_back(targetId);
+    // same as agc by default: the function and the functions it calls, the
+    // nodes expanded from the context menu add their callees or callers down
+    // to getCallGraphExpandDepth() levels
+    struct Pending
+    {
+        RVA addr;
+        int calleeLevels;
+        int callerLevels;
+    };
+    const int depth = std::max(Config()->getCallGraphExpandDepth(), 1);
+    QList<Pending> pending = {{address, 1, 0}};
+    QHash<RVA, QPair<int, int>> walked;
+    QSet<QPair<RVA, RVA>> edges;
+    auto edge = [&](RVA from, RVA to) {
+        if (!edges.contains(qMakePair(from, to))) {
+            edges.insert(qMakePair(from, to));
+            node(from).edges.emplace_back(to);
         }
-
-        // it would be good if address came directly from json instead of having
-        // to lookup by name
-        addBlock(std::move(layoutBlock), name, Core()->num(name));
-    }
-    for (auto it = idMapping.begin(), end = idMapping.end(); it != end; ++it) {
-        if (blocks.find(it.value()) == blocks.end()) {
-            GraphLayout::GraphBlock block;
-            block.entry = it.value();
-            addBlock(std::move(block), it.key(), Core()->num(it.key()));
+        node(to);
+    };
+    while (!pending.isEmpty()) {
+        Pending current = pending.takeFirst();
+        const RVA addr = current.addr;
+        if (expandedCallees.contains(addr)) {
+            current.calleeLevels = std::max(current.calleeLevels, depth);
+        }
+        if (expandedCallers.contains(addr)) {
+            current.callerLevels = std::max(current.callerLevels, depth);
+        }
+        // walk a node again only when reached with more levels to go
+        QPair<int, int> &levels = walked[addr];
+        if (levels.first >= current.calleeLevels && levels.second >= current.callerLevels) {
+            continue;
+        }
+        levels.first = std::max(levels.first, current.calleeLevels);
+        levels.second = std::max(levels.second, current.callerLevels);
+        node(addr);
+        if (current.calleeLevels > 0) {
+            for (RVA callee : Core()->getFunctionCallees(addr)) {
+                edge(addr, callee);
+                pending.append({callee, current.calleeLevels - 1, 0});
+            }
+        }
+        if (current.callerLevels > 0) {
+            for (RVA caller : Core()->getFunctionCallers(addr)) {
+                edge(caller, addr);
+                pending.append({caller, 0, current.callerLevels - 1});
+            }
         }
     }
-    if (blockContent.empty() && !global) {
-        addBlock({}, RAddressString(address), address);
+
+    for (auto &it : layoutBlocks) {
+        addBlock(std::move(it.second), Core()->getCallGraphNodeName(it.first), it.first);
     }
+}
 
-    addressMapping.clear();
-    for (auto &it : blockContent) {
-        addressMapping[it.second.address] = it.first;
+void CallGraphView::expand(QSet<RVA> &expanded)
+{
+    if (menuAddress == RVA_INVALID || expanded.contains(menuAddress)) {
+        return;
     }
+    expanded.insert(menuAddress);
+    refreshView();
+}
 
-    computeGraphPlacement();
+void CallGraphView::blockContextMenuRequested(
+    GraphView::GraphBlock &block, QContextMenuEvent *event, QPoint pos)
+{
+    menuAddress = block.entry;
+    actionExpandCallees.setEnabled(!expandedCallees.contains(block.entry));
+    actionExpandCallers.setEnabled(!expandedCallers.contains(block.entry));
+    SimpleTextGraphView::blockContextMenuRequested(block, event, pos);
 }
 
 void CallGraphView::restoreCurrentBlock()
@@ -6,6 +6,9 @@
 #include "core/Iaito.h"
 #include "widgets/SimpleTextGraphView.h"
 
+#include <QAction>
+#include <QSet>
+
 class MainWindow;
 /**
  * @brief Graphview displaying either global or function callgraph.
@@ -22,13 +25,24 @@ public:
 protected:
     bool global;               ///< is this a global or function callgraph
     RVA address = RVA_INVALID; ///< function address if this is not a global callgraph
-    std::unordered_map<RVA, ut64> addressMapping; ///< mapping from addresses to block id
     void loadCurrentGraph() override;
     void restoreCurrentBlock() override;
+    void blockContextMenuRequested(
+        GraphView::GraphBlock &block, QContextMenuEvent *event, QPoint pos) override;
 
 private:
     RefreshDeferrer refreshDeferrer;
     RVA lastLoadedAddress = RVA_INVALID;
+
+    QAction actionExpandCallees;
+    QAction actionExpandCallers;
+    RVA menuAddress = RVA_INVALID; ///< block the context menu was opened for
+    QSet<RVA> expandedCallees;     ///< nodes whose callees are shown as well
+    QSet<RVA> expandedCallers;     ///< nodes whose callers are shown as well
+
+    void loadGlobalGraph();
+    void loadFunctionGraph();
+    void expand(QSet<RVA> &expanded);
 };
 
 class CallGraphWidget : public AddressableDockWidget
@@ -1,5 +1,6 @@
 #include "ClassesWidget.h"
 #include "common/Helpers.h"
+#include "common/RefreshScheduler.h"
 #include "common/SvgIconEngine.h"
 #include "core/MainWindow.h"
 #include "dialogs/EditMethodDialog.h"
@@ -218,8 +219,8 @@ AnalClassesModel::AnalClassesModel(IaitoDockWidget *parent)
     // background, simply refresh everything later.
     refreshDeferrer = parent->createRefreshDeferrer([this]() { this->refreshAll(); });
 
-    connect(Core(), &IaitoCore::refreshAll, this, &AnalClassesModel::refreshAll);
-    connect(Core(), &IaitoCore::codeRebased, this, &AnalClassesModel::refreshAll);
+    Core()->getRefreshScheduler()->subscribe(
+        this, RefreshScheduler::Rebased, &AnalClassesModel::refreshAll);
     connect(Core(), &IaitoCore::classNew, this, &AnalClassesModel::classNew);
     connect(Core(), &IaitoCore::classDeleted, this, &AnalClassesModel::classDeleted);
     connect(Core(), &IaitoCore::classRenamed, this, &AnalClassesModel::classRenamed);
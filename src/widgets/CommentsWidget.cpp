@@ -1,5 +1,6 @@
 #include "CommentsWidget.h"
 #include "common/Helpers.h"
+#include "common/RefreshScheduler.h"
 #include "core/MainWindow.h"
 #include "ui_ListDockWidget.h"
 
@@ -258,9 +259,8 @@ CommentsWidget::CommentsWidget(MainWindow *main)
     this->setContextMenuPolicy(Qt::CustomContextMenu);
     connect(this, &QWidget::customContextMenuRequested, this, &CommentsWidget::showTitleContextMenu);
 
-    connect(Core(), &IaitoCore::codeRebased, this, &CommentsWidget::refreshTree);
-    connect(Core(), &IaitoCore::commentsChanged, this, &CommentsWidget::refreshTree);
-    connect(Core(), &IaitoCore::refreshAll, this, &CommentsWidget::refreshTree);
+    Core()->getRefreshScheduler()->subscribe(
+        this, RefreshScheduler::Comments | RefreshScheduler::Rebased, &CommentsWidget::refreshTree);
 }
 
 CommentsWidget::~CommentsWidget() {}
@@ -0,0 +1,458 @@
+#include "ConsoleOutputView.h"
+#include "common/Configuration.h"
+
+#include <QApplication>
+#include <QClipboard>
+#include <QKeyEvent>
+#include <QMouseEvent>
+#include <QPainter>
+#include <QScrollBar>
+
+#include <algorithm>
+
+static constexpr int MARGIN = 10;
+
+namespace {
+
+/**
+ * @brief Parts covering the columns [from, from + count) of a line
+ */
+RichTextPainter::List sliced(const RichTextPainter::List &parts, int from, int count)
+{
+    RichTextPainter::List r;
+    int column = 0;
+    for (const auto &part : parts) {
+        const int length = part.text.size();
+        if (column + length > from) {
+            const int start = std::max(from - column, 0);
+            auto slice = part;
+            slice.text = part.text.mid(start, std::min(length, from + count - column) - start);
+            r.push_back(slice);
+        }
+        column += length;
+        if (column >= from + count) {
+            break;
+        }
+    }
+    return r;
+}
+
+} // namespace
+
+ConsoleOutputView::ConsoleOutputView(QWidget *parent)
+    : QAbstractScrollArea(parent)
+{
+    setFocusPolicy(Qt::StrongFocus);
+    viewport()->setCursor(Qt::IBeamCursor);
+    setMonospaceFont(font());
+    setLineWrap(true);
+    updateColors();
+    connect(Config(), &Configuration::colorsUpdated, this, &ConsoleOutputView::updateColors);
+}
+
+ConsoleOutputView::~ConsoleOutputView() {}
+
+void ConsoleOutputView::setMonospaceFont(const QFont &font)
+{
+    setFont(font);
+    fontMetrics.reset(new CachedFontMetrics<qreal>(font));
+    charWidth = std::max(fontMetrics->width(QLatin1Char('F')), qreal(1));
+    lineHeight = std::max(fontMetrics->height(), qreal(1));
+    updateScrollBars();
+    viewport()->update();
+}
+
+void ConsoleOutputView::setLimits(int maxLines, qint64 maxBytes)
+{
+    buffer.setLimits(maxLines, maxBytes);
+    updateScrollBars();
+    viewport()->update();
+}
+
+void ConsoleOutputView::updateColors()
+{
+    backgroundColor = Config()->getColor("gui.background");
+    viewport()->update();
+}
+
+void ConsoleOutputView::appendOutput(const QByteArray &output)
+{
+    // Keep showing the same lines if older ones are dropped
+    const quint64 oldFirst = buffer.firstLine();
+    const int top = verticalScrollBar()->value();
+    buffer.append(output);
+    const quint64 dropped = buffer.firstLine() - oldFirst;
+    updateScrollBars();
+    verticalScrollBar()->setValue(top - int(std::min(dropped, quint64(top))));
+    viewport()->update();
+}
+
+void ConsoleOutputView::clear()
+{
+    buffer.clear();
+    anchor = cursor = {buffer.firstLine(), 0};
+    widestLine = 0;
+    visibleLines.clear();
+    updateScrollBars();
+    viewport()->update();
+}
+
+void ConsoleOutputView::setLineWrap(bool wrap)
+{
+    wrapLines = wrap;
+    setHorizontalScrollBarPolicy(wrap ? Qt::ScrollBarAlwaysOff : Qt::ScrollBarAsNeeded);
+    horizontalScrollBar()->setValue(0);
+    updateScrollBars();
+    viewport()->update();
+}
+
+void ConsoleOutputView::scrollToEnd()
+{
+    verticalScrollBar()->setValue(verticalScrollBar()->maximum());
+}
+
+int ConsoleOutputView::columnsPerRow() const
+{
+    return std::max(int((viewport()->width() - 2 * MARGIN) / charWidth), 1);
+}
+
+int ConsoleOutputView::rowsPerPage() const
+{
+    return std::max(int(viewport()->height() / lineHeight), 1);
+}
+
+int ConsoleOutputView::rowCount(int length, int columns) const
+{
+    return wrapLines ? std::max((length + columns - 1) / columns, 1) : 1;
+}
+
+int ConsoleOutputView::rowCount(quint64 number) const
+{
+    return wrapLines ? rowCount(buffer.plainText(number).size(), columnsPerRow()) : 1;
+}
+
+int ConsoleOutputView::lastTopLine() const
+{
+    const int count = buffer.lineCount();
+    const int pageRows = rowsPerPage();
+    if (!wrapLines) {
+        return std::max(count - pageRows, 0);
+    }
+    // Only the lines of the last page are measured
+    quint64 top = buffer.endLine();
+    int rows = 0;
+    while (top > buffer.firstLine()) {
+        rows += rowCount(top - 1);
+        if (rows > pageRows) {
+            break;
+        }
+        top--;
+    }
+    return std::max(std::min(int(top - buffer.firstLine()), count - 1), 0);
+}
+
+void ConsoleOutputView::updateScrollBars()
+{
+    const int pageRows = rowsPerPage();
+    verticalScrollBar()->setRange(0, lastTopLine());
+    verticalScrollBar()->setPageStep(pageRows);
+    verticalScrollBar()->setSingleStep(1);
+
+    const int width = viewport()->width();
+    const int textWidth = wrapLines ? 0 : int(widestLine * charWidth) + 2 * MARGIN;
+    horizontalScrollBar()->setRange(0, std::max(textWidth - width, 0));
+    horizontalScrollBar()->setPageStep(width);
+    horizontalScrollBar()->setSingleStep(int(charWidth));
+}
+
+void ConsoleOutputView::resizeEvent(QResizeEvent *event)
+{
+    QAbstractScrollArea::resizeEvent(event);
+    updateScrollBars();
+}
+
+void ConsoleOutputView::scrollContentsBy(int dx, int dy)
+{
+    Q_UNUSED(dx);
+    Q_UNUSED(dy);
+    // The vertical scroll bar counts lines, not pixels
+    viewport()->update();
+}
+
+void ConsoleOutputView::paintEvent(QPaintEvent *event)
+{
+    QPainter painter(viewport());
+    painter.setFont(font());
+    painter.fillRect(event->rect(), backgroundColor);
+
+    visibleLines.clear();
+    const int columns = columnsPerRow();
+    const int width = viewport()->width();
+    const int height = viewport()->height();
+    const qreal xOffset = wrapLines ? 0 : horizontalScrollBar()->value();
+    const int firstColumn = int(xOffset / charWidth);
+    const int visibleColumns = int(width / charWidth) + 2;
+    int widest = widestLine;
+
+    qreal y = 0;
+    quint64 number = buffer.firstLine() + verticalScrollBar()->value();
+    for (; number < buffer.endLine() && y < height; number++) {
+        const ConsoleBuffer::Line line = buffer.line(number);
+        const int length = line.plainText.size();
+        const VisibleLine visible = {number, y, rowCount(length, columns), length};
+        visibleLines.push_back(visible);
+        drawSelection(painter, visible, columns, xOffset);
+
+        if (wrapLines) {
+            for (int row = 0; row < visible.rows && y < height; row++) {
+                RichTextPainter::paintRichText<qreal>(
+                    &painter,
+                    MARGIN,
+                    y,
+                    width - MARGIN,
+                    lineHeight,
+                    0,
+                    sliced(line.parts, row * columns, columns),
+                    fontMetrics.get());
+                y += lineHeight;
+            }
+        } else {
+            const qreal x = MARGIN + firstColumn * charWidth - xOffset;
+            RichTextPainter::paintRichText<qreal>(
+                &painter,
+                x,
+                y,
+                width - x,
+                lineHeight,
+                0,
+                sliced(line.parts, firstColumn, visibleColumns),
+                fontMetrics.get());
+            y += lineHeight;
+        }
+        widest = std::max(widest, length);
+    }
+
+    if (!wrapLines && widest > widestLine) {
+        widestLine = widest;
+        updateScrollBars();
+    }
+}
+
+void ConsoleOutputView::selectionRange(Position &start, Position &end) const
+{
+    start = std::min(anchor, cursor);
+    end = std::max(anchor, cursor);
+    if (start.line < buffer.firstLine()) {
+        start = {buffer.firstLine(), 0};
+    }
+}
+
+bool ConsoleOutputView::hasSelection() const
+{
+    Position start;
+    Position end;
+    selectionRange(start, end);
+    return start < end;
+}
+
+void ConsoleOutputView::drawSelection(
+    QPainter &painter, const VisibleLine &line, int columns, qreal xOffset)
+{
+    Position start;
+    Position end;
+    selectionRange(start, end);
+    if (!(start < end) || line.number < start.line || line.number > end.line) {
+        return;
+    }
+    const int from = line.number == start.line ? start.column : 0;
+    // Past the end of the line when the line break is selected too
+    const int to = line.number == end.line ? end.column : line.length + 1;
+    const QColor color = palette().highlight().color();
+    if (!wrapLines) {
+        const qreal x = MARGIN + from * charWidth - xOffset;
+        painter.fillRect(QRectF(x, line.y, (to - from) * charWidth, lineHeight), color);
+        return;
+    }
+    for (int row = 0; row < line.rows; row++) {
+        const int rowFrom = std::max(from, row * columns);
+        const int rowTo = std::min(to, (row + 1) * columns + (row + 1 == line.rows ? 1 : 0));
+        if (rowFrom >= rowTo) {
+            continue;
+        }
+        const qreal x = MARGIN + (rowFrom - row * columns) * charWidth;
+        const qreal y = line.y + row * lineHeight;
+        painter.fillRect(QRectF(x, y, (rowTo - rowFrom) * charWidth, lineHeight), color);
+    }
+}
+
+ConsoleOutputView::Position ConsoleOutputView::positionAt(const QPoint &pos) const
+{
+    if (visibleLines.empty()) {
+        return {buffer.firstLine(), 0};
+    }
+    if (pos.y() < 0) {
+        return {visibleLines.front().number, 0};
+    }
+    const int columns = columnsPerRow();
+    const qreal xOffset = wrapLines ? 0 : horizontalScrollBar()->value();
+    const int column = std::max(qRound((pos.x() - MARGIN + xOffset) / charWidth), 0);
+    for (const VisibleLine &line : visibleLines) {
+        if (pos.y() >= line.y + line.rows * lineHeight) {
+            continue;
+        }
+        if (!wrapLines) {
+            return {line.number, std::min(column, line.length)};
+        }
+        const int row = std::max(int((pos.y() - line.y) / lineHeight), 0);
+        return {line.number, std::min(row * columns + std::min(column, columns), line.length)};
+    }
+    const VisibleLine &last = visibleLines.back();
+    return {last.number, last.length};
+}
+
+QString ConsoleOutputView::selectedText() const
+{
+    Position start;
+    Position end;
+    selectionRange(start, end);
+    if (!(start < end)) {
+        return QString();
+    }
+    QStringList lines;
+    const quint64 last = std::min(end.line, buffer.endLine() - 1);
+    for (quint64 number = start.line; number <= last; number++) {
+        const QString text = buffer.plainText(number);
+        const int from = number == start.line ? start.column : 0;
+        const int to = number == end.line ? end.column : text.size();
+        lines << text.mid(from, to - from);
+    }
+    return lines.join(QLatin1Char('\n'));
+}
+
+void ConsoleOutputView::copy()
+{
+    if (hasSelection()) {
+        QApplication::clipboard()->setText(selectedText());
+    }
+}
+
+void ConsoleOutputView::selectAll()
+{
+    if (buffer.isEmpty()) {
+        return;
+    }
+    const quint64 last = buffer.endLine() - 1;
+    anchor = {buffer.firstLine(), 0};
+    cursor = {last, int(buffer.plainText(last).size())};
+    viewport()->update();
+}
+
+bool ConsoleOutputView::find(const QString &text, bool backward)
+{
+    Position start;
+    Position end;
+    selectionRange(start, end);
+    quint64 number = buffer.endLine();
+    int column = 0;
+    if (start < end) {
+        number = start.line;
+        column = backward ? start.column : start.column + 1;
+    }
+    if (!buffer.find(text, Qt::CaseInsensitive, backward, number, column)) {
+        return false;
+    }
+    anchor = {number, column};
+    cursor = {number, column + int(text.size())};
+    ensureVisible(cursor);
+    viewport()->update();
+    return true;
+}
+
+void ConsoleOutputView::ensureVisible(const Position &position)
+{
+    const int pageRows = rowsPerPage();
+    const quint64 top = buffer.firstLine() + verticalScrollBar()->value();
+    int rows = 0;
+    if (position.line >= top) {
+        for (quint64 number = top; number <= position.line && rows <= pageRows; number++) {
+            rows += rowCount(number);
+        }
+    }
+    if (position.line < top || rows > pageRows) {
+        // Show the line in the middle of the page
+        quint64 newTop = position.line;
+        rows = rowCount(newTop);
+        while (newTop > buffer.firstLine() && rows < pageRows / 2) {
+            rows += rowCount(--newTop);
+        }
+        verticalScrollBar()->setValue(int(newTop - buffer.firstLine()));
+    }
+
+    if (!wrapLines) {
+        widestLine = std::max(widestLine, int(buffer.plainText(position.line).size()));
+        updateScrollBars();
+        const int x = int(position.column * charWidth);
+        const int width = viewport()->width() - 2 * MARGIN;
+        QScrollBar *bar = horizontalScrollBar();
+        if (x < bar->value() || x > bar->value() + width) {
+            bar->setValue(x - width / 2);
+        }
+    }
+}
+
+void ConsoleOutputView::mousePressEvent(QMouseEvent *event)
+{
+    if (event->button() != Qt::LeftButton) {
+        QAbstractScrollArea::mousePressEvent(event);
+        return;
+    }
+    cursor = positionAt(event->pos());
+    if (!(event->modifiers() & Qt::ShiftModifier)) {
+        anchor = cursor;
+    }
+    selecting = true;
+    viewport()->update();
+}
+
+void ConsoleOutputView::mouseMoveEvent(QMouseEvent *event)
+{
+    if (!selecting) {
+        return;
+    }
+    // Scroll when dragging past the edges
+    if (event->pos().y() < 0) {
+        verticalScrollBar()->triggerAction(QAbstractSlider::SliderSingleStepSub);
+    } else if (event->pos().y() > viewport()->height()) {
+        verticalScrollBar()->triggerAction(QAbstractSlider::SliderSingleStepAdd);
+    }
+    cursor = positionAt(event->pos());
+    viewport()->update();
+}
+
+void ConsoleOutputView::mouseReleaseEvent(QMouseEvent *event)
+{
+    if (event->button() != Qt::LeftButton || !selecting) {
+        QAbstractScrollArea::mouseReleaseEvent(event);
+        return;
+    }
+    selecting = false;
+    QClipboard *clipboard = QApplication::clipboard();
+    if (clipboard->supportsSelection() && hasSelection()) {
+        clipboard->setText(selectedText(), QClipboard::Selection);
+    }
+}
+
+void ConsoleOutputView::keyPressEvent(QKeyEvent *event)
+{
+    if (event->matches(QKeySequence::Copy)) {
+        copy();
+    } else if (event->matches(QKeySequence::SelectAll)) {
+        selectAll();
+    } else if (event->matches(QKeySequence::MoveToStartOfDocument)) {
+        verticalScrollBar()->setValue(0);
+    } else if (event->matches(QKeySequence::MoveToEndOfDocument)) {
+        scrollToEnd();
+    } else {
+        QAbstractScrollArea::keyPressEvent(event);
+    }
+}
@@ -0,0 +1,117 @@
+#ifndef CONSOLEOUTPUTVIEW_H
+#define CONSOLEOUTPUTVIEW_H
+
+#include "common/CachedFontMetrics.h"
+#include "common/ConsoleBuffer.h"
+#include "core/IaitoCommon.h"
+
+#include <QAbstractScrollArea>
+
+#include <memory>
+#include <vector>
+
+/**
+ * @brief Read-only view of a ConsoleBuffer, painting only the lines on screen.
+ *
+ * The vertical scroll bar counts lines, so nothing depends on the height of
+ * the lines above the first one shown. When wrapping, the number of rows of a
+ * line follows from its length as the font is monospace.
+ */
+class IAITO_EXPORT ConsoleOutputView : public QAbstractScrollArea
+{
+    Q_OBJECT
+
+public:
+    explicit ConsoleOutputView(QWidget *parent = nullptr);
+    ~ConsoleOutputView() override;
+
+    void setMonospaceFont(const QFont &font);
+    void setLimits(int maxLines, qint64 maxBytes);
+
+    /**
+     * @brief Append raw command output, colored with ANSI escapes
+     */
+    void appendOutput(const QByteArray &output);
+    void appendText(const QString &text) { appendOutput(text.toUtf8()); }
+
+    bool lineWrap() const { return wrapLines; }
+    void setLineWrap(bool wrap);
+
+    /**
+     * @brief Select the next match of \a text after the selection, or the
+     * previous one before it, and scroll to it
+     * @return false if there is none
+     */
+    bool find(const QString &text, bool backward = false);
+
+    bool hasSelection() const;
+    QString selectedText() const;
+
+public slots:
+    void clear();
+    void copy();
+    void selectAll();
+    void scrollToEnd();
+    void updateColors();
+
+protected:
+    void paintEvent(QPaintEvent *event) override;
+    void resizeEvent(QResizeEvent *event) override;
+    void scrollContentsBy(int dx, int dy) override;
+    void mousePressEvent(QMouseEvent *event) override;
+    void mouseMoveEvent(QMouseEvent *event) override;
+    void mouseReleaseEvent(QMouseEvent *event) override;
+    void keyPressEvent(QKeyEvent *event) override;
+
+private:
+    struct Position
+    {
+        quint64 line;
+        int column;
+
+        bool operator<(const Position &other) const
+        {
+            return line != other.line ? line < other.line : column < other.column;
+        }
+        bool operator==(const Position &other) const
+        {
+            return line == other.line && column == other.column;
+        }
+    };
+
+    struct VisibleLine
+    {
+        quint64 number;
+        qreal y;
+        int rows;
+        int length;
+    };
+
+    ConsoleBuffer buffer;
+    std::unique_ptr<CachedFontMetrics<qreal>> fontMetrics;
+    qreal charWidth = 1;
+    qreal lineHeight = 1;
+    QColor backgroundColor;
+    bool wrapLines = true;
+    /** longest line painted so far, in columns, for the horizontal scroll bar */
+    int widestLine = 0;
+    Position anchor = {0, 0};
+    Position cursor = {0, 0};
+    bool selecting = false;
+    /** lines of the last paint, to map mouse positions */
+    std::vector<VisibleLine> visibleLines;
+
+    int columnsPerRow() const;
+    int rowsPerPage() const;
+    int rowCount(int length, int columns) const;
+    int rowCount(quint64 number) const;
+    /** greatest first line shown, relative to the first line of the buffer */
+    int lastTopLine() const;
+    void updateScrollBars();
+    Position positionAt(const QPoint &pos) const;
+    void selectionRange(Position &start, Position &end) const;
+    void drawSelection(QPainter &painter, const VisibleLine &line, int columns, qreal xOffset);
+    void ensureVisible(const Position &position);
+};
+
+#endif // CONSOLEOUTPUTVIEW_H
@@ -2,12 +2,15 @@
 #include "WidgetShortcuts.h"
 #include "common/Helpers.h"
 #include "common/SvgIconEngine.h"
+#include "common/TempConfig.h"
 #include "core/Iaito.h"
 #include "ui_ConsoleWidget.h"
 #include <iostream>
 #include <QAction>
+#include <QApplication>
 #include <QCompleter>
 #include <QDir>
+#include <QInputDialog>
 #include <QMenu>
 #include <QScrollBar>
 #include <QSettings>
@@ -55,10 +58,7 @@ ConsoleWidget::ConsoleWidget(MainWindow *main)
     ui->debugeeInputLineEdit->setTextMargins(10, 0, 0, 0);
 
     setupFont();
-
-    // Adjust text margins of consoleOutputTextEdit
-    QTextDocument *console_docu = ui->outputTextEdit->document();
-    console_docu->setDocumentMargin(10);
+    ui->outputView->setLimits(Config()->getConsoleMaxLines(), Config()->getConsoleMaxBytes());
 
     // Ctrl+` and ';' to toggle console widget
     QAction *toggleConsole = toggleViewAction();
@@ -73,7 +73,7 @@ ConsoleWidget::ConsoleWidget(MainWindow *main)
     });
 
     QAction *actionClear = new QAction(tr("Clear Output"), this);
-    connect(actionClear, &QAction::triggered, ui->outputTextEdit, &QPlainTextEdit::clear);
+    connect(actionClear, &QAction::triggered, ui->outputView, &ConsoleOutputView::clear);
     addAction(actionClear);
 
     // Ctrl+l to clear the output
@@ -81,7 +81,34 @@ ConsoleWidget::ConsoleWidget(MainWindow *main)
     actionClear->setShortcutContext(Qt::WidgetWithChildrenShortcut);
     actions.append(actionClear);
 
-    actionWrapLines = new QAction(tr("Wrap Lines"), ui->outputTextEdit);
+    QAction *actionCopy = new QAction(tr("Copy"), this);
+    connect(actionCopy, &QAction::triggered, ui->outputView, &ConsoleOutputView::copy);
+    actions.append(actionCopy);
+
+    // Ctrl+F to search the output, F3 and Shift+F3 for the next and previous
+    // matches
+    QAction *actionFind = new QAction(tr("Find..."), this);
+    actionFind->setShortcut(QKeySequence::Find);
+    actionFind->setShortcutContext(Qt::WidgetWithChildrenShortcut);
+    connect(actionFind, &QAction::triggered, this, [this]() { findOutput(false, true); });
+    addAction(actionFind);
+    actions.append(actionFind);
+
+    QAction *actionFindNext = new QAction(tr("Find Next"), this);
+    actionFindNext->setShortcut(QKeySequence::FindNext);
+    actionFindNext->setShortcutContext(Qt::WidgetWithChildrenShortcut);
+    connect(actionFindNext, &QAction::triggered, this, [this]() { findOutput(false); });
+    addAction(actionFindNext);
+    actions.append(actionFindNext);
+
+    QAction *actionFindPrevious = new QAction(tr("Find Previous"), this);
+    actionFindPrevious->setShortcut(QKeySequence::FindPrevious);
+    actionFindPrevious->setShortcutContext(Qt::WidgetWithChildrenShortcut);
+    connect(actionFindPrevious, &QAction::triggered, this, [this]() { findOutput(true); });
+    addAction(actionFindPrevious);
+    actions.append(actionFindPrevious);
+
+    actionWrapLines = new QAction(tr("Wrap Lines"), ui->outputView);
     actionWrapLines->setCheckable(true);
     setWrap(QSettings().value(consoleWrapSettingsKey, true).toBool());
     connect(actionWrapLines, &QAction::triggered, this, [this](bool checked) { setWrap(checked); });
@@ -99,9 +126,9 @@ ConsoleWidget::ConsoleWidget(MainWindow *main)
     updateCompletion();
 
     // Set console output context menu
-    ui->outputTextEdit->setContextMenuPolicy(Qt::CustomContextMenu);
+    ui->outputView->setContextMenuPolicy(Qt::CustomContextMenu);
     connect(
-        ui->outputTextEdit,
+        ui->outputView,
         &QWidget::customContextMenuRequested,
         this,
         &ConsoleWidget::showCustomContextMenu);
@@ -186,19 +213,21 @@ QWidget *ConsoleWidget::widgetToFocusOnRaise()
 
 void ConsoleWidget::setupFont()
 {
-    ui->outputTextEdit->setFont(Config()->getFont());
+    ui->outputView->setMonospaceFont(Config()->getFont());
 }
 
 void ConsoleWidget::addOutput(const QString &msg)
 {
-    ui->outputTextEdit->appendPlainText(msg);
+    ui->outputView->appendText(msg);
     scrollOutputToEnd();
 }
 
 void ConsoleWidget::addDebugOutput(const QString &msg)
 {
     if (debugOutputEnabled) {
-        ui->outputTextEdit->appendHtml("<font color=\"red\"> [DEBUG]:\t" + msg + "</font>");
+        const QByteArray red = "\x1b[31m";
+        const QByteArray text = msg.toUtf8().replace('\n', "\n" + red);
+        ui->outputView->appendOutput(red + " [DEBUG]:\t" + text + "\x1b[0m");
         scrollOutputToEnd();
     }
 }
@@ -208,16 +237,20 @@ void ConsoleWidget::focusInputLineEdit()
     ui->r2InputLineEdit->setFocus();
 }
 
-void ConsoleWidget::removeLastLine()
+void ConsoleWidget::findOutput(bool backward, bool askText)
 {
-    ui->outputTextEdit->setFocus();
-    QTextCursor cur = ui->outputTextEdit->textCursor();
-    ui->outputTextEdit->moveCursor(QTextCursor::End, QTextCursor::MoveAnchor);
-    ui->outputTextEdit->moveCursor(QTextCursor::StartOfLine, QTextCursor::MoveAnchor);
-    ui->outputTextEdit->moveCursor(QTextCursor::End, QTextCursor::KeepAnchor);
-    ui->outputTextEdit->textCursor().removeSelectedText();
-    ui->outputTextEdit->textCursor().deletePreviousChar();
-    ui->outputTextEdit->setTextCursor(cur);
+    if (askText || findText.isEmpty()) {
+        bool ok = false;
+        const QString text = QInputDialog::getText(
+            this, tr("Find"), tr("Find in the output:"), QLineEdit::Normal, findText, &ok);
+        if (!ok || text.isEmpty()) {
+            return;
+        }
+        findText = text;
+    }
+    if (!ui->outputView->find(findText, backward)) {
+        QApplication::beep();
+    }
 }
 
 void ConsoleWidget::executeCommand(const QString &command)
@@ -226,7 +259,7 @@ void ConsoleWidget::executeCommand(const QString &command)
         return;
     }
     if (command == "clear" || command == "cls") {
-        ui->outputTextEdit->clear();
+        ui->outputView->clear();
         this->clear();
         return;
     }
@@ -237,31 +270,39 @@ void ConsoleWidget::executeCommand(const QString &command)
 
     RVA oldOffset = Core()->getOffset();
     bool isPiped = command.contains(">");
-#if MONOTHREAD
-    QString result;
-    if (isPiped) {
-        result = Core()->cmd(command.toStdString().c_str());
-    } else {
-        result = Core()->cmdHtml(command.toStdString().c_str());
-    }
-    if (oldOffset != Core()->getOffset()) {
-        Core()->updateSeek();
+    // The output is kept with its ANSI escapes, colors are parsed when painted
+    const CommandTask::ColorMode colorMode = isPiped ? CommandTask::ColorMode::DISABLED
+                                                     : CommandTask::ColorMode::MODE_256;
+    if (!Core()->isThreadedMode()) {
+        char *result;
+        {
+            TempConfig tempConfig;
+            tempConfig.set("scr.color", colorMode);
+            result = Core()->cmdStr(command);
+        }
+        Core()->consoleCommandExecuted();
+        if (oldOffset != Core()->getOffset()) {
+            Core()->updateSeek();
+        }
+        if (result) {
+            ui->outputView->appendOutput(QByteArray::fromRawData(result, int(strlen(result))));
+            r_mem_free(result);
+        }
+        scrollOutputToEnd();
+        historyAdd(command);
+        commandTask.clear();
+        ui->r2InputLineEdit->setEnabled(true);
+        ui->r2InputLineEdit->setFocus();
+        return;
     }
-    ui->outputTextEdit->appendHtml(result);
-    scrollOutputToEnd();
-    historyAdd(command);
-    commandTask.clear();
-    ui->r2InputLineEdit->setEnabled(true);
-    ui->r2InputLineEdit->setFocus();
-#else
-    commandTask = QSharedPointer<CommandTask>(
-        new CommandTask(command, CommandTask::ColorMode::MODE_256, true));
+    commandTask = QSharedPointer<CommandTask>(new CommandTask(command, colorMode));
     connect(
         commandTask.data(),
         &CommandTask::finished,
         this,
         [this, cmd_line, command, oldOffset](const QString &result) {
-            ui->outputTextEdit->appendHtml(result);
+            Core()->consoleCommandExecuted();
+            ui->outputView->appendText(result);
             scrollOutputToEnd();
             historyAdd(command);
             commandTask.clear();
@@ -271,10 +312,10 @@ void ConsoleWidget::executeCommand(const QString &command)
             if (oldOffset != Core()->getOffset()) {
                 Core()->updateSeek();
             }
-        });
+        },
+        Qt::QueuedConnection);
 
     Core()->getAsyncTaskManager()->start(commandTask);
-#endif
 }
 
 void ConsoleWidget::sendToStdin(const QString &input)
@@ -313,7 +354,7 @@ void ConsoleWidget::setWrap(bool wrap)
 {
     QSettings().setValue(consoleWrapSettingsKey, wrap);
     actionWrapLines->setChecked(wrap);
-    ui->outputTextEdit->setLineWrapMode(wrap ? QPlainTextEdit::WidgetWidth : QPlainTextEdit::NoWrap);
+    ui->outputView->setLineWrap(wrap);
 }
 
 void ConsoleWidget::on_r2InputLineEdit_returnPressed()
@@ -343,11 +384,11 @@ void ConsoleWidget::on_execButton_clicked()
 
 void ConsoleWidget::showCustomContextMenu(const QPoint &pt)
 {
-    actionWrapLines->setChecked(ui->outputTextEdit->lineWrapMode() == QPlainTextEdit::WidgetWidth);
+    actionWrapLines->setChecked(ui->outputView->lineWrap());
 
-    QMenu *menu = new QMenu(ui->outputTextEdit);
+    QMenu *menu = new QMenu(ui->outputView);
     menu->addActions(actions);
-    menu->exec(ui->outputTextEdit->mapToGlobal(pt));
+    menu->exec(ui->outputView->mapToGlobal(pt));
     menu->deleteLater();
 }
 
@@ -432,8 +473,7 @@ void ConsoleWidget::clear()
 
 void ConsoleWidget::scrollOutputToEnd()
 {
-    const int maxValue = ui->outputTextEdit->verticalScrollBar()->maximum();
-    ui->outputTextEdit->verticalScrollBar()->setValue(maxValue);
+    ui->outputView->scrollToEnd();
 }
 
 void ConsoleWidget::historyAdd(const QString &input)
@@ -454,18 +494,19 @@ void ConsoleWidget::invalidateHistoryPosition()
 
 void ConsoleWidget::processQueuedOutput()
 {
-    // Partial lines are ignored since carriage return is currently unsupported
+    // Partial lines are left in the pipe until they are complete. The console
+    // keeps the last segment of the lines overwritten by carriage returns.
+    QByteArray output;
     while (pipeSocket->canReadLine()) {
-        QString output = QString(pipeSocket->readLine());
+        const QByteArray line = pipeSocket->readLine();
 
         if (origStderr) {
-            fprintf(origStderr, "%s", output.toStdString().c_str());
+            fprintf(origStderr, "%s", line.constData());
         }
-
-        // Get the last segment that wasn't overwritten by carriage return
-        output = output.trimmed();
-        output = output.remove(0, output.lastIndexOf('\r')).trimmed();
-        ui->outputTextEdit->appendHtml(IaitoCore::ansiEscapeToHtml(output));
+        output += line;
+    }
+    if (!output.isEmpty()) {
+        ui->outputView->appendOutput(output);
         scrollOutputToEnd();
     }
 }
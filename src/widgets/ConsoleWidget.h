@@ -74,7 +74,11 @@ private:
     void scrollOutputToEnd();
     void historyAdd(const QString &input);
     void invalidateHistoryPosition();
-    void removeLastLine();
+    /**
+     * @brief Select the next or previous match of findText in the output
+     * @param askText ask for the text to look for first
+     */
+    void findOutput(bool backward, bool askText = false);
     void executeCommand(const QString &command);
     void sendToStdin(const QString &input);
     void setWrap(bool wrap);
@@ -94,6 +98,7 @@ private:
     int maxHistoryEntries;
     int lastHistoryPosition;
     QStringList history;
+    QString findText;
     bool completionActive;
     QStringListModel completionModel;
     QCompleter *completer;
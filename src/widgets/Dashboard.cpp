@@ -2,6 +2,7 @@
 #include "common/Helpers.h"
 #include "common/JsonModel.h"
 #include "common/JsonTreeItem.h"
+#include "common/RefreshScheduler.h"
 #include "common/TempConfig.h"
 #include "dialogs/VersionInfoDialog.h"
 #include "ui_Dashboard.h"
@@ -27,7 +28,8 @@ Dashboard::Dashboard(MainWindow *main)
 {
     ui->setupUi(this);
 
-    connect(Core(), &IaitoCore::refreshAll, this, &Dashboard::updateContents);
+    Core()->getRefreshScheduler()->subscribe(
+        this, RefreshScheduler::Nothing, &Dashboard::updateContents);
 }
 
 Dashboard::~Dashboard() {}
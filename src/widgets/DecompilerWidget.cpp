@@ -3,24 +3,30 @@
 #include "ui_DecompilerWidget.h"
 
 #include "common/Configuration.h"
+#include "common/DecompileAllTask.h"
 #include "common/Decompiler.h"
 #include "common/DecompilerHighlighter.h"
 #include "common/Helpers.h"
 #include "common/IaitoSeekable.h"
+#include "common/RefreshScheduler.h"
 #include "common/SelectionHighlight.h"
 #include "common/TempConfig.h"
 #include "core/MainWindow.h"
 
+#include "dialogs/AsyncTaskDialog.h"
 #include "dialogs/ShortcutKeysDialog.h"
 #include <QAbstractSlider>
 #include <QClipboard>
 #include <QKeyEvent>
+#include <QMessageBox>
 #include <QObject>
 #include <QPlainTextEdit>
+#include <QPushButton>
 #include <QScrollBar>
 #include <QTextBlock>
 #include <QTextBlockUserData>
 #include <QTextEdit>
+#include <QTimer>
 
 DecompilerWidget::DecompilerWidget(MainWindow *main)
     : MemoryDockWidget(MemoryWidgetType::Decompiler, main)
@@ -52,6 +58,7 @@ DecompilerWidget::DecompilerWidget(MainWindow *main)
     connect(Config(), &Configuration::colorsUpdated, this, &DecompilerWidget::colorsUpdatedSlot);
     connect(Core(), &IaitoCore::registersChanged, this, &DecompilerWidget::highlightPC);
     connect(mCtxMenu, &DecompilerContextMenu::copy, this, &DecompilerWidget::copy);
+    mCtxMenu->setAnnotationIndex(&annotationIndex);
 
     refreshDeferrer = createRefreshDeferrer([this]() { doRefresh(); });
 
@@ -91,19 +98,29 @@ DecompilerWidget::DecompilerWidget(MainWindow *main)
     connect(Core(), &IaitoCore::breakpointsChanged, this, &DecompilerWidget::updateBreakpoints);
     mCtxMenu->addSeparator();
     mCtxMenu->addAction(&syncAction);
+    QAction *prefetchAction = new QAction(tr("Pre-decompile Callers and Callees"), this);
+    prefetchAction->setCheckable(true);
+    prefetchAction->setChecked(Config()->getDecompilerPrefetchEnabled());
+    connect(prefetchAction, &QAction::toggled, this, [this](bool checked) {
+        Config()->setDecompilerPrefetchEnabled(checked);
+        schedulePrefetch();
+    });
+    mCtxMenu->addAction(prefetchAction);
+    QAction *decompileAllAction = new QAction(tr("Decompile All Functions..."), this);
+    connect(decompileAllAction, &QAction::triggered, this, &DecompilerWidget::decompileAll);
+    mCtxMenu->addAction(decompileAllAction);
     addActions(mCtxMenu->actions());
 
     ui->progressLabel->setVisible(false);
     doRefresh();
 
-    connect(Core(), &IaitoCore::refreshAll, this, &DecompilerWidget::doRefresh);
-    connect(Core(), &IaitoCore::functionRenamed, this, &DecompilerWidget::doRefresh);
-    connect(Core(), &IaitoCore::varsChanged, this, &DecompilerWidget::doRefresh);
-    connect(Core(), &IaitoCore::functionsChanged, this, &DecompilerWidget::doRefresh);
-    connect(Core(), &IaitoCore::flagsChanged, this, &DecompilerWidget::doRefresh);
+    Core()->getRefreshScheduler()->subscribe(
+        this,
+        RefreshScheduler::Functions | RefreshScheduler::FunctionRenamed | RefreshScheduler::Vars
+            | RefreshScheduler::Flags | RefreshScheduler::CodeViews,
+        &DecompilerWidget::doRefresh);
     connect(Core(), &IaitoCore::commentsChanged, this, &DecompilerWidget::refreshIfChanged);
     connect(Core(), &IaitoCore::instructionChanged, this, &DecompilerWidget::refreshIfChanged);
-    connect(Core(), &IaitoCore::refreshCodeViews, this, &DecompilerWidget::doRefresh);
 
     // Esc to seek backward
     QAction *seekPrevAction = new QAction(this);
@@ -127,21 +144,9 @@ Decompiler *DecompilerWidget::getCurrentDecompiler()
 
 ut64 DecompilerWidget::offsetForPosition(size_t pos)
 {
-    ut64 closestPos = UT64_MAX;
-    ut64 closestOffset = mCtxMenu->getFirstOffsetInLine();
-    void *iter;
-    r_vector_foreach(&code->annotations, iter)
-    {
-        RCodeMetaItem *annotation = (RCodeMetaItem *) iter;
-        if (annotation->type != R_CODEMETA_TYPE_OFFSET || annotation->start > pos
-            || annotation->end <= pos) {
-            continue;
-        }
-        if (closestPos != UT64_MAX && closestPos >= annotation->start) {
-            continue;
-        }
-        closestPos = annotation->start;
-        closestOffset = annotation->offset.offset;
+    ut64 closestOffset = annotationIndex.offsetAt(pos);
+    if (closestOffset == RVA_INVALID) {
+        closestOffset = mCtxMenu->getFirstOffsetInLine();
     }
     // eprintf ("%llx \n", closestOffset);
     if (closestOffset != UT64_MAX) {
@@ -152,22 +157,7 @@ ut64 DecompilerWidget::offsetForPosition(size_t pos)
 
 size_t DecompilerWidget::positionForOffset(ut64 offset)
 {
-    ut64 closestPos = UT64_MAX;
-    ut64 closestOffset = UT64_MAX;
-    void *iter;
-    r_vector_foreach(&code->annotations, iter)
-    {
-        RCodeMetaItem *annotation = (RCodeMetaItem *) iter;
-        if (annotation->type != R_CODEMETA_TYPE_OFFSET || annotation->offset.offset > offset) {
-            continue;
-        }
-        if (closestOffset != UT64_MAX && closestOffset >= annotation->offset.offset) {
-            continue;
-        }
-        closestPos = annotation->start;
-        closestOffset = annotation->offset.offset;
-    }
-    return closestPos;
+    return annotationIndex.positionForOffset(offset);
 }
 
 void DecompilerWidget::updateBreakpoints(RVA addr)
@@ -197,26 +187,12 @@ void DecompilerWidget::setInfoForBreakpoints()
     size_t startPos = cursorForLine.position();
     cursorForLine.movePosition(QTextCursor::EndOfLine);
     size_t endPos = cursorForLine.position();
-    gatherBreakpointInfo(*code, startPos, endPos);
+    gatherBreakpointInfo(startPos, endPos);
 }
 
-void DecompilerWidget::gatherBreakpointInfo(RCodeMeta &codeDecompiled, size_t startPos, size_t endPos)
+void DecompilerWidget::gatherBreakpointInfo(size_t startPos, size_t endPos)
 {
-    RVA firstOffset = RVA_MAX;
-    void *iter;
-    r_vector_foreach(&codeDecompiled.annotations, iter)
-    {
-        RCodeMetaItem *annotation = (RCodeMetaItem *) iter;
-        if (annotation->type != R_CODEMETA_TYPE_OFFSET) {
-            continue;
-        }
-        if ((startPos <= annotation->start && annotation->start < endPos)
-            || (startPos < annotation->end && annotation->end < endPos)) {
-            firstOffset = (annotation->offset.offset < firstOffset) ? annotation->offset.offset
-                                                                    : firstOffset;
-        }
-    }
-    mCtxMenu->setFirstOffsetInLine(firstOffset);
+    mCtxMenu->setFirstOffsetInLine(annotationIndex.firstOffsetIn(startPos, endPos));
     QList<RVA> functionBreakpoints = Core()->getBreakpointsInFunction(decompiledFunctionAddr);
     QVector<RVA> offsetList;
     for (RVA bpOffset : functionBreakpoints) {
@@ -277,17 +253,122 @@ void DecompilerWidget::doRefresh()
         return;
     }
     mCtxMenu->setDecompiledFunctionAddress(decompiledFunctionAddr);
+    // Flicking between functions shows them again without decompiling
+    RCodeMeta *cached = dec->cachedCode(decompiledFunctionAddr);
+    if (cached) {
+        decompilationFinished(cached);
+        return;
+    }
     connect(dec, &Decompiler::finished, this, &DecompilerWidget::decompilationFinished);
     decompilerBusy = true;
-#if MONOTHREAD
+    decompileGeneration = Core()->getAnalysisGeneration();
+    if (Core()->isThreadedMode()) {
+        dec->decompileAt(addr);
+        return;
+    }
     RCodeMeta *cm = dec->decompileSync(addr);
     if (cm) {
         // dec->finished(cm);
         this->decompilationFinished(cm);
     }
-#else
-    dec->decompileAt(addr);
-#endif
+}
+
+void DecompilerWidget::schedulePrefetch()
+{
+    prefetchQueue.clear();
+    // Synchronous decompilers would block the UI while prefetching
+    if (!Config()->getDecompilerPrefetchEnabled() || !Core()->isThreadedMode()
+        || decompiledFunctionAddr == RVA_INVALID) {
+        return;
+    }
+    const QList<RVA> neighbours = Core()->getFunctionCallees(decompiledFunctionAddr)
+                                  + Core()->getFunctionCallers(decompiledFunctionAddr);
+    for (RVA addr : neighbours) {
+        if (prefetchQueue.size() >= DECOMPILER_PREFETCH_FUNCTIONS) {
+            break;
+        }
+        if (addr != decompiledFunctionAddr && !prefetchQueue.contains(addr)) {
+            prefetchQueue << addr;
+        }
+    }
+    QTimer::singleShot(0, this, &DecompilerWidget::prefetchNext);
+}
+
+void DecompilerWidget::prefetchNext()
+{
+    if (prefetchAddr != RVA_INVALID || decompilerBusy) {
+        return;
+    }
+    Decompiler *dec = getCurrentDecompiler();
+    if (!dec || dec->isRunning()) {
+        return;
+    }
+    while (!prefetchQueue.isEmpty()) {
+        RVA addr = prefetchQueue.takeFirst();
+        // Skip imports and other call targets that are not functions
+        if (Core()->getFunctionStart(addr) != addr || dec->isCached(addr)) {
+            continue;
+        }
+        prefetchAddr = addr;
+        prefetchGeneration = Core()->getAnalysisGeneration();
+        prefetchDecompiler = dec;
+        connect(dec, &Decompiler::finished, this, &DecompilerWidget::prefetchFinished);
+        dec->decompileAt(addr);
+        return;
+    }
+}
+
+void DecompilerWidget::prefetchFinished(RCodeMeta *codeDecompiled)
+{
+    disconnect(
+        prefetchDecompiler, &Decompiler::finished, this, &DecompilerWidget::prefetchFinished);
+    if (codeDecompiled) {
+        prefetchDecompiler->cacheCode(prefetchAddr, codeDecompiled, prefetchGeneration);
+        r_codemeta_free(codeDecompiled);
+    }
+    prefetchAddr = RVA_INVALID;
+    prefetchDecompiler = nullptr;
+    // A refresh waiting for the decompiler runs first, continue afterwards
+    QTimer::singleShot(0, this, &DecompilerWidget::prefetchNext);
+}
+
+void DecompilerWidget::decompileAll()
+{
+    Decompiler *dec = getCurrentDecompiler();
+    if (!dec) {
+        return;
+    }
+    DecompiledIndex::Ptr index = dec->getIndex(true);
+    if (!index) {
+        QMessageBox::critical(
+            this,
+            tr("Decompile All Functions"),
+            tr("Cannot open %1").arg(DecompiledIndex::defaultPath(dec->getId())));
+        return;
+    }
+    if (index->count() > 0) {
+        QMessageBox box(this);
+        box.setWindowTitle(tr("Decompile All Functions"));
+        box.setText(tr("%1 functions were already decompiled with %2.")
+                        .arg(index->count())
+                        .arg(dec->getName()));
+        QPushButton *resume = box.addButton(tr("Resume"), QMessageBox::AcceptRole);
+        QPushButton *restart = box.addButton(tr("Start Over"), QMessageBox::DestructiveRole);
+        box.addButton(QMessageBox::Cancel);
+        box.exec();
+        if (box.clickedButton() == restart) {
+            index->clear();
+        } else if (box.clickedButton() != resume) {
+            return;
+        }
+    }
+
+    AsyncTask::Ptr task(new DecompileAllTask(dec, index));
+    AsyncTaskDialog *taskDialog = new AsyncTaskDialog(task, this);
+    taskDialog->setInterruptOnClose(true);
+    taskDialog->setAttribute(Qt::WA_DeleteOnClose);
+    taskDialog->show();
+    Core()->getAsyncTaskManager()->start(task);
 }
 
 void DecompilerWidget::refreshDecompiler()
@@ -319,12 +400,17 @@ void DecompilerWidget::decompilationFinished(RCodeMeta *codeDecompiled)
     ui->progressLabel->setVisible(false);
     ui->decompilerComboBox->setEnabled(decompilerSelectionEnabled);
 
+    Decompiler *dec = getCurrentDecompiler();
+    if (decompilerBusy) {
+        // setCode() takes and remaps the code, cache it as the decompiler made it
+        dec->cacheCode(decompiledFunctionAddr, codeDecompiled, decompileGeneration);
+    }
     mCtxMenu->setAnnotationHere(nullptr);
     setCode(codeDecompiled);
 
-    Decompiler *dec = getCurrentDecompiler();
     QObject::disconnect(dec, &Decompiler::finished, this, &DecompilerWidget::decompilationFinished);
     decompilerBusy = false;
+    schedulePrefetch();
 
     if (ui->textEdit->toPlainText().isEmpty()) {
         setCode(Decompiler::makeWarning(tr("Cannot decompile at this address (Not a function?)")));
@@ -335,21 +421,8 @@ void DecompilerWidget::decompilationFinished(RCodeMeta *codeDecompiled)
     updateCursorPosition();
     highlightPC();
     highlightBreakpoints();
-    lowestOffsetInCode = RVA_MAX;
-    highestOffsetInCode = 0;
-    void *iter;
-    r_vector_foreach(&code->annotations, iter)
-    {
-        RCodeMetaItem *annotation = (RCodeMetaItem *) iter;
-        if (annotation->type == R_CODEMETA_TYPE_OFFSET) {
-            if (lowestOffsetInCode > annotation->offset.offset) {
-                lowestOffsetInCode = annotation->offset.offset;
-            }
-            if (highestOffsetInCode < annotation->offset.offset) {
-                highestOffsetInCode = annotation->offset.offset;
-            }
-        }
-    }
+    lowestOffsetInCode = annotationIndex.lowestOffset();
+    highestOffsetInCode = annotationIndex.highestOffset();
 
     if (isDisplayReset) {
         ui->textEdit->horizontalScrollBar()->setSliderPosition(scrollerHorizontal);
@@ -359,20 +432,7 @@ void DecompilerWidget::decompilationFinished(RCodeMeta *codeDecompiled)
 
 void DecompilerWidget::setAnnotationsAtCursor(size_t pos)
 {
-    RCodeMetaItem *annotationAtPos = nullptr;
-    void *iter;
-    r_vector_foreach(&this->code->annotations, iter)
-    {
-        RCodeMetaItem *annotation = (RCodeMetaItem *) iter;
-        if (annotation->type == R_CODEMETA_TYPE_OFFSET
-            || annotation->type == R_CODEMETA_TYPE_SYNTAX_HIGHLIGHT || annotation->start > pos
-            || annotation->end <= pos) {
-            continue;
-        }
-        annotationAtPos = annotation;
-        break;
-    }
-    mCtxMenu->setAnnotationHere(annotationAtPos);
+    mCtxMenu->setAnnotationsAt(pos);
 }
 
 void DecompilerWidget::decompilerSelected()
@@ -675,11 +735,9 @@ static QString remapAnnotationOffsetsToQString(RCodeMeta &code)
 void DecompilerWidget::setCode(RCodeMeta *code)
 {
     connectCursorPositionChanged(false);
-    if (auto highlighter = qobject_cast<DecompilerHighlighter *>(syntaxHighlighter.get())) {
-        highlighter->setAnnotations(code);
-    }
     this->code.reset(code);
     QString text = remapAnnotationOffsetsToQString(*this->code);
+    annotationIndex.build(this->code.get());
     this->ui->textEdit->setPlainText(text);
     connectCursorPositionChanged(true);
     syntaxHighlighter->rehighlight();
@@ -690,7 +748,8 @@ void DecompilerWidget::setHighlighter(bool annotationBasedHighlighter)
     usingAnnotationBasedHighlighting = annotationBasedHighlighter;
     if (usingAnnotationBasedHighlighting) {
         syntaxHighlighter.reset(new DecompilerHighlighter());
-        static_cast<DecompilerHighlighter *>(syntaxHighlighter.get())->setAnnotations(code.get());
+        static_cast<DecompilerHighlighter *>(syntaxHighlighter.get())
+            ->setAnnotationIndex(&annotationIndex);
     } else {
         syntaxHighlighter.reset(Config()->createSyntaxHighlighter(nullptr));
     }
@@ -6,8 +6,12 @@
 
 #include "Decompiler.h"
 #include "MemoryDockWidget.h"
+#include "common/CodeAnnotationIndex.h"
 #include "core/Iaito.h"
 
+// Most callers and callees of the shown function decompiled in the background
+#define DECOMPILER_PREFETCH_FUNCTIONS 16
+
 namespace Ui {
 class DecompilerWidget;
 }
@@ -57,6 +61,17 @@ private slots:
      */
     void seekChanged();
     void decompilationFinished(RCodeMeta *code);
+    /**
+     * @brief Decompile the next queued neighbour of the shown function if the
+     * decompiler is idle.
+     */
+    void prefetchNext();
+    void prefetchFinished(RCodeMeta *code);
+    /**
+     * @brief Decompile every function with the selected decompiler into its
+     * on-disk index, resuming a previous run if the user wants to.
+     */
+    void decompileAll();
 
 private:
     std::unique_ptr<Ui::DecompilerWidget> ui;
@@ -73,6 +88,19 @@ private:
      * this widget. Once the decompilation is over, this should be set to false.
      */
     bool decompilerBusy;
+    /**
+     * Analysis generation when the running decompilation started.
+     */
+    quint64 decompileGeneration = 0;
+
+    /**
+     * Callers and callees of the shown function left to decompile in the
+     * background, and the one being decompiled by prefetchDecompiler.
+     */
+    QList<RVA> prefetchQueue;
+    RVA prefetchAddr = RVA_INVALID;
+    quint64 prefetchGeneration = 0;
+    Decompiler *prefetchDecompiler = nullptr;
 
     bool seekFromCursor;
     int scrollerHorizontal;
@@ -80,6 +108,11 @@ private:
     RVA previousFunctionAddr;
     RVA decompiledFunctionAddr;
     std::unique_ptr<RCodeMeta, void (*)(RCodeMeta *)> code;
+    /**
+     * Index of the annotations of code, rebuilt by setCode() and shared with
+     * the highlighter and the context menu.
+     */
+    CodeAnnotationIndex annotationIndex;
 
     /**
      * Specifies the lowest offset of instructions among all the instructions in
@@ -120,6 +153,11 @@ private:
      * @param addr Specified offset/offset in sync.
      */
     void doRefresh();
+    /**
+     * @brief Queue the callers and callees of the decompiled function for
+     * background decompilation, if enabled.
+     */
+    void schedulePrefetch();
     /**
      * @brief Update fonts
      */
@@ -194,19 +232,17 @@ private:
     void highlightBreakpoints();
     /**
      * @brief Finds the earliest offset and breakpoints within the specified
-     * range [startPos, endPos] in the specified RCodeMeta.
+     * range [startPos, endPos] in the decompiled code.
      *
      * This function is supposed to be used for finding the earliest offset and
      * breakpoints within the specified range [startPos, endPos]. This will set
      * the value of the variables 'RVA firstOffsetInLine' and 'QVector<RVA>
      * availableBreakpoints' in the context menu.
      *
-     * @param codeDecompiled - A reference to the RCodeMeta for the function
-     * that is decompiled.
      * @param startPos - Position of the start of the range(inclusive).
      * @param endPos - Position of the end of the range(inclusive).
      */
-    void gatherBreakpointInfo(RCodeMeta &codeDecompiled, size_t startPos, size_t endPos);
+    void gatherBreakpointInfo(size_t startPos, size_t endPos);
     /**
      * @brief Finds the offset that's closest to the specified position in the
      * decompiled code.
@@ -6,6 +6,7 @@
 #include "common/Configuration.h"
 #include "common/Helpers.h"
 #include "common/IaitoSeekable.h"
+#include "common/RefreshScheduler.h"
 #include "common/SyntaxHighlighter.h"
 #include "common/TempConfig.h"
 #include "core/Iaito.h"
@@ -22,11 +23,11 @@
 #include <QPropertyAnimation>
 #include <QRegularExpression>
 #include <QShortcut>
-#include <QTextDocument>
 #include <QTextEdit>
 #include <QToolTip>
 #include <QVBoxLayout>
 
+#include <algorithm>
 #include <cmath>
 
 DisassemblerGraphView::DisassemblerGraphView(
@@ -44,16 +45,21 @@ DisassemblerGraphView::DisassemblerGraphView(
     highlight_token = nullptr;
     auto *layout = new QVBoxLayout(this);
     // Signals that require a refresh all
-    connect(Core(), &IaitoCore::refreshAll, this, &DisassemblerGraphView::refreshView);
-    connect(Core(), &IaitoCore::commentsChanged, this, &DisassemblerGraphView::refreshView);
-    connect(Core(), &IaitoCore::functionRenamed, this, &DisassemblerGraphView::refreshView);
-    connect(Core(), &IaitoCore::flagsChanged, this, &DisassemblerGraphView::refreshView);
-    connect(Core(), &IaitoCore::varsChanged, this, &DisassemblerGraphView::refreshView);
-    connect(Core(), &IaitoCore::instructionChanged, this, &DisassemblerGraphView::refreshView);
-    connect(Core(), &IaitoCore::breakpointsChanged, this, &DisassemblerGraphView::refreshView);
-    connect(Core(), &IaitoCore::functionsChanged, this, &DisassemblerGraphView::refreshView);
-    connect(Core(), &IaitoCore::asmOptionsChanged, this, &DisassemblerGraphView::refreshView);
-    connect(Core(), &IaitoCore::refreshCodeViews, this, &DisassemblerGraphView::refreshView);
+    Core()->getRefreshScheduler()->subscribe(
+        this,
+        RefreshScheduler::Functions | RefreshScheduler::FunctionRenamed | RefreshScheduler::Vars
+            | RefreshScheduler::Flags | RefreshScheduler::Comments | RefreshScheduler::Instructions
+            | RefreshScheduler::Breakpoints | RefreshScheduler::CodeViews,
+        &DisassemblerGraphView::refreshView);
+    connect(Core(), &IaitoCore::asmOptionsChanged, this, [this]() {
+        invalidateGraphPlacement();
+        refreshView();
+    });
+    // the program counter is highlighted
+    connect(Core(), &IaitoCore::registersChanged, this, [this]() {
+        setCacheDirty();
+        viewport()->update();
+    });
 
     connectSeekChanged(false);
 
@@ -189,6 +195,9 @@ void DisassemblerGraphView::refreshView()
 
 void DisassemblerGraphView::loadCurrentGraph()
 {
+    // a layout still running for the previous function is useless now
+    cancelGraphPlacement();
+
     TempConfig tempConfig;
     tempConfig.set("scr.color", COLOR_MODE_16M)
         .set("asm.lines", false)
@@ -204,7 +213,12 @@ void DisassemblerGraphView::loadCurrentGraph()
     }
 
     disassembly_blocks.clear();
-    blocks.clear();
+    // renames, comments and patches keep the blocks, their placement is reused
+    GraphLayout::Graph previousBlocks;
+    previousBlocks.swap(blocks);
+    // Nothing repaints the tiles of the previous function if there is no new
+    // one to place
+    setCacheDirty();
 
     if (highlight_token) {
         delete highlight_token;
@@ -244,6 +258,13 @@ void DisassemblerGraphView::loadCurrentGraph()
     RVA entry = func[ADDR].toVariant().toULongLong();
 
     setEntry(entry);
+
+    // these don't change while loading, don't query them for every op
+    const bool blockEntryOffset = Config()->getGraphBlockEntryOffset();
+    const int blockLength = Config()->getGraphBlockMaxChars()
+                            + Core()->getConfigb("asm.bytes") * 24
+                            + Core()->getConfigb("asm.emu") * 10;
+
     for (const QJsonValueRef value : func["blocks"].toArray()) {
         QJsonObject block = value.toObject();
         RVA block_entry = block[ADDR].toVariant().toULongLong();
@@ -255,7 +276,7 @@ void DisassemblerGraphView::loadCurrentGraph()
         GraphBlock gb;
         gb.entry = block_entry;
         db.entry = block_entry;
-        if (Config()->getGraphBlockEntryOffset()) {
+        if (blockEntryOffset) {
             // QColor(0,0,0,0) is transparent
             db.header_text
                 = Text("[" + RAddressString(db.entry) + "]", ConfigColor(ADDR), QColor(0, 0, 0, 0));
@@ -301,19 +322,12 @@ void DisassemblerGraphView::loadCurrentGraph()
                 // or to the end of the block.
                 i.size = (block_entry + block_size) - i.addr;
             }
+            Core()->cacheInstructionSize(i.addr, i.size);
 
-            QTextDocument textDoc;
-            textDoc.setHtml(IaitoCore::ansiEscapeToHtml(op["text"].toString()));
-
-            i.plainText = textDoc.toPlainText();
-
-            RichTextPainter::List richText = RichTextPainter::fromTextDocument(textDoc);
-            // Colors::colorizeAssembly(richText, textDoc.toPlainText(), 0);
+            RichTextPainter::List richText
+                = RichTextPainter::fromAnsi(op["text"].toString(), &i.plainText);
 
             bool cropped;
-            int blockLength = Config()->getGraphBlockMaxChars()
-                              + Core()->getConfigb("asm.bytes") * 24
-                              + Core()->getConfigb("asm.emu") * 10;
             i.text = Text(RichTextPainter::cropped(richText, blockLength, "...", &cropped));
             if (cropped)
                 i.fullText = richText;
@@ -328,7 +342,7 @@ void DisassemblerGraphView::loadCurrentGraph()
     }
     cleanupEdges(blocks);
 
-    if (!func["blocks"].toArray().isEmpty()) {
+    if (!func["blocks"].toArray().isEmpty() && !reuseGraphPlacement(previousBlocks)) {
         computeGraphPlacement();
     }
 }
@@ -348,6 +362,14 @@ DisassemblerGraphView::EdgeConfigurationMapping DisassemblerGraphView::getEdgeCo
 void DisassemblerGraphView::prepareGraphNode(GraphBlock &block)
 {
     DisassemblyBlock &db = disassembly_blocks[block.entry];
+    db.startAddr = UT64_MAX;
+    db.endAddr = 0;
+    for (const Instr &instr : db.instrs) {
+        if (!instr.empty()) {
+            db.startAddr = std::min(db.startAddr, instr.addr);
+            db.endAddr = std::max(db.endAddr, instr.addr + instr.size);
+        }
+    }
     int width = 0;
     int height = 0;
     for (auto &line : db.header_text.lines) {
@@ -373,6 +395,33 @@ void DisassemblerGraphView::prepareGraphNode(GraphBlock &block)
     block.height = (height * charHeight) + extra;
 }
 
+QString DisassemblerGraphView::blockTitle(GraphView::GraphBlock &block)
+{
+    if (block.entry == currentFcnAddr) {
+        RAnalFunction *fcn = Core()->functionAt(currentFcnAddr);
+        if (fcn && fcn->name) {
+            return QString::fromUtf8(fcn->name);
+        }
+    }
+    return RAddressString(block.entry);
+}
+
+QColor DisassemblerGraphView::blockFillColor(GraphView::GraphBlock &block, bool interactive)
+{
+    if (auto bb = Core()->getBBHighlighter()->getBasicBlock(block.entry)) {
+        return QColor(bb->color);
+    }
+    if (interactive) {
+        RVA addr = seekable->getOffset();
+        auto db = disassembly_blocks.find(block.entry);
+        if (db != disassembly_blocks.end() && addr >= db->second.startAddr
+            && addr < db->second.endAddr) {
+            return disassemblySelectedBackgroundColor;
+        }
+    }
+    return disassemblyBackgroundColor;
+}
+
 void DisassemblerGraphView::drawBlock(QPainter &p, GraphView::GraphBlock &block, bool interactive)
 {
     QRectF blockRect(block.x, block.y, block.width, block.height);
@@ -384,8 +433,6 @@ void DisassemblerGraphView::drawBlock(QPainter &p, GraphView::GraphBlock &block,
     p.setFont(Config()->getFont());
     p.drawRect(blockRect);
 
-    breakpoints = Core()->getBreakpointsAddresses();
-
     // Render node
     DisassemblyBlock &db = disassembly_blocks[block.entry];
     bool block_selected = false;
@@ -505,7 +552,7 @@ void DisassemblerGraphView::drawBlock(QPainter &p, GraphView::GraphBlock &block,
             int(instr.text.lines.size()) * charHeight);
 
         QColor instrColor;
-        if (Core()->isBreakpoint(breakpoints, instr.addr)) {
+        if (Core()->isBreakpoint(instr.addr)) {
             instrColor = ConfigColor("gui.breakpoint_background");
         } else if (instr.addr == PCAddr) {
             instrColor = PCSelectionColor;
@@ -700,9 +747,39 @@ const DisassemblerGraphView::Instr *DisassemblerGraphView::instrForAddress(RVA a
     return nullptr;
 }
 
+void DisassemblerGraphView::invalidateSelection()
+{
+    RVA offset = seekable->getOffset();
+    for (RVA addr : {paintedOffset, offset}) {
+        if (DisassemblyBlock *db = blockForAddress(addr)) {
+            invalidateBlock(blocks[db->entry]);
+        }
+    }
+    paintedOffset = offset;
+}
+
+void DisassemblerGraphView::setCurrentBlock(RVA entry)
+{
+    if (entry == currentBlockAddress) {
+        return;
+    }
+    // The edges may run through any tile, not just the ones of their blocks
+    for (const auto &it : blocks) {
+        const GraphBlock &block = it.second;
+        for (const GraphEdge &edge : block.edges) {
+            if (block.entry == currentBlockAddress || block.entry == entry
+                || edge.target == currentBlockAddress || edge.target == entry) {
+                invalidateArea(edge.polyline.boundingRect());
+            }
+        }
+    }
+    currentBlockAddress = entry;
+}
+
 void DisassemblerGraphView::onSeekChanged(RVA addr)
 {
     blockMenu->setOffset(addr);
+    invalidateSelection();
     DisassemblyBlock *db = blockForAddress(addr);
     bool switchFunction = false;
     if (!db) {
@@ -793,6 +870,7 @@ void DisassemblerGraphView::seekLocal(RVA addr, bool update_viewport)
     connectSeekChanged(true);
     seekable->seek(addr);
     connectSeekChanged(false);
+    invalidateSelection();
     if (update_viewport) {
         viewport()->update();
     }
@@ -851,7 +929,7 @@ void DisassemblerGraphView::blockClicked(GraphView::GraphBlock &block, QMouseEve
         return;
     }
 
-    currentBlockAddress = block.entry;
+    setCurrentBlock(block.entry);
 
     highlight_token = getToken(instr, pos.x());
 
@@ -863,6 +941,8 @@ void DisassemblerGraphView::blockClicked(GraphView::GraphBlock &block, QMouseEve
     if (highlight_token) {
         blockMenu->setCurHighlightedWord(highlight_token->content);
     }
+    // the highlighted token may appear in any block
+    setCacheDirty();
     viewport()->update();
 }
 
@@ -933,7 +1013,8 @@ bool DisassemblerGraphView::helpEvent(QHelpEvent *event)
 
 void DisassemblerGraphView::blockTransitionedTo(GraphView::GraphBlock *to)
 {
-    currentBlockAddress = to->entry;
+    setCurrentBlock(to->entry);
+    viewport()->update();
     if (transition_dont_seek) {
         transition_dont_seek = false;
         return;
@@ -983,13 +1064,6 @@ void DisassemblerGraphView::restoreCurrentBlock()
     onSeekChanged(this->seekable->getOffset()); // try to keep the view on current block
 }
 
-void DisassemblerGraphView::paintEvent(QPaintEvent *event)
-{
-    // DisassemblerGraphView is always dirty
-    setCacheDirty();
-    GraphView::paintEvent(event);
-}
-
 bool DisassemblerGraphView::Instr::contains(ut64 addr) const
 {
     return this->addr <= addr && (addr - this->addr) < size;
@@ -86,6 +86,11 @@ class DisassemblerGraphView : public IaitoGraphView
         ut64 false_path = 0;
         bool terminal = false;
         bool indirectcall = false;
+        /**
+         * addresses covered by the instructions, set by prepareGraphNode()
+         */
+        ut64 startAddr = 0;
+        ut64 endAddr = 0;
     };
 
 public:
@@ -104,6 +109,8 @@ public:
     virtual void blockHelpEvent(GraphView::GraphBlock &block, QHelpEvent *event, QPoint pos) override;
     virtual GraphView::EdgeConfiguration edgeConfiguration(
         GraphView::GraphBlock &from, GraphView::GraphBlock *to, bool interactive) override;
+    virtual QString blockTitle(GraphView::GraphBlock &block) override;
+    virtual QColor blockFillColor(GraphView::GraphBlock &block, bool interactive) override;
     virtual void blockTransitionedTo(GraphView::GraphBlock *to) override;
 
     void loadCurrentGraph();
@@ -135,7 +142,6 @@ public slots:
     void copySelection();
 
 protected:
-    void paintEvent(QPaintEvent *event) override;
     void blockContextMenuRequested(
         GraphView::GraphBlock &block, QContextMenuEvent *event, QPoint pos) override;
     void contextMenuEvent(QContextMenuEvent *event) override;
@@ -151,11 +157,25 @@ private:
     Token *highlight_token;
     bool emptyGraph;
     ut64 currentBlockAddress = RVA_INVALID;
+    /**
+     * offset whose instruction was last painted as selected
+     */
+    RVA paintedOffset = RVA_INVALID;
 
     DisassemblyContextMenu *blockMenu;
     QMenu *contextMenu;
 
     void connectSeekChanged(bool disconnect);
+    /**
+     * @brief Render again the blocks of the previously and currently selected
+     * instructions
+     */
+    void invalidateSelection();
+    /**
+     * @brief Change the block whose edges are drawn bold, rendering those of
+     * the previous and new one again
+     */
+    void setCurrentBlock(RVA entry);
 
     void prepareGraphNode(GraphBlock &block);
     Token *getToken(Instr *instr, int x);
@@ -179,7 +199,6 @@ private:
 
     IaitoSeekable *seekable = nullptr;
     QList<QShortcut *> shortcuts;
-    QList<RVA> breakpoints;
 
     QAction actionUnhighlight;
     QAction actionUnhighlightInstruction;
@@ -1,6 +1,7 @@
 #include "DisassemblyWidget.h"
 #include "common/Configuration.h"
 #include "common/Helpers.h"
+#include "common/RefreshScheduler.h"
 #include "common/SelectionHighlight.h"
 #include "common/ShortcutKeys.h"
 #include "common/TempConfig.h"
@@ -45,6 +46,7 @@ DisassemblyWidget::DisassemblyWidget(MainWindow *main)
     , mCtxMenu(new DisassemblyContextMenu(this, main))
     , mDisasScrollArea(new DisassemblyScrollArea(this))
     , mDisasTextEdit(new DisassemblyTextEdit(this))
+    , renderedLines(DISASSEMBLY_RENDERED_LINES_CACHE)
 {
     setObjectName(main ? main->getUniqueObjectName(getWidgetType()) : getWidgetType());
     updateWindowTitle();
@@ -117,6 +119,7 @@ DisassemblyWidget::DisassemblyWidget(MainWindow *main)
     mDisasTextEdit->setVerticalScrollBarPolicy(Qt::ScrollBarAlwaysOff);
     mDisasTextEdit->setFont(Config()->getFont());
     mDisasTextEdit->setReadOnly(true);
+    mDisasTextEdit->setUndoRedoEnabled(false);
     mDisasTextEdit->setLineWrapMode(QPlainTextEdit::WidgetWidth);
     // wrapping breaks readCurrentDisassemblyOffset() at the moment :-(
     mDisasTextEdit->setWordWrapMode(QTextOption::NoWrap);
@@ -155,22 +158,26 @@ DisassemblyWidget::DisassemblyWidget(MainWindow *main)
         }
     });
 
-    connect(Core(), &IaitoCore::commentsChanged, this, [this]() { refreshDisasm(); });
-    connect(Core(), SIGNAL(flagsChanged()), this, SLOT(refreshDisasm()));
-    connect(Core(), SIGNAL(functionsChanged()), this, SLOT(refreshDisasm()));
-    connect(Core(), &IaitoCore::functionRenamed, this, [this]() { refreshDisasm(); });
-    connect(Core(), SIGNAL(varsChanged()), this, SLOT(refreshDisasm()));
+    Core()->getRefreshScheduler()->subscribe(
+        this,
+        RefreshScheduler::Comments | RefreshScheduler::Flags | RefreshScheduler::Functions
+            | RefreshScheduler::FunctionRenamed | RefreshScheduler::Vars
+            | RefreshScheduler::CodeViews,
+        [this]() {
+            if (Core()->getRefreshScheduler()->dispatchedKinds().testFlag(
+                    RefreshScheduler::Everything)) {
+                refreshDisasm(seekable->getOffset());
+            } else {
+                refreshDisasm();
+            }
+        });
     connect(Core(), SIGNAL(asmOptionsChanged()), this, SLOT(refreshDisasm()));
     connect(Core(), &IaitoCore::instructionChanged, this, &DisassemblyWidget::refreshIfInRange);
     connect(Core(), &IaitoCore::breakpointsChanged, this, &DisassemblyWidget::refreshIfInRange);
-    connect(Core(), SIGNAL(refreshCodeViews()), this, SLOT(refreshDisasm()));
 
     connect(Config(), &Configuration::fontsUpdated, this, &DisassemblyWidget::fontsUpdatedSlot);
     connect(Config(), &Configuration::colorsUpdated, this, &DisassemblyWidget::colorsUpdatedSlot);
 
-    connect(Core(), &IaitoCore::refreshAll, this, [this]() {
-        refreshDisasm(seekable->getOffset());
-    });
     refreshDisasm(seekable->getOffset());
 
     connect(mCtxMenu, &DisassemblyContextMenu::copy, mDisasTextEdit, &QPlainTextEdit::copy);
@@ -286,11 +293,11 @@ void DisassemblyWidget::refreshDisasm(RVA offset)
     if (maxLines <= 0) {
         connectCursorPositionChanged(true);
         mDisasTextEdit->clear();
+        displayedLines.clear();
         connectCursorPositionChanged(false);
         return;
     }
 
-    breakpoints = Core()->getBreakpointsAddresses();
     int horizontalScrollValue = mDisasTextEdit->horizontalScrollBar()->value();
     mDisasTextEdit->setLockScroll(true); // avoid flicker
 
@@ -303,24 +310,14 @@ void DisassemblyWidget::refreshDisasm(RVA offset)
 
     connectCursorPositionChanged(true);
 
-    mDisasTextEdit->document()->clear();
-    QTextCursor cursor(mDisasTextEdit->document());
-    QTextBlockFormat regular = cursor.blockFormat();
+    QList<DisassemblyLine> newDisplayedLines;
     for (const DisassemblyLine &line : lines) {
-        if (line.offset < topOffset) { // overflow
+        if (line.offset < topOffset || newDisplayedLines.size() >= maxLines) { // overflow
             break;
         }
-        cursor.insertHtml(line.text);
-        if (Core()->isBreakpoint(breakpoints, line.offset)) {
-            QTextBlockFormat f;
-            f.setBackground(ConfigColor("gui.breakpoint_background"));
-            cursor.setBlockFormat(f);
-        }
-        auto a = new DisassemblyTextBlockUserData(line);
-        cursor.block().setUserData(a);
-        cursor.insertBlock();
-        cursor.setBlockFormat(regular);
+        newDisplayedLines << line;
     }
+    updateDocument(newDisplayedLines);
 
     if (lines.isEmpty()) {
         bottomOffset = topOffset;
@@ -335,14 +332,6 @@ void DisassemblyWidget::refreshDisasm(RVA offset)
 
     updateCursorPosition();
 
-    // remove additional lines
-    QTextCursor tc = mDisasTextEdit->textCursor();
-    tc.movePosition(QTextCursor::Start);
-    tc.movePosition(QTextCursor::Down, QTextCursor::MoveAnchor, maxLines - 1);
-    tc.movePosition(QTextCursor::EndOfLine);
-    tc.movePosition(QTextCursor::End, QTextCursor::KeepAnchor);
-    tc.removeSelectedText();
-
     mDisasTextEdit->setLockScroll(false);
     mDisasTextEdit->horizontalScrollBar()->setValue(horizontalScrollValue);
 
@@ -350,6 +339,136 @@ void DisassemblyWidget::refreshDisasm(RVA offset)
     leftPanel->update();
 }
 
+static bool sameLine(const DisassemblyLine &a, const DisassemblyLine &b)
+{
+    return a.offset == b.offset && a.text == b.text;
+}
+
+/**
+ * @brief Finds the smallest shift such that from[shift + i] == to[i] for the
+ * whole overlap of the two lists.
+ * @return -1 if the lists don't overlap
+ */
+static int findLinesShift(const QList<DisassemblyLine> &from, const QList<DisassemblyLine> &to)
+{
+    for (int shift = 0; shift < from.size(); shift++) {
+        int overlap = qMin(from.size() - shift, to.size());
+        int i = 0;
+        while (i < overlap && sameLine(from[shift + i], to[i])) {
+            i++;
+        }
+        if (overlap > 0 && i == overlap) {
+            return shift;
+        }
+    }
+    return -1;
+}
+
+RichTextPainter::List DisassemblyWidget::richTextForLine(const DisassemblyLine &line)
+{
+    RenderedLine *rendered = renderedLines.object(line.offset);
+    if (rendered && rendered->html == line.text) {
+        return rendered->richText;
+    }
+    QTextDocument parser;
+    parser.setHtml(line.text);
+    rendered = new RenderedLine{line.text, RichTextPainter::fromTextDocument(parser)};
+    RichTextPainter::List richText = rendered->richText;
+    renderedLines.insert(line.offset, rendered);
+    return richText;
+}
+
+void DisassemblyWidget::insertLine(QTextCursor &cursor, const DisassemblyLine &line)
+{
+    for (const RichTextPainter::CustomRichText_t &run : richTextForLine(line)) {
+        QTextCharFormat format;
+        if (run.flags == RichTextPainter::FlagColor || run.flags == RichTextPainter::FlagAll) {
+            format.setForeground(run.textColor);
+        }
+        if (run.flags == RichTextPainter::FlagBackground || run.flags == RichTextPainter::FlagAll) {
+            format.setBackground(run.textBackground);
+        }
+        cursor.insertText(run.text, format);
+    }
+}
+
+void DisassemblyWidget::updateDocument(const QList<DisassemblyLine> &newLines)
+{
+    QTextDocument *doc = mDisasTextEdit->document();
+    QTextCursor cursor(doc);
+    bool rebuild = displayedLines.isEmpty() || newLines.isEmpty()
+                   || doc->blockCount() != displayedLines.size();
+
+    // When scrolling by a few instructions most of the lines are already in
+    // the document: only drop the ones going out of view and insert the new
+    // ones instead of rebuilding everything.
+    int down = rebuild ? -1 : findLinesShift(displayedLines, newLines);
+    int up = rebuild || down >= 0 ? -1 : findLinesShift(newLines, displayedLines);
+    if (down >= 0) {
+        if (down > 0) {
+            cursor.movePosition(QTextCursor::Start);
+            cursor.movePosition(QTextCursor::NextBlock, QTextCursor::KeepAnchor, down);
+            cursor.removeSelectedText();
+        }
+        int kept = displayedLines.size() - down;
+        if (kept > newLines.size()) {
+            QTextBlock last = doc->findBlockByNumber(newLines.size() - 1);
+            cursor.setPosition(last.position() + last.length() - 1);
+            cursor.movePosition(QTextCursor::End, QTextCursor::KeepAnchor);
+            cursor.removeSelectedText();
+        }
+        cursor.movePosition(QTextCursor::End);
+        for (int i = kept; i < newLines.size(); i++) {
+            cursor.insertBlock();
+            insertLine(cursor, newLines[i]);
+        }
+    } else if (up >= 0) {
+        cursor.movePosition(QTextCursor::Start);
+        for (int i = 0; i < up; i++) {
+            insertLine(cursor, newLines[i]);
+            cursor.insertBlock();
+        }
+        if (doc->blockCount() > newLines.size()) {
+            QTextBlock last = doc->findBlockByNumber(newLines.size() - 1);
+            cursor.setPosition(last.position() + last.length() - 1);
+            cursor.movePosition(QTextCursor::End, QTextCursor::KeepAnchor);
+            cursor.removeSelectedText();
+        }
+        for (int i = up + displayedLines.size(); i < newLines.size(); i++) {
+            cursor.movePosition(QTextCursor::End);
+            cursor.insertBlock();
+            insertLine(cursor, newLines[i]);
+        }
+    } else {
+        rebuild = true;
+    }
+
+    if (rebuild || doc->blockCount() != newLines.size()) {
+        doc->clear();
+        cursor = QTextCursor(doc);
+        for (int i = 0; i < newLines.size(); i++) {
+            if (i > 0) {
+                cursor.insertBlock();
+            }
+            insertLine(cursor, newLines[i]);
+        }
+    }
+
+    // blocks may have been split or merged above, attach the line data and
+    // the breakpoint background again
+    QTextBlockFormat regular;
+    QTextBlockFormat breakpoint;
+    breakpoint.setBackground(ConfigColor("gui.breakpoint_background"));
+    QTextBlock block = doc->begin();
+    for (int i = 0; i < newLines.size() && block.isValid(); i++, block = block.next()) {
+        const DisassemblyLine &line = newLines[i];
+        QTextCursor(block).setBlockFormat(Core()->isBreakpoint(line.offset) ? breakpoint : regular);
+        block.setUserData(new DisassemblyTextBlockUserData(line));
+    }
+
+    displayedLines = newLines;
+}
+
 void DisassemblyWidget::scrollInstructions(int count)
 {
     if (count == 0) {
@@ -5,13 +5,18 @@
 #include "common/CachedFontMetrics.h"
 #include "common/IaitoSeekable.h"
 #include "common/RefreshDeferrer.h"
+#include "common/RichTextPainter.h"
 #include "core/Iaito.h"
 
 #include <QAction>
+#include <QCache>
 #include <QPlainTextEdit>
 #include <QShortcut>
 #include <QTextEdit>
 
+// number of lines converted to rich text kept around for scrolling
+#define DISASSEMBLY_RENDERED_LINES_CACHE 4096
+
 class DisassemblyTextEdit;
 class DisassemblyScrollArea;
 class DisassemblyContextMenu;
@@ -85,14 +90,32 @@ private:
 
     RefreshDeferrer *disasmRefresh;
 
+    /**
+     * Lines converted from the r2 HTML output to rich text runs, keyed by
+     * address and checked against the HTML, so that scrolling only parses
+     * the lines coming into view.
+     */
+    struct RenderedLine
+    {
+        QString html;
+        RichTextPainter::List richText;
+    };
+    QCache<RVA, RenderedLine> renderedLines;
+    /**
+     * lines currently in the document, one block per line
+     */
+    QList<DisassemblyLine> displayedLines;
+
+    RichTextPainter::List richTextForLine(const DisassemblyLine &line);
+    void insertLine(QTextCursor &cursor, const DisassemblyLine &line);
+    void updateDocument(const QList<DisassemblyLine> &newLines);
+
     RVA readCurrentDisassemblyOffset();
     RVA readDisassemblyOffset(QTextCursor tc);
     bool eventFilter(QObject *obj, QEvent *event) override;
     void keyPressEvent(QKeyEvent *event) override;
     QString getWindowTitle() const override;
 
-    QList<RVA> breakpoints;
-
     void setupFonts();
     void setupColors();
 
@@ -2,6 +2,7 @@
 #include "ui_EntrypointWidget.h"
 
 #include "common/Helpers.h"
+#include "common/RefreshScheduler.h"
 #include "core/MainWindow.h"
 
 #include <QPen>
@@ -19,8 +20,8 @@ EntrypointWidget::EntrypointWidget(MainWindow *main)
 
     setScrollMode();
 
-    connect(Core(), &IaitoCore::codeRebased, this, &EntrypointWidget::fillEntrypoint);
-    connect(Core(), &IaitoCore::refreshAll, this, &EntrypointWidget::fillEntrypoint);
+    Core()->getRefreshScheduler()->subscribe(
+        this, RefreshScheduler::Rebased, &EntrypointWidget::fillEntrypoint);
 }
 
 EntrypointWidget::~EntrypointWidget() {}
@@ -1,6 +1,7 @@
 #include "ExportsWidget.h"
 #include "WidgetShortcuts.h"
 #include "common/Helpers.h"
+#include "common/RefreshScheduler.h"
 #include "core/MainWindow.h"
 #include "ui_ListDockWidget.h"
 
@@ -144,8 +145,8 @@ ExportsWidget::ExportsWidget(MainWindow *main)
     QShortcut *toggle_shortcut = new QShortcut(widgetShortcuts["ExportsWidget"], main);
     connect(toggle_shortcut, &QShortcut::activated, this, [this]() { toggleDockWidget(true); });
 
-    connect(Core(), &IaitoCore::codeRebased, this, &ExportsWidget::refreshExports);
-    connect(Core(), &IaitoCore::refreshAll, this, &ExportsWidget::refreshExports);
+    Core()->getRefreshScheduler()->subscribe(
+        this, RefreshScheduler::Rebased, &ExportsWidget::refreshExports);
     connect(Core(), &IaitoCore::commentsChanged, this, [this]() {
         qhelpers::emitColumnChanged(exportsModel, ExportsModel::CommentColumn);
     });
@@ -1,4 +1,5 @@
 #include "widgets/FilesWidget.h"
+#include "common/RefreshScheduler.h"
 #include <QAbstractItemView>
 #include <QHBoxLayout>
 #include <QHeaderView>
@@ -64,7 +65,8 @@ FilesWidget::FilesWidget(MainWindow *main)
     setWidget(container);
 
     // Refresh listing whenever core triggers a global refresh (e.g., file load)
-    connect(Core(), &IaitoCore::refreshAll, this, &FilesWidget::loadOpenedFiles);
+    Core()->getRefreshScheduler()->subscribe(
+        this, RefreshScheduler::Nothing, &FilesWidget::loadOpenedFiles);
     loadOpenedFiles();
 }
 
@@ -1,5 +1,6 @@
 #include "FlagsWidget.h"
 #include "common/Helpers.h"
+#include "common/RefreshScheduler.h"
 #include "core/MainWindow.h"
 #include "ui_FlagsWidget.h"
 
@@ -194,7 +195,8 @@ FlagsWidget::FlagsWidget(MainWindow *main)
 
     connect(Core(), &IaitoCore::flagsChanged, this, &FlagsWidget::flagsChanged);
     connect(Core(), &IaitoCore::codeRebased, this, &FlagsWidget::flagsChanged);
-    connect(Core(), &IaitoCore::refreshAll, this, &FlagsWidget::refreshFlagspaces);
+    Core()->getRefreshScheduler()->subscribe(
+        this, RefreshScheduler::Nothing, &FlagsWidget::refreshFlagspaces);
     connect(Core(), &IaitoCore::commentsChanged, this, [this]() {
         qhelpers::emitColumnChanged(flags_model, FlagsModel::COMMENT);
     });
@@ -3,6 +3,7 @@
 
 #include "common/FunctionsTask.h"
 #include "common/Helpers.h"
+#include "common/RefreshScheduler.h"
 #include "common/TempConfig.h"
 #include "core/MainWindow.h"
 #include "menus/AddressableItemContextMenu.h"
@@ -518,9 +519,10 @@ FunctionsWidget::FunctionsWidget(MainWindow *main)
     this->setContextMenuPolicy(Qt::CustomContextMenu);
     connect(this, &QWidget::customContextMenuRequested, this, &FunctionsWidget::showTitleContextMenu);
 
-    connect(Core(), &IaitoCore::functionsChanged, this, &FunctionsWidget::refreshTree);
-    connect(Core(), &IaitoCore::codeRebased, this, &FunctionsWidget::refreshTree);
-    connect(Core(), &IaitoCore::refreshAll, this, &FunctionsWidget::refreshTree);
+    Core()->getRefreshScheduler()->subscribe(
+        this,
+        RefreshScheduler::Functions | RefreshScheduler::Rebased,
+        &FunctionsWidget::refreshTree);
     connect(Core(), &IaitoCore::commentsChanged, this, [this]() {
         qhelpers::emitColumnChanged(functionModel, FunctionModel::CommentColumn);
     });
@@ -530,21 +532,10 @@ FunctionsWidget::~FunctionsWidget() {}
 
 void FunctionsWidget::refreshTree()
 {
-#if MONOTHREAD
-    this->functions = Core()->getAllFunctions();
-    importAddresses.clear();
-    for (const ImportDescription &import : Core()->getAllImports()) {
-        importAddresses.insert(import.plt);
+    if (!Core()->isThreadedMode()) {
+        functionsFetched(Core()->getAllFunctions());
+        return;
     }
-
-    mainAdress = (ut64) Core()->cmdj("iMj").object()["vaddr"].toInt();
-
-    functionModel->updateCurrentIndex();
-    functionModel->endResetModel();
-
-    // resize offset and size columns
-    qhelpers::adjustColumns(ui->treeView, 3, 0);
-#else
     if (task) {
         task->wait();
     }
@@ -554,26 +545,29 @@ void FunctionsWidget::refreshTree()
         task.data(),
         &FunctionsTask::fetchFinished,
         this,
-        [this](const QList<FunctionDescription> &functions) {
-            functionModel->beginResetModel();
+        &FunctionsWidget::functionsFetched,
+        Qt::QueuedConnection);
+    Core()->getAsyncTaskManager()->start(task);
+}
 
-            this->functions = functions;
+void FunctionsWidget::functionsFetched(const QList<FunctionDescription> &functions)
+{
+    functionModel->beginResetModel();
 
-            importAddresses.clear();
-            for (const ImportDescription &import : Core()->getAllImports()) {
-                importAddresses.insert(import.plt);
-            }
+    this->functions = functions;
+
+    importAddresses.clear();
+    for (const ImportDescription &import : Core()->getAllImports()) {
+        importAddresses.insert(import.plt);
+    }
 
-            mainAdress = (ut64) Core()->cmdj("iMj").object()["vaddr"].toInt();
+    mainAdress = (ut64) Core()->cmdj("iMj").object()["vaddr"].toInt();
 
-            functionModel->updateCurrentIndex();
-            functionModel->endResetModel();
+    functionModel->updateCurrentIndex();
+    functionModel->endResetModel();
 
-            // resize offset and size columns
-            qhelpers::adjustColumns(ui->treeView, 3, 0);
-        });
-    Core()->getAsyncTaskManager()->start(task);
-#endif
+    // resize offset and size columns
+    qhelpers::adjustColumns(ui->treeView, 3, 0);
 }
 
 void FunctionsWidget::changeSizePolicy(QSizePolicy::Policy hor, QSizePolicy::Policy ver)
@@ -114,6 +114,7 @@ private slots:
     void showTitleContextMenu(const QPoint &pt);
     void setTooltipStylesheet();
     void refreshTree();
+    void functionsFetched(const QList<FunctionDescription> &functions);
 
 private:
     QSharedPointer<FunctionsTask> task;
@@ -1,6 +1,8 @@
 #include "GraphGridLayout.h"
 
 #include <cassert>
+#include <chrono>
+#include <functional>
 #include <stack>
 #include <unordered_map>
 #include <unordered_set>
@@ -8,6 +10,11 @@
 
 #include "common/BinaryTrees.h"
 
+#include <QRunnable>
+#include <QSemaphore>
+#include <QThread>
+#include <QThreadPool>
+
 /** @class GraphGridLayout
 
 Basic familiarity with graph algorithms is recommended.
@@ -309,6 +316,9 @@ void GraphGridLayout::CalculateLayout(
 
     auto blockOrder = topoSort(layoutState, entry);
     computeAllBlockPlacement(blockOrder, layoutState);
+    if (isCancelled()) {
+        return;
+    }
 
     for (auto &blockIt : blocks) {
         layoutState.edge[blockIt.first].resize(blockIt.second.edges.size());
@@ -350,7 +360,9 @@ void GraphGridLayout::CalculateLayout(
     routeEdges(layoutState);
 
     convertToPixelCoordinates(layoutState, width, height);
-    if (useLayoutOptimization) {
+    if (useLayoutOptimization && !isCancelled()) {
+        // the grid placement is complete, it can be shown while it's compacted
+        reportProgress(blocks, width, height);
         optimizeLayout(layoutState);
         cropToContent(blocks, width, height);
     }
@@ -1308,6 +1320,45 @@ void GraphGridLayout::connectEdgeEnds(GraphLayout::Graph &graph) const
 /// Either equality or inequality x_i <= x_j + c
 using Constraint = std::pair<std::pair<int, int>, int>;
 
+namespace {
+/**
+ * @brief Point at which the linear program optimizer stops improving the
+ * solution and returns the best one found so far.
+ */
+struct OptimizationLimit
+{
+    std::chrono::steady_clock::time_point deadline = std::chrono::steady_clock::time_point::max();
+    const std::atomic<bool> *cancelFlag = nullptr;
+
+    bool reached() const
+    {
+        return (cancelFlag && cancelFlag->load())
+               || std::chrono::steady_clock::now() >= deadline;
+    }
+};
+
+class LinearProgramRunnable : public QRunnable
+{
+public:
+    LinearProgramRunnable(std::function<void()> solve, QSemaphore *done)
+        : solve(std::move(solve))
+        , done(done)
+    {
+        setAutoDelete(false);
+    }
+
+    void run() override
+    {
+        solve();
+        done->release();
+    }
+
+private:
+    std::function<void()> solve;
+    QSemaphore *done;
+};
+} // namespace
+
 /**
  * @brief Single pass of linear program optimizer.
  * Changes variables until a constraint is hit, afterwards the two variables are
@@ -1320,6 +1371,8 @@ using Constraint = std::pair<std::pair<int, int>, int>;
  * @param solution input/output argument, returns results, needs to be
  * initialized with a feasible solution
  * @param stickWhenNotMoving variable grouping strategy
+ * @param limit once reached the remaining groups are left in place, the
+ * solution stays feasible
  */
 static void optimizeLinearProgramPass(
     size_t n,
@@ -1327,8 +1380,12 @@ static void optimizeLinearProgramPass(
     std::vector<Constraint> inequalities,
     std::vector<Constraint> equalities,
     std::vector<int> &solution,
-    bool stickWhenNotMoving)
+    bool stickWhenNotMoving,
+    const OptimizationLimit &limit)
 {
+    // groups processed between two checks of the limit
+    static const size_t LIMIT_CHECK_INTERVAL = 1024;
+
     std::vector<int> group(n);
     std::iota(group.begin(), group.end(),
               0); // initially each variable is in it's own group
@@ -1436,7 +1493,11 @@ static void optimizeLinearProgramPass(
             queue.push({edgeCount[i], i});
         }
     }
+    size_t iterations = 0;
     while (!queue.empty()) {
+        if (++iterations % LIMIT_CHECK_INTERVAL == 0 && limit.reached()) {
+            break;
+        }
         int g = queue.top().second;
         unsigned long size = queue.top().first;
         queue.pop();
@@ -1513,7 +1574,9 @@ static void optimizeLinearProgramPass(
 
 /**
  * @brief Linear programming solver
- * Does not guarantee optimal solution.
+ * Does not guarantee optimal solution. Variables which aren't connected by any
+ * constraint don't affect each other, so large programs are split in
+ * independent components that are solved in parallel.
  * @param n number of variables
  * @param objectiveFunction coefficients for function \f$\sum c_i x_i\f$ which
  * needs to be minimized
@@ -1521,13 +1584,15 @@ static void optimizeLinearProgramPass(
  * @param equalities equality constraints \f$x_{e_i} - x_{f_i} = b_i\f$
  * @param solution input/output argument, returns results, needs to be
  * initialized with a feasible solution
+ * @param limit when to return the solution found so far
  */
 static void optimizeLinearProgram(
     size_t n,
     const std::vector<int> &objectiveFunction,
     std::vector<Constraint> inequalities,
     const std::vector<Constraint> &equalities,
-    std::vector<int> &solution)
+    std::vector<int> &solution,
+    const OptimizationLimit &limit)
 {
     // Remove redundant inequalities
     std::sort(inequalities.begin(), inequalities.end());
@@ -1537,11 +1602,124 @@ static void optimizeLinearProgram(
         });
     inequalities.erase(uniqueEnd, inequalities.end());
 
-    static const int ITERATIONS = 1;
-    for (int i = 0; i < ITERATIONS; i++) {
-        optimizeLinearProgramPass(n, objectiveFunction, inequalities, equalities, solution, true);
-        // optimizeLinearProgramPass(n, objectiveFunction, inequalities,
-        // equalities, solution, false);
+    const size_t threadCount = size_t(std::max(QThread::idealThreadCount(), 1));
+    if (n < GRAPH_GRID_PARALLEL_MIN_VARIABLES || threadCount < 2) {
+        optimizeLinearProgramPass(
+            n, objectiveFunction, inequalities, equalities, solution, true, limit);
+        return;
+    }
+
+    std::vector<size_t> component(n);
+    std::iota(component.begin(), component.end(), 0);
+    auto getComponent = [&](size_t v) {
+        while (component[v] != v) {
+            component[v] = component[component[v]];
+            v = component[v];
+        }
+        return v;
+    };
+    auto joinComponents = [&](const Constraint &constraint) {
+        component[getComponent(constraint.first.first)] = getComponent(constraint.first.second);
+    };
+    for (const auto &constraint : inequalities) {
+        joinComponents(constraint);
+    }
+    for (const auto &constraint : equalities) {
+        joinComponents(constraint);
+    }
+
+    // Distribute the components over one batch per thread, biggest first to the
+    // least loaded batch. The batches are independent linear programs.
+    std::vector<size_t> componentCost(n, 0);
+    for (size_t i = 0; i < n; i++) {
+        componentCost[getComponent(i)]++;
+    }
+    for (const auto &constraint : inequalities) {
+        componentCost[getComponent(constraint.first.first)]++;
+    }
+    std::vector<size_t> roots;
+    for (size_t i = 0; i < n; i++) {
+        if (component[i] == i) {
+            roots.push_back(i);
+        }
+    }
+    std::sort(roots.begin(), roots.end(), [&](size_t a, size_t b) {
+        return componentCost[a] > componentCost[b];
+    });
+    const size_t batchCount = std::min(threadCount, roots.size());
+    if (batchCount < 2) {
+        optimizeLinearProgramPass(
+            n, objectiveFunction, inequalities, equalities, solution, true, limit);
+        return;
+    }
+    std::vector<size_t> batchCost(batchCount, 0);
+    std::vector<size_t> componentBatch(n);
+    for (size_t root : roots) {
+        size_t batch = std::min_element(batchCost.begin(), batchCost.end()) - batchCost.begin();
+        batchCost[batch] += componentCost[root];
+        componentBatch[root] = batch;
+    }
+
+    struct Batch
+    {
+        std::vector<size_t> variables;
+        std::vector<int> objectiveFunction;
+        std::vector<Constraint> inequalities;
+        std::vector<Constraint> equalities;
+        std::vector<int> solution;
+    };
+    // Variables keep their relative order within a batch, so each component is
+    // solved exactly like it would be as part of the whole program.
+    std::vector<Batch> batches(batchCount);
+    std::vector<int> localIndex(n);
+    for (size_t i = 0; i < n; i++) {
+        Batch &batch = batches[componentBatch[getComponent(i)]];
+        localIndex[i] = int(batch.variables.size());
+        batch.variables.push_back(i);
+        batch.objectiveFunction.push_back(objectiveFunction[i]);
+        batch.solution.push_back(solution[i]);
+    }
+    auto addConstraint = [&](const Constraint &constraint, bool equality) {
+        Batch &batch = batches[componentBatch[getComponent(constraint.first.first)]];
+        Constraint local
+            = {{localIndex[constraint.first.first], localIndex[constraint.first.second]},
+               constraint.second};
+        (equality ? batch.equalities : batch.inequalities).push_back(local);
+    };
+    for (const auto &constraint : inequalities) {
+        addConstraint(constraint, false);
+    }
+    for (const auto &constraint : equalities) {
+        addConstraint(constraint, true);
+    }
+
+    auto solveBatch = [&batches, &limit](size_t index) {
+        Batch &batch = batches[index];
+        optimizeLinearProgramPass(
+            batch.variables.size(),
+            std::move(batch.objectiveFunction),
+            std::move(batch.inequalities),
+            std::move(batch.equalities),
+            batch.solution,
+            true,
+            limit);
+    };
+    QSemaphore done;
+    std::vector<std::unique_ptr<LinearProgramRunnable>> runnables;
+    for (size_t i = 1; i < batchCount; i++) {
+        auto solve = [solveBatch, i]() { solveBatch(i); };
+        runnables.emplace_back(new LinearProgramRunnable(solve, &done));
+        if (!QThreadPool::globalInstance()->tryStart(runnables.back().get())) {
+            runnables.back()->run();
+        }
+    }
+    solveBatch(0);
+    done.acquire(int(runnables.size()));
+
+    for (const Batch &batch : batches) {
+        for (size_t i = 0; i < batch.variables.size(); i++) {
+            solution[batch.variables[i]] = batch.solution[i];
+        }
     }
 }
 
@@ -1641,6 +1819,13 @@ static void createInequalitiesFromSegments(
 
 void GraphGridLayout::optimizeLayout(GraphGridLayout::LayoutState &state) const
 {
+    OptimizationLimit limit;
+    limit.cancelFlag = cancelFlag;
+    if (optimizationTimeBudget > 0) {
+        limit.deadline = std::chrono::steady_clock::now()
+                         + std::chrono::milliseconds(optimizationTimeBudget);
+    }
+
     std::unordered_map<uint64_t, int> blockMapping;
     size_t blockIndex = 0;
     for (auto &blockIt : *state.blocks) {
@@ -1753,9 +1938,23 @@ void GraphGridLayout::optimizeLayout(GraphGridLayout::LayoutState &state) const
         inequalities);
 
     objectiveFunction.resize(solution.size());
-    optimizeLinearProgram(solution.size(), objectiveFunction, inequalities, equalities, solution);
+    if (isCancelled()) {
+        return;
+    }
+    optimizeLinearProgram(
+        solution.size(), objectiveFunction, inequalities, equalities, solution, limit);
     copyVariablesToPositions(solution, true);
     connectEdgeEnds(*state.blocks);
+    if (limit.reached()) {
+        // the blocks keep their grid columns
+        return;
+    }
+    if (progressCallback) {
+        Graph compacted = *state.blocks;
+        int width, height;
+        cropToContent(compacted, width, height);
+        reportProgress(compacted, width, height);
+    }
 
     // vertical segments
     variableGroups.resize(blockMapping.size());
@@ -1844,6 +2043,10 @@ void GraphGridLayout::optimizeLayout(GraphGridLayout::LayoutState &state) const
         }
     }
 
-    optimizeLinearProgram(solution.size(), objectiveFunction, inequalities, equalities, solution);
+    if (isCancelled()) {
+        return;
+    }
+    optimizeLinearProgram(
+        solution.size(), objectiveFunction, inequalities, equalities, solution, limit);
     copyVariablesToPositions(solution);
 }
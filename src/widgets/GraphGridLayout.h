@@ -5,6 +5,12 @@
 #include "common/LinkedListPool.h"
 #include "core/Iaito.h"
 
+// Default time in milliseconds the layout optimization may take before the
+// best layout found so far is used
+#define GRAPH_GRID_OPTIMIZATION_BUDGET_MS 2000
+// Smallest linear program which is split in components solved in parallel
+#define GRAPH_GRID_PARALLEL_MIN_VARIABLES 4096
+
 /**
  * @brief Graph layout algorithm on layered graph layout approach. For
  * simplicity all the nodes are placed in a grid.
@@ -20,10 +26,18 @@ public:
 
     GraphGridLayout(LayoutType layoutType = LayoutType::Medium);
     virtual void CalculateLayout(Graph &blocks, ut64 entry, int &width, int &height) const override;
+    std::unique_ptr<GraphLayout> clone() const override
+    {
+        return std::unique_ptr<GraphLayout>(new GraphGridLayout(*this));
+    }
     void setTightSubtreePlacement(bool enabled) { tightSubtreePlacement = enabled; }
     void setParentBetweenDirectChild(bool enabled) { parentBetweenDirectChild = enabled; }
     void setverticalBlockAlignmentMiddle(bool enabled) { verticalBlockAlignmentMiddle = enabled; }
     void setLayoutOptimization(bool enabled) { useLayoutOptimization = enabled; }
+    /**
+     * @brief Stop compacting the layout after \a milliseconds, 0 for no limit
+     */
+    void setOptimizationTimeBudget(int milliseconds) { optimizationTimeBudget = milliseconds; }
 
 private:
     /// false - use bounding box for smallest subtree when placing them side by
@@ -36,6 +50,7 @@ private:
     /// alignment
     bool verticalBlockAlignmentMiddle = false;
     bool useLayoutOptimization = true;
+    int optimizationTimeBudget = GRAPH_GRID_OPTIMIZATION_BUDGET_MS;
 
     struct GridBlock
     {
@@ -53,6 +53,23 @@ void GraphHorizontalAdapter::setLayoutConfig(const GraphLayout::LayoutConfig &co
     layout->setLayoutConfig(config);
 }
 
+std::unique_ptr<GraphLayout> GraphHorizontalAdapter::clone() const
+{
+    auto inner = layout->clone();
+    if (!inner) {
+        return nullptr;
+    }
+    auto *adapter = new GraphHorizontalAdapter(std::move(inner));
+    adapter->layoutConfig = layoutConfig;
+    return std::unique_ptr<GraphLayout>(adapter);
+}
+
+void GraphHorizontalAdapter::setCancelFlag(const std::atomic<bool> *flag)
+{
+    GraphLayout::setCancelFlag(flag);
+    layout->setCancelFlag(flag);
+}
+
 void GraphHorizontalAdapter::swapLayoutConfigDirection()
 {
     std::swap(layoutConfig.edgeVerticalSpacing, layoutConfig.edgeHorizontalSpacing);
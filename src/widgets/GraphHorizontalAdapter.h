@@ -14,6 +14,8 @@ public:
     virtual void CalculateLayout(
         GraphLayout::Graph &blocks, ut64 entry, int &width, int &height) const override;
     void setLayoutConfig(const LayoutConfig &config) override;
+    std::unique_ptr<GraphLayout> clone() const override;
+    void setCancelFlag(const std::atomic<bool> *flag) override;
 
 private:
     std::unique_ptr<GraphLayout> layout;
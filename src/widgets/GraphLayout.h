@@ -3,6 +3,9 @@
 
 #include "core/Iaito.h"
 
+#include <atomic>
+#include <functional>
+#include <memory>
 #include <unordered_map>
 
 class GraphLayout
@@ -47,9 +50,45 @@ public:
     virtual ~GraphLayout() {}
     virtual void CalculateLayout(Graph &blocks, ut64 entry, int &width, int &height) const = 0;
     virtual void setLayoutConfig(const LayoutConfig &config) { this->layoutConfig = config; };
+    const LayoutConfig &getLayoutConfig() const { return layoutConfig; }
+
+    /**
+     * @brief Independent copy of the layout with the same configuration that
+     * can be run on a worker thread.
+     * @return nullptr if the layout can only be computed on the GUI thread
+     */
+    virtual std::unique_ptr<GraphLayout> clone() const { return nullptr; }
+    /**
+     * @brief Flag polled by long running layouts. Once it is set
+     * CalculateLayout() may return early leaving a partial layout that must be
+     * discarded.
+     */
+    virtual void setCancelFlag(const std::atomic<bool> *flag) { cancelFlag = flag; }
+
+    /**
+     * @brief Called with a complete placement of the graph, its width and
+     * height
+     */
+    using ProgressCallback = std::function<void(const Graph &graph, int width, int height)>;
+    /**
+     * @brief Layouts which improve a complete placement in several steps pass
+     * each intermediate result to \a callback, called from the thread running
+     * CalculateLayout().
+     */
+    void setProgressCallback(ProgressCallback callback) { progressCallback = std::move(callback); }
 
 protected:
     LayoutConfig layoutConfig;
+    const std::atomic<bool> *cancelFlag = nullptr;
+    ProgressCallback progressCallback;
+
+    bool isCancelled() const { return cancelFlag && cancelFlag->load(); }
+    void reportProgress(const Graph &graph, int width, int height) const
+    {
+        if (progressCallback && !isCancelled()) {
+            progressCallback(graph, width, height);
+        }
+    }
 };
 
 #endif // GRAPHLAYOUT_H
@@ -0,0 +1,94 @@
+#ifndef GRAPHLAYOUTTASK_H
+#define GRAPHLAYOUTTASK_H
+
+#include "common/AsyncTask.h"
+#include "widgets/GraphLayout.h"
+
+#include <QMutex>
+
+#include <atomic>
+#include <memory>
+
+/**
+ * @brief Computes a graph layout on a worker thread.
+ *
+ * The task works on its own copy of the graph and of the layout, so the view
+ * can keep painting and handling input on its blocks meanwhile. Interrupting
+ * the task makes the layout return as soon as possible, the result must then
+ * be discarded. Intermediate placements reported by the layout are announced
+ * with intermediateLayoutReady() so they can be shown before it finishes.
+ */
+class GraphLayoutTask : public AsyncTask
+{
+    Q_OBJECT
+
+public:
+    using Ptr = QSharedPointer<GraphLayoutTask>;
+
+    GraphLayoutTask(const GraphLayout::Graph &graph, ut64 entry, std::unique_ptr<GraphLayout> layout)
+        : graph(graph)
+        , entry(entry)
+        , layout(std::move(layout))
+    {
+        this->layout->setCancelFlag(&cancelled);
+        this->layout->setProgressCallback(
+            [this](const GraphLayout::Graph &graph, int width, int height) {
+                {
+                    QMutexLocker locker(&intermediateMutex);
+                    intermediateGraph = graph;
+                    intermediateWidth = width;
+                    intermediateHeight = height;
+                    hasIntermediate = true;
+                }
+                emit intermediateLayoutReady();
+            });
+    }
+
+    QString getTitle() override { return tr("Computing graph layout"); }
+
+    void interrupt() override
+    {
+        cancelled = true;
+        AsyncTask::interrupt();
+    }
+
+    /**
+     * @brief Move the latest intermediate placement into \a graph
+     * @return false if there is none since the last call
+     */
+    bool takeIntermediateLayout(GraphLayout::Graph &graph, int &width, int &height)
+    {
+        QMutexLocker locker(&intermediateMutex);
+        if (!hasIntermediate) {
+            return false;
+        }
+        graph = std::move(intermediateGraph);
+        width = intermediateWidth;
+        height = intermediateHeight;
+        hasIntermediate = false;
+        return true;
+    }
+
+    GraphLayout::Graph graph;
+    int width = 0;
+    int height = 0;
+
+signals:
+    void intermediateLayoutReady();
+
+protected:
+    void runTask() override { layout->CalculateLayout(graph, entry, width, height); }
+
+private:
+    ut64 entry;
+    std::unique_ptr<GraphLayout> layout;
+    std::atomic<bool> cancelled{false};
+
+    QMutex intermediateMutex;
+    GraphLayout::Graph intermediateGraph;
+    int intermediateWidth = 0;
+    int intermediateHeight = 0;
+    bool hasIntermediate = false;
+};
+
+#endif // GRAPHLAYOUTTASK_H
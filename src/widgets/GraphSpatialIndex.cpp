@@ -0,0 +1,166 @@
+#include "GraphSpatialIndex.h"
+
+#include <algorithm>
+#include <cmath>
+
+// edges are inflated by this much so that arrow heads are included
+static const qreal EDGE_MARGIN = 8;
+// keep the grid size bounded for huge or very sparse graphs
+static const int MAX_CELLS = 1 << 18;
+static const qreal MIN_CELL_SIZE = 64;
+
+void GraphSpatialIndex::clear()
+{
+    valid = false;
+    columns = rows = 0;
+    blockIds.clear();
+    edges.clear();
+    blockCells.clear();
+    edgeCells.clear();
+    blockStamp.clear();
+    edgeStamp.clear();
+}
+
+void GraphSpatialIndex::build(const GraphLayout::Graph &graph)
+{
+    clear();
+    valid = true;
+    if (graph.empty()) {
+        return;
+    }
+
+    QRectF bounds;
+    for (const auto &it : graph) {
+        const auto &block = it.second;
+        bounds |= QRectF(block.x, block.y, block.width, block.height);
+        for (const auto &edge : block.edges) {
+            bounds |= edge.polyline.boundingRect();
+        }
+    }
+    bounds.adjust(-EDGE_MARGIN, -EDGE_MARGIN, EDGE_MARGIN, EDGE_MARGIN);
+
+    // about one block per cell on average
+    qreal area = std::max<qreal>(bounds.width() * bounds.height(), 1);
+    cellSize = std::max(MIN_CELL_SIZE, std::sqrt(area / graph.size()));
+    while ((std::ceil(bounds.width() / cellSize) * std::ceil(bounds.height() / cellSize))
+           > MAX_CELLS) {
+        cellSize *= 2;
+    }
+    originX = bounds.x();
+    originY = bounds.y();
+    columns = std::max(1, int(std::ceil(bounds.width() / cellSize)));
+    rows = std::max(1, int(std::ceil(bounds.height() / cellSize)));
+    blockCells.resize(size_t(columns) * rows);
+    edgeCells.resize(size_t(columns) * rows);
+
+    auto insert = [this](std::vector<std::vector<int>> &cells, const QRectF &rect, int item) {
+        int x0, y0, x1, y1;
+        if (!cellRange(rect, x0, y0, x1, y1)) {
+            return;
+        }
+        for (int y = y0; y <= y1; y++) {
+            for (int x = x0; x <= x1; x++) {
+                cells[size_t(y) * columns + x].push_back(item);
+            }
+        }
+    };
+
+    for (const auto &it : graph) {
+        const auto &block = it.second;
+        int blockIndex = int(blockIds.size());
+        blockIds.push_back(it.first);
+        insert(blockCells, QRectF(block.x, block.y, block.width, block.height), blockIndex);
+
+        for (size_t i = 0; i < block.edges.size(); i++) {
+            const QPolygonF &polyline = block.edges[i].polyline;
+            if (polyline.empty()) {
+                continue;
+            }
+            int edgeIndex = int(edges.size());
+            edges.push_back({it.first, i});
+            if (polyline.size() == 1) {
+                insert(edgeCells, QRectF(polyline.first(), QSizeF(0, 0)), edgeIndex);
+            }
+            for (int j = 1; j < polyline.size(); j++) {
+                QRectF segment = QRectF(polyline[j - 1], polyline[j]).normalized();
+                segment.adjust(-EDGE_MARGIN, -EDGE_MARGIN, EDGE_MARGIN, EDGE_MARGIN);
+                insert(edgeCells, segment, edgeIndex);
+            }
+        }
+    }
+
+    blockStamp.assign(blockIds.size(), 0);
+    edgeStamp.assign(edges.size(), 0);
+}
+
+bool GraphSpatialIndex::cellRange(const QRectF &rect, int &x0, int &y0, int &x1, int &y1) const
+{
+    if (!columns || !rows) {
+        return false;
+    }
+    x0 = int(std::floor((rect.left() - originX) / cellSize));
+    y0 = int(std::floor((rect.top() - originY) / cellSize));
+    x1 = int(std::floor((rect.right() - originX) / cellSize));
+    y1 = int(std::floor((rect.bottom() - originY) / cellSize));
+    if (x1 < 0 || y1 < 0 || x0 >= columns || y0 >= rows) {
+        return false;
+    }
+    x0 = std::max(x0, 0);
+    y0 = std::max(y0, 0);
+    x1 = std::min(x1, columns - 1);
+    y1 = std::min(y1, rows - 1);
+    return true;
+}
+
+unsigned GraphSpatialIndex::nextStamp() const
+{
+    if (++queryStamp == 0) {
+        // wrapped around, forget all the old stamps
+        std::fill(blockStamp.begin(), blockStamp.end(), 0);
+        std::fill(edgeStamp.begin(), edgeStamp.end(), 0);
+        queryStamp = 1;
+    }
+    return queryStamp;
+}
+
+std::vector<ut64> GraphSpatialIndex::blocksIn(const QRectF &rect) const
+{
+    std::vector<ut64> result;
+    int x0, y0, x1, y1;
+    if (!cellRange(rect, x0, y0, x1, y1)) {
+        return result;
+    }
+    unsigned stamp = nextStamp();
+    for (int y = y0; y <= y1; y++) {
+        for (int x = x0; x <= x1; x++) {
+            for (int item : blockCells[size_t(y) * columns + x]) {
+                if (blockStamp[item] != stamp) {
+                    blockStamp[item] = stamp;
+                    result.push_back(blockIds[item]);
+                }
+            }
+        }
+    }
+    return result;
+}
+
+std::vector<GraphSpatialIndex::EdgeRef> GraphSpatialIndex::edgesIn(const QRectF &rect) const
+{
+    std::vector<EdgeRef> result;
+    int x0, y0, x1, y1;
+    if (!cellRange(rect, x0, y0, x1, y1)) {
+        return result;
+    }
+    unsigned stamp = nextStamp();
+    for (int y = y0; y <= y1; y++) {
+        for (int x = x0; x <= x1; x++) {
+            for (int item : edgeCells[size_t(y) * columns + x]) {
+                if (edgeStamp[item] != stamp) {
+                    edgeStamp[item] = stamp;
+                    result.push_back(edges[item]);
+                }
+            }
+        }
+    }
+    return result;
+}
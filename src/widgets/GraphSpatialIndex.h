@@ -0,0 +1,66 @@
+#ifndef GRAPHSPATIALINDEX_H
+#define GRAPHSPATIALINDEX_H
+
+#include "widgets/GraphLayout.h"
+
+#include <QRectF>
+
+#include <vector>
+
+/**
+ * @brief Uniform grid over the block rectangles and edge segments of a laid
+ * out graph.
+ *
+ * Used by GraphView to paint and hit-test only the items near the visible or
+ * clicked area instead of walking the whole graph. The index refers to blocks
+ * by id and to edges by block id and position in GraphBlock::edges, so it must
+ * be rebuilt whenever the layout or the set of blocks changes.
+ */
+class GraphSpatialIndex
+{
+public:
+    struct EdgeRef
+    {
+        ut64 block;
+        size_t edge;
+    };
+
+    void build(const GraphLayout::Graph &graph);
+    void clear();
+    bool isValid() const { return valid; }
+    size_t blockCount() const { return blockIds.size(); }
+
+    /**
+     * @brief Ids of the blocks whose rectangle may intersect \a rect, each one
+     * listed once
+     */
+    std::vector<ut64> blocksIn(const QRectF &rect) const;
+    /**
+     * @brief Edges with a segment whose bounding box may intersect \a rect,
+     * each one listed once
+     */
+    std::vector<EdgeRef> edgesIn(const QRectF &rect) const;
+
+private:
+    bool valid = false;
+    qreal originX = 0;
+    qreal originY = 0;
+    qreal cellSize = 1;
+    int columns = 0;
+    int rows = 0;
+
+    std::vector<ut64> blockIds;
+    std::vector<EdgeRef> edges;
+    std::vector<std::vector<int>> blockCells;
+    std::vector<std::vector<int>> edgeCells;
+
+    // per item stamp of the last query that returned it, to skip duplicates
+    mutable std::vector<unsigned> blockStamp;
+    mutable std::vector<unsigned> edgeStamp;
+    mutable unsigned queryStamp = 0;
+
+    bool cellRange(const QRectF &rect, int &x0, int &y0, int &x1, int &y1) const;
+    unsigned nextStamp() const;
+};
+
+#endif // GRAPHSPATIALINDEX_H
@@ -7,12 +7,18 @@
 #include "GraphHorizontalAdapter.h"
 #include "Helpers.h"
 
+#include <algorithm>
+#include <cstdlib>
+#include <map>
 #include <vector>
 #include <QKeyEvent>
 #include <QMouseEvent>
 #include <QPainter>
+#include <QPainterPath>
+#include <QPixmap>
 #include <QPropertyAnimation>
 #include <QSvgGenerator>
+#include <QtMath>
 
 #if QT_VERSION >= QT_VERSION_CHECK(6, 0, 0)
 #define IAITO_NO_OPENGL_GRAPH 1
@@ -44,7 +50,10 @@ GraphView::GraphView(QWidget *parent)
     setGraphLayout(makeGraphLayout(Layout::GridMedium));
 }
 
-GraphView::~GraphView() {}
+GraphView::~GraphView()
+{
+    cancelGraphPlacement();
+}
 
 // Callbacks
 
@@ -95,6 +104,24 @@ GraphView::EdgeConfiguration GraphView::edgeConfiguration(
     return ec;
 }
 
+void GraphView::drawBlock(QPainter &p, GraphView::GraphBlock &block, bool interactive)
+{
+    drawSimplifiedBlock(p, block, getViewScale(), interactive);
+}
+
+QString GraphView::blockTitle(GraphView::GraphBlock &block)
+{
+    Q_UNUSED(block)
+    return QString();
+}
+
+QColor GraphView::blockFillColor(GraphView::GraphBlock &block, bool interactive)
+{
+    Q_UNUSED(block)
+    Q_UNUSED(interactive)
+    return QColor(Qt::gray);
+}
+
 void GraphView::blockContextMenuRequested(GraphView::GraphBlock &, QContextMenuEvent *, QPoint) {}
 
 bool GraphView::event(QEvent *event)
@@ -131,12 +158,277 @@ void GraphView::contextMenuEvent(QContextMenuEvent *event)
 
 void GraphView::computeGraphPlacement()
 {
-    graphLayoutSystem->CalculateLayout(blocks, entry, width, height);
+    cancelGraphPlacement();
+
+    std::unique_ptr<GraphLayout> backgroundLayout;
+    if (blocks.size() >= GRAPH_BACKGROUND_LAYOUT_MIN_BLOCKS) {
+        backgroundLayout = graphLayoutSystem->clone();
+    }
+    if (backgroundLayout) {
+        computeProvisionalPlacement();
+        layoutTask.reset(new GraphLayoutTask(blocks, entry, std::move(backgroundLayout)));
+        GraphLayoutTask *task = layoutTask.data();
+        connect(task, &AsyncTask::finished, this, [this, task]() {
+            if (layoutTask.data() == task) {
+                applyBackgroundPlacement();
+            }
+        });
+        connect(task, &GraphLayoutTask::intermediateLayoutReady, this, [this, task]() {
+            if (layoutTask.data() == task) {
+                applyIntermediatePlacement();
+            }
+        });
+        Core()->getAsyncTaskManager()->start(layoutTask);
+    } else {
+        graphLayoutSystem->CalculateLayout(blocks, entry, width, height);
+        placementValid = true;
+    }
+    invalidateSpatialIndex();
     setCacheDirty();
     clampViewOffset();
     viewport()->update();
 }
 
+void GraphView::cancelGraphPlacement()
+{
+    if (layoutTask) {
+        layoutTask->interrupt();
+        layoutTask.reset();
+        // the provisional placement stays
+        placementValid = false;
+    }
+}
+
+bool GraphView::reuseGraphPlacement(const GraphLayout::Graph &previous)
+{
+    if (!placementValid || layoutTask || previous.size() != blocks.size()) {
+        return false;
+    }
+    for (const auto &it : blocks) {
+        auto previousIt = previous.find(it.first);
+        if (previousIt == previous.end()) {
+            return false;
+        }
+        const auto &edges = it.second.edges;
+        const auto &previousEdges = previousIt->second.edges;
+        if (edges.size() != previousEdges.size()) {
+            return false;
+        }
+        for (size_t i = 0; i < edges.size(); i++) {
+            if (edges[i].target != previousEdges[i].target) {
+                return false;
+            }
+        }
+    }
+
+    struct Growth
+    {
+        ut64 id;
+        int dx;
+        int dy;
+    };
+    std::vector<Growth> grown;
+    for (auto &it : blocks) {
+        GraphBlock &block = it.second;
+        const GraphBlock &placed = previous.at(it.first);
+        int dx = std::max(block.width - placed.width, 0);
+        int dy = std::max(block.height - placed.height, 0);
+        block.x = placed.x;
+        block.y = placed.y;
+        block.width = placed.width;
+        block.height = placed.height;
+        for (size_t i = 0; i < block.edges.size(); i++) {
+            block.edges[i].polyline = placed.edges[i].polyline;
+            block.edges[i].arrow = placed.edges[i].arrow;
+        }
+        if (dx || dy) {
+            grown.push_back({it.first, dx, dy});
+        }
+    }
+    for (const Growth &growth : grown) {
+        growBlock(growth.id, growth.dx, growth.dy);
+    }
+
+    invalidateSpatialIndex();
+    setCacheDirty();
+    clampViewOffset();
+    viewport()->update();
+    return true;
+}
+
+/**
+ * @brief Make room for a block getting bigger by moving everything right of
+ * and below it. Edges crossing these lines are stretched, so they keep their
+ * horizontal and vertical segments.
+ */
+void GraphView::growBlock(ut64 id, int dx, int dy)
+{
+    GraphBlock &grown = blocks[id];
+    const int right = grown.x + grown.width;
+    const int bottom = grown.y + grown.height;
+    for (auto &it : blocks) {
+        GraphBlock &block = it.second;
+        if (block.x >= right) {
+            block.x += dx;
+        }
+        if (block.y >= bottom) {
+            block.y += dy;
+        }
+        for (auto &edge : block.edges) {
+            // the ends attached to the borders of the grown block follow them
+            const bool attached = it.first == id || edge.target == id;
+            for (QPointF &point : edge.polyline) {
+                if (point.x() > right || (attached && point.x() >= right)) {
+                    point.rx() += dx;
+                }
+                if (point.y() > bottom || (attached && point.y() >= bottom)) {
+                    point.ry() += dy;
+                }
+            }
+        }
+    }
+    grown.width += dx;
+    grown.height += dy;
+    width += dx;
+    height += dy;
+}
+
+/**
+ * @brief Quick placement used while the real layout is computed: blocks are
+ * put in rows by their BFS depth from the entry and edges are straight lines.
+ */
+void GraphView::computeProvisionalPlacement()
+{
+    if (blocks.empty()) {
+        return;
+    }
+    const auto &config = graphLayoutSystem->getLayoutConfig();
+    ut64 root = blocks.find(entry) != blocks.end() ? entry : blocks.begin()->first;
+
+    std::unordered_map<ut64, int> depth;
+    std::queue<ut64> queue;
+    int maxDepth = 0;
+    depth[root] = 0;
+    queue.push(root);
+    while (!queue.empty()) {
+        ut64 id = queue.front();
+        queue.pop();
+        int nextDepth = depth[id] + 1;
+        for (const auto &edge : blocks[id].edges) {
+            if (blocks.find(edge.target) != blocks.end() && depth.find(edge.target) == depth.end()) {
+                depth[edge.target] = nextDepth;
+                maxDepth = std::max(maxDepth, nextDepth);
+                queue.push(edge.target);
+            }
+        }
+    }
+
+    // unreachable blocks go in an extra row at the bottom
+    std::vector<ut64> ids;
+    ids.reserve(blocks.size());
+    for (const auto &it : blocks) {
+        ids.push_back(it.first);
+    }
+    std::sort(ids.begin(), ids.end());
+    std::vector<std::vector<ut64>> rows(maxDepth + 2);
+    for (ut64 id : ids) {
+        auto it = depth.find(id);
+        rows[it != depth.end() ? it->second : maxDepth + 1].push_back(id);
+    }
+
+    std::vector<int> rowWidth(rows.size(), 0);
+    width = 0;
+    for (size_t row = 0; row < rows.size(); row++) {
+        for (ut64 id : rows[row]) {
+            rowWidth[row] += blocks[id].width + config.blockHorizontalSpacing;
+        }
+        width = std::max(width, rowWidth[row]);
+    }
+
+    int y = 0;
+    for (size_t row = 0; row < rows.size(); row++) {
+        if (rows[row].empty()) {
+            continue;
+        }
+        int x = (width - rowWidth[row]) / 2;
+        int rowHeight = 0;
+        for (ut64 id : rows[row]) {
+            auto &block = blocks[id];
+            block.x = x;
+            block.y = y;
+            x += block.width + config.blockHorizontalSpacing;
+            rowHeight = std::max(rowHeight, block.height);
+        }
+        y += rowHeight + config.blockVerticalSpacing;
+    }
+    height = y;
+
+    for (auto &it : blocks) {
+        auto &block = it.second;
+        for (auto &edge : block.edges) {
+            edge.polyline.clear();
+            auto targetIt = blocks.find(edge.target);
+            if (targetIt == blocks.end()) {
+                continue;
+            }
+            const auto &target = targetIt->second;
+            QPointF start(block.x + block.width / 2, block.y + block.height);
+            QPointF end(target.x + target.width / 2, target.y);
+            edge.polyline << start << end;
+            edge.arrow = target.y > block.y ? GraphEdge::Down : GraphEdge::Up;
+        }
+    }
+}
+
+void GraphView::applyBackgroundPlacement()
+{
+    GraphLayoutTask::Ptr task = layoutTask;
+    layoutTask.reset();
+    if (task->isInterrupted()) {
+        return;
+    }
+    if (applyPlacement(task->graph, task->width, task->height)) {
+        placementValid = true;
+    }
+}
+
+void GraphView::applyIntermediatePlacement()
+{
+    GraphLayout::Graph graph;
+    int graphWidth, graphHeight;
+    if (layoutTask->takeIntermediateLayout(graph, graphWidth, graphHeight)) {
+        applyPlacement(graph, graphWidth, graphHeight);
+    }
+}
+
+bool GraphView::applyPlacement(GraphLayout::Graph &graph, int graphWidth, int graphHeight)
+{
+    if (graph.size() != blocks.size()) {
+        return false;
+    }
+    for (const auto &it : graph) {
+        if (blocks.find(it.first) == blocks.end()) {
+            return false;
+        }
+    }
+
+    beforeGraphPlacementUpdate();
+    for (auto &it : graph) {
+        auto &block = blocks[it.first];
+        block.x = it.second.x;
+        block.y = it.second.y;
+        block.edges = std::move(it.second.edges);
+    }
+    width = graphWidth;
+    height = graphHeight;
+    invalidateSpatialIndex();
+    setCacheDirty();
+    clampViewOffset();
+    viewport()->update();
+    afterGraphPlacementUpdate();
+    return true;
+}
+
 void GraphView::cleanupEdges(GraphLayout::Graph &graph)
 {
     for (auto &blockIt : graph) {
@@ -178,20 +470,11 @@ void GraphView::setViewScale(qreal scale)
 
 QSize GraphView::getCacheSize()
 {
-    return
 #ifndef IAITO_NO_OPENGL_GRAPH
-        useGL ? cacheSize :
+    return cacheSize;
+#else
+    return QSize();
 #endif
-              pixmap.size();
-}
-
-qreal GraphView::getCacheDevicePixelRatioF()
-{
-    return
-#ifndef IAITO_NO_OPENGL_GRAPH
-        useGL ? 1.0 :
-#endif
-              qhelpers::devicePixelRatio(&pixmap);
 }
 
 QSize GraphView::getRequiredCacheSize()
@@ -199,58 +482,159 @@ QSize GraphView::getRequiredCacheSize()
     return viewport()->size() * qhelpers::devicePixelRatio(this);
 }
 
-qreal GraphView::getRequiredCacheDevicePixelRatioF()
-{
-    return
-#ifndef IAITO_NO_OPENGL_GRAPH
-        useGL ? 1.0f :
-#endif
-              qhelpers::devicePixelRatio(this);
-}
-
 void GraphView::paintEvent(QPaintEvent *)
 {
-#ifndef IAITO_NO_OPENGL_GRAPH
-    if (useGL) {
-        glWidget->makeCurrent();
+    if (!useGL) {
+        QPainter p(viewport());
+        paintTiles(p);
+        return;
     }
-#endif
+#ifndef IAITO_NO_OPENGL_GRAPH
+    glWidget->makeCurrent();
 
-    if (!qFuzzyCompare(getCacheDevicePixelRatioF(), getRequiredCacheDevicePixelRatioF())
-        || getCacheSize() != getRequiredCacheSize()) {
+    // the framebuffer holds exactly the viewport, it follows every move
+    if (getCacheSize() != getRequiredCacheSize() || cacheOffset != offset
+        || !qFuzzyCompare(cacheScale, current_scale)) {
         setCacheDirty();
     }
 
     if (cacheDirty) {
         paintGraphCache();
         cacheDirty = false;
+        cacheOffset = offset;
+        cacheScale = current_scale;
     }
 
-    if (useGL) {
-#ifndef IAITO_NO_OPENGL_GRAPH
-        auto gl = glWidget->context()->extraFunctions();
-        gl->glBindFramebuffer(GL_READ_FRAMEBUFFER, cacheFBO);
-        gl->glBindFramebuffer(GL_DRAW_FRAMEBUFFER, glWidget->defaultFramebufferObject());
-        auto dpr = qhelpers::devicePixelRatio(this);
-        gl->glBlitFramebuffer(
-            0,
-            0,
-            cacheSize.width(),
-            cacheSize.height(),
-            0,
-            0,
-            viewport()->width() * dpr,
-            viewport()->height() * dpr,
-            GL_COLOR_BUFFER_BIT,
-            GL_NEAREST);
-        glWidget->doneCurrent();
+    auto gl = glWidget->context()->extraFunctions();
+    gl->glBindFramebuffer(GL_READ_FRAMEBUFFER, cacheFBO);
+    gl->glBindFramebuffer(GL_DRAW_FRAMEBUFFER, glWidget->defaultFramebufferObject());
+    auto dpr = qhelpers::devicePixelRatio(this);
+    gl->glBlitFramebuffer(
+        0,
+        0,
+        cacheSize.width(),
+        cacheSize.height(),
+        0,
+        0,
+        viewport()->width() * dpr,
+        viewport()->height() * dpr,
+        GL_COLOR_BUFFER_BIT,
+        GL_NEAREST);
+    glWidget->doneCurrent();
 #endif
-    } else {
-        QPainter p(viewport());
-        p.drawPixmap(QPoint(0, 0), pixmap);
+}
+
+static inline int floorDiv(int a, int b)
+{
+    return a >= 0 ? a / b : -((-a + b - 1) / b);
+}
+
+static inline quint64 tileKey(int column, int row)
+{
+    return (quint64(quint32(row)) << 32) | quint32(column);
+}
+
+void GraphView::paintTiles(QPainter &p)
+{
+    const qreal dpr = qhelpers::devicePixelRatio(this);
+    if (cacheDirty || !qFuzzyCompare(tilesScale, current_scale)
+        || !qFuzzyCompare(tilesDevicePixelRatio, dpr)) {
+        tiles.clear();
+        tilesScale = current_scale;
+        tilesDevicePixelRatio = dpr;
+        cacheDirty = false;
+    }
+
+    // The tiles are aligned in the scaled graph, independently of the view
+    // offset: panning only renders the tiles that weren't visible before.
+    const QPoint origin = scaledViewOrigin();
+    const QRect visible(origin, viewport()->size());
+    const int firstColumn = floorDiv(visible.left(), GRAPH_TILE_SIZE);
+    const int lastColumn = floorDiv(visible.right(), GRAPH_TILE_SIZE);
+    const int firstRow = floorDiv(visible.top(), GRAPH_TILE_SIZE);
+    const int lastRow = floorDiv(visible.bottom(), GRAPH_TILE_SIZE);
+
+    for (int row = firstRow; row <= lastRow; row++) {
+        for (int column = firstColumn; column <= lastColumn; column++) {
+            auto tileIt = tiles.find(tileKey(column, row));
+            if (tileIt == tiles.end()) {
+                tileIt = tiles.emplace(tileKey(column, row), renderTile(column, row)).first;
+            }
+            QPoint position(column * GRAPH_TILE_SIZE, row * GRAPH_TILE_SIZE);
+            p.drawPixmap(position - origin, tileIt->second);
+        }
+    }
+
+    const size_t visibleTiles = size_t(lastRow - firstRow + 1) * (lastColumn - firstColumn + 1);
+    const size_t maxTiles = std::max<size_t>(GRAPH_MAX_CACHED_TILES, 2 * visibleTiles);
+    if (tiles.size() <= maxTiles) {
+        return;
+    }
+    // drop the tiles farthest from the view
+    const QPoint center = visible.center() / GRAPH_TILE_SIZE;
+    std::vector<std::pair<int, quint64>> byDistance;
+    byDistance.reserve(tiles.size());
+    for (const auto &tile : tiles) {
+        int column = qint32(quint32(tile.first));
+        int row = qint32(quint32(tile.first >> 32));
+        int distance = std::abs(column - center.x()) + std::abs(row - center.y());
+        byDistance.emplace_back(distance, tile.first);
+    }
+    std::sort(byDistance.begin(), byDistance.end());
+    for (size_t i = maxTiles; i < byDistance.size(); i++) {
+        tiles.erase(byDistance[i].second);
+    }
+}
+
+QPixmap GraphView::renderTile(int column, int row)
+{
+    const qreal dpr = tilesDevicePixelRatio;
+    QPixmap tile(QSize(GRAPH_TILE_SIZE, GRAPH_TILE_SIZE) * dpr);
+    tile.setDevicePixelRatio(dpr);
+    tile.fill(backgroundColor);
+
+    QRectF area(
+        QPointF(column * GRAPH_TILE_SIZE, row * GRAPH_TILE_SIZE) / current_scale,
+        QSizeF(GRAPH_TILE_SIZE, GRAPH_TILE_SIZE) / current_scale);
+    QPainter p(&tile);
+    p.setRenderHint(QPainter::Antialiasing);
+    p.scale(current_scale, current_scale);
+    p.translate(-area.topLeft());
+    paintArea(p, area, current_scale, true);
+    return tile;
+}
+
+QPoint GraphView::scaledViewOrigin() const
+{
+    return QPoint(qRound(offset.x() * current_scale), qRound(offset.y() * current_scale));
+}
+
+void GraphView::invalidateArea(const QRectF &area)
+{
+    if (tiles.empty()) {
+        return;
+    }
+    // cover antialiasing and the arrows touching the border
+    const qreal margin = 8;
+    QRectF scaled(
+        area.topLeft() * current_scale - QPointF(margin, margin),
+        area.bottomRight() * current_scale + QPointF(margin, margin));
+    const int firstColumn = qFloor(scaled.left() / GRAPH_TILE_SIZE);
+    const int lastColumn = qFloor(scaled.right() / GRAPH_TILE_SIZE);
+    const int firstRow = qFloor(scaled.top() / GRAPH_TILE_SIZE);
+    const int lastRow = qFloor(scaled.bottom() / GRAPH_TILE_SIZE);
+    for (int row = firstRow; row <= lastRow; row++) {
+        for (int column = firstColumn; column <= lastColumn; column++) {
+            tiles.erase(tileKey(column, row));
+        }
     }
 }
 
+void GraphView::invalidateBlock(const GraphBlock &block)
+{
+    invalidateArea(QRectF(block.x, block.y, block.width, block.height));
+}
+
 void GraphView::clampViewOffset()
 {
     const qreal edgeFraction = 0.25;
@@ -275,163 +659,237 @@ void GraphView::addViewOffset(QPoint move, bool emitSignal)
     setViewOffsetInternal(offset + move, emitSignal);
 }
 
+#ifndef IAITO_NO_OPENGL_GRAPH
 void GraphView::paintGraphCache()
 {
-#ifndef IAITO_NO_OPENGL_GRAPH
     std::unique_ptr<QOpenGLPaintDevice> paintDevice;
-#endif
     QPainter p;
-    if (useGL) {
-#ifndef IAITO_NO_OPENGL_GRAPH
-        auto gl = QOpenGLContext::currentContext()->functions();
-
-        bool resizeTex = false;
-        QSize sizeNeed = getRequiredCacheSize();
-        if (!cacheTexture) {
-            gl->glGenTextures(1, &cacheTexture);
-            gl->glBindTexture(GL_TEXTURE_2D, cacheTexture);
-            gl->glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MIN_FILTER, GL_NEAREST);
-            gl->glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MAG_FILTER, GL_NEAREST);
-            gl->glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MAG_FILTER, GL_NEAREST);
-            gl->glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_S, GL_CLAMP_TO_EDGE);
-            gl->glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_T, GL_CLAMP_TO_EDGE);
-            resizeTex = true;
-        } else if (cacheSize != sizeNeed) {
-            gl->glBindTexture(GL_TEXTURE_2D, cacheTexture);
-            resizeTex = true;
-        }
-        if (resizeTex) {
-            cacheSize = sizeNeed;
-            gl->glTexImage2D(
-                GL_TEXTURE_2D,
-                0,
-                GL_RGBA,
-                cacheSize.width(),
-                cacheSize.height(),
-                0,
-                GL_RGBA,
-                GL_UNSIGNED_BYTE,
-                nullptr);
-            gl->glGenFramebuffers(1, &cacheFBO);
-            gl->glBindFramebuffer(GL_FRAMEBUFFER, cacheFBO);
-            gl->glFramebufferTexture2D(
-                GL_FRAMEBUFFER, GL_COLOR_ATTACHMENT0, GL_TEXTURE_2D, cacheTexture, 0);
-        } else {
-            gl->glBindFramebuffer(GL_FRAMEBUFFER, cacheFBO);
-        }
-        gl->glViewport(0, 0, viewport()->width(), viewport()->height());
-        gl->glClearColor(
-            backgroundColor.redF(), backgroundColor.greenF(), backgroundColor.blueF(), 1.0f);
-        gl->glClear(GL_COLOR_BUFFER_BIT);
-
-        paintDevice.reset(new QOpenGLPaintDevice(cacheSize));
-        p.begin(paintDevice.get());
-#endif
+    auto gl = QOpenGLContext::currentContext()->functions();
+
+    bool resizeTex = false;
+    QSize sizeNeed = getRequiredCacheSize();
+    if (!cacheTexture) {
+        gl->glGenTextures(1, &cacheTexture);
+        gl->glBindTexture(GL_TEXTURE_2D, cacheTexture);
+        gl->glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MIN_FILTER, GL_NEAREST);
+        gl->glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MAG_FILTER, GL_NEAREST);
+        gl->glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MAG_FILTER, GL_NEAREST);
+        gl->glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_S, GL_CLAMP_TO_EDGE);
+        gl->glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_T, GL_CLAMP_TO_EDGE);
+        resizeTex = true;
+    } else if (cacheSize != sizeNeed) {
+        gl->glBindTexture(GL_TEXTURE_2D, cacheTexture);
+        resizeTex = true;
+    }
+    if (resizeTex) {
+        cacheSize = sizeNeed;
+        gl->glTexImage2D(
+            GL_TEXTURE_2D,
+            0,
+            GL_RGBA,
+            cacheSize.width(),
+            cacheSize.height(),
+            0,
+            GL_RGBA,
+            GL_UNSIGNED_BYTE,
+            nullptr);
+        gl->glGenFramebuffers(1, &cacheFBO);
+        gl->glBindFramebuffer(GL_FRAMEBUFFER, cacheFBO);
+        gl->glFramebufferTexture2D(
+            GL_FRAMEBUFFER, GL_COLOR_ATTACHMENT0, GL_TEXTURE_2D, cacheTexture, 0);
     } else {
-        auto dpr = qhelpers::devicePixelRatio(this);
-        pixmap = QPixmap(getRequiredCacheSize() * dpr);
-        pixmap.setDevicePixelRatio(dpr);
-        pixmap.fill(backgroundColor);
-        p.begin(&pixmap);
-        p.setRenderHint(QPainter::Antialiasing);
-        p.setViewport(this->viewport()->rect());
+        gl->glBindFramebuffer(GL_FRAMEBUFFER, cacheFBO);
     }
+    gl->glViewport(0, 0, viewport()->width(), viewport()->height());
+    gl->glClearColor(
+        backgroundColor.redF(), backgroundColor.greenF(), backgroundColor.blueF(), 1.0f);
+    gl->glClear(GL_COLOR_BUFFER_BIT);
+
+    paintDevice.reset(new QOpenGLPaintDevice(cacheSize));
+    p.begin(paintDevice.get());
     paint(p, offset, this->viewport()->rect(), current_scale);
 
     p.end();
 }
+#endif
 
 void GraphView::paint(QPainter &p, QPoint offset, QRect viewport, qreal scale, bool interactive)
 {
-    QPointF offsetF(offset.x(), offset.y());
-    p.setBrush(Qt::black);
-
     int render_width = viewport.width();
     int render_height = viewport.height();
 
     // window - rectangle in logical coordinates
     QRect window = QRect(offset, QSize(qRound(render_width / scale), qRound(render_height / scale)));
     p.setWindow(window);
-    QRectF windowF(window.x(), window.y(), window.width(), window.height());
+    paintArea(p, QRectF(window), scale, interactive);
+}
+
+void GraphView::paintArea(QPainter &p, const QRectF &windowF, qreal scale, bool interactive)
+{
+    p.setBrush(Qt::black);
+
+    const bool simplifiedBlocks = scale < blockDetailScale;
+    const bool simplifiedEdges = scale < edgeDetailScale;
+    if (simplifiedBlocks) {
+        p.setFont(font());
+    }
 
-    for (auto &blockIt : blocks) {
-        GraphBlock &block = blockIt.second;
+    const GraphSpatialIndex &index = spatialIndex();
+    for (ut64 id : index.blocksIn(windowF)) {
+        auto blockIt = blocks.find(id);
+        if (blockIt == blocks.end()) {
+            continue;
+        }
+        GraphBlock &block = blockIt->second;
 
         QRectF blockRect(block.x, block.y, block.width, block.height);
 
         // Check if block is visible by checking if block intersects with view
         // area
-        if (blockRect.intersects(windowF)) {
+        if (!blockRect.intersects(windowF)) {
+            continue;
+        }
+        if (simplifiedBlocks) {
+            drawSimplifiedBlock(p, block, scale, interactive);
+        } else {
             drawBlock(p, block, interactive);
         }
+    }
 
-        p.setBrush(Qt::gray);
+    p.setBrush(Qt::gray);
 
-        // Always draw edges
-        // TODO: Only draw edges if they are actually visible ...
-        // Draw edges
-        for (GraphEdge &edge : block.edges) {
-            if (edge.polyline.empty()) {
-                continue;
-            }
-            QPolygonF polyline = edge.polyline;
-            EdgeConfiguration ec = edgeConfiguration(block, &blocks[edge.target], interactive);
-            QPen pen(ec.color);
-            pen.setStyle(ec.lineStyle);
-            pen.setWidthF(pen.width() * ec.width_scale);
-            if (scale_thickness_multiplier && ec.width_scale > 1.01 && pen.widthF() * scale < 2) {
-                pen.setWidthF(ec.width_scale / scale);
-            }
-            if (pen.widthF() * scale < 2) {
-                pen.setWidth(0);
-            }
-            p.setPen(pen);
-            p.setBrush(ec.color);
-            p.drawPolyline(polyline);
-            pen.setStyle(Qt::SolidLine);
-            p.setPen(pen);
-
-            auto drawArrow = [&](QPointF tip, QPointF dir) {
-                pen.setWidth(0);
-                p.setPen(pen);
-                QPolygonF arrow;
-                arrow << tip;
-                QPointF dy(-dir.y(), dir.x());
-                QPointF base = tip - dir * 6;
-                arrow << base + 3 * dy;
-                arrow << base - 3 * dy;
-                p.drawConvexPolygon(arrow);
-            };
-
-            if (!polyline.empty()) {
-                if (ec.start_arrow) {
-                    auto firstPt = edge.polyline.first();
-                    drawArrow(firstPt, QPointF(0, 1));
-                }
-                if (ec.end_arrow) {
-                    auto lastPt = edge.polyline.last();
-                    QPointF dir(0, -1);
-                    switch (edge.arrow) {
-                    case GraphLayout::GraphEdge::Down:
-                        dir = QPointF(0, 1);
-                        break;
-                    case GraphLayout::GraphEdge::Up:
-                        dir = QPointF(0, -1);
-                        break;
-                    case GraphLayout::GraphEdge::Left:
-                        dir = QPointF(-1, 0);
-                        break;
-                    case GraphLayout::GraphEdge::Right:
-                        dir = QPointF(1, 0);
-                        break;
-                    default:
-                        break;
-                    }
-                    drawArrow(lastPt, dir);
-                }
-            }
+    // Draw the edges passing through the view area, when zoomed out the
+    // edges of the same style are batched in a single path
+    std::map<std::pair<QRgb, int>, QPainterPath> edgePaths;
+    for (const auto &edgeRef : index.edgesIn(windowF)) {
+        auto blockIt = blocks.find(edgeRef.block);
+        if (blockIt == blocks.end() || edgeRef.edge >= blockIt->second.edges.size()) {
+            continue;
         }
+        GraphBlock &block = blockIt->second;
+        GraphEdge &edge = block.edges[edgeRef.edge];
+        if (edge.polyline.empty()) {
+            continue;
+        }
+        if (!simplifiedEdges) {
+            drawEdge(p, block, edge, scale, interactive);
+            continue;
+        }
+        EdgeConfiguration ec = edgeConfiguration(block, &blocks[edge.target], interactive);
+        edgePaths[{ec.color.rgba(), int(ec.lineStyle)}].addPolygon(edge.polyline);
+    }
+    p.setBrush(Qt::NoBrush);
+    for (const auto &it : edgePaths) {
+        QPen pen(QColor::fromRgba(it.first.first), 0);
+        pen.setStyle(Qt::PenStyle(it.first.second));
+        p.setPen(pen);
+        p.drawPath(it.second);
+    }
+}
+
+void GraphView::drawEdge(
+    QPainter &p, GraphBlock &block, GraphEdge &edge, qreal scale, bool interactive)
+{
+    QPolygonF polyline = edge.polyline;
+    EdgeConfiguration ec = edgeConfiguration(block, &blocks[edge.target], interactive);
+    QPen pen(ec.color);
+    pen.setStyle(ec.lineStyle);
+    pen.setWidthF(pen.width() * ec.width_scale);
+    if (scale_thickness_multiplier && ec.width_scale > 1.01 && pen.widthF() * scale < 2) {
+        pen.setWidthF(ec.width_scale / scale);
+    }
+    if (pen.widthF() * scale < 2) {
+        pen.setWidth(0);
+    }
+    p.setPen(pen);
+    p.setBrush(ec.color);
+    p.drawPolyline(polyline);
+    pen.setStyle(Qt::SolidLine);
+    p.setPen(pen);
+
+    auto drawArrow = [&](QPointF tip, QPointF dir) {
+        pen.setWidth(0);
+        p.setPen(pen);
+        QPolygonF arrow;
+        arrow << tip;
+        QPointF dy(-dir.y(), dir.x());
+        QPointF base = tip - dir * 6;
+        arrow << base + 3 * dy;
+        arrow << base - 3 * dy;
+        p.drawConvexPolygon(arrow);
+    };
+
+    if (ec.start_arrow) {
+        auto firstPt = edge.polyline.first();
+        drawArrow(firstPt, QPointF(0, 1));
+    }
+    if (ec.end_arrow) {
+        auto lastPt = edge.polyline.last();
+        QPointF dir(0, -1);
+        switch (edge.arrow) {
+        case GraphLayout::GraphEdge::Down:
+            dir = QPointF(0, 1);
+            break;
+        case GraphLayout::GraphEdge::Up:
+            dir = QPointF(0, -1);
+            break;
+        case GraphLayout::GraphEdge::Left:
+            dir = QPointF(-1, 0);
+            break;
+        case GraphLayout::GraphEdge::Right:
+            dir = QPointF(1, 0);
+            break;
+        default:
+            break;
+        }
+        drawArrow(lastPt, dir);
+    }
+}
+
+void GraphView::drawSimplifiedBlock(QPainter &p, GraphBlock &block, qreal scale, bool interactive)
+{
+    QRectF blockRect(block.x, block.y, block.width, block.height);
+    QColor fill = blockFillColor(block, interactive);
+    p.setPen(QPen(fill.darker(150), 0));
+    p.setBrush(fill);
+    p.drawRect(blockRect);
+
+    auto titleIt = blockTitles.find(block.entry);
+    if (titleIt == blockTitles.end()) {
+        QStaticText title(blockTitle(block));
+        title.setTextFormat(Qt::PlainText);
+        title.prepare(QTransform(), p.font());
+        titleIt = blockTitles.emplace(block.entry, std::move(title)).first;
+    }
+    const QStaticText &title = titleIt->second;
+    if (title.text().isEmpty()) {
+        return;
+    }
+
+    // the title keeps its size on screen, skip it when it doesn't fit
+    const qreal margin = 2;
+    QSizeF titleSize = title.size();
+    if (titleSize.width() + 2 * margin > block.width * scale
+        || titleSize.height() + 2 * margin > block.height * scale) {
+        return;
     }
+    p.save();
+    p.translate(block.x, block.y);
+    p.scale(1 / scale, 1 / scale);
+    p.setPen(palette().color(QPalette::WindowText));
+    p.drawStaticText(QPointF(margin, margin), title);
+    p.restore();
+}
+
+void GraphView::setDetailScales(qreal blockScale, qreal edgeScale)
+{
+    if (qFuzzyCompare(blockScale, blockDetailScale) && qFuzzyCompare(edgeScale, edgeDetailScale)) {
+        return;
+    }
+    blockDetailScale = blockScale;
+    edgeDetailScale = edgeScale;
+    setCacheDirty();
+    viewport()->update();
 }
 
 void GraphView::saveAsBitmap(QString path, const char *format, double scaler, bool transparent)
@@ -528,8 +986,12 @@ void GraphView::showRectangle(const QRect &block, bool anywhere)
 GraphView::GraphBlock *GraphView::getBlockContaining(QPoint p)
 {
     // Check if a block was clicked
-    for (auto &blockIt : blocks) {
-        GraphBlock &block = blockIt.second;
+    for (ut64 id : spatialIndex().blocksIn(QRectF(p, QSizeF(0, 0)))) {
+        auto blockIt = blocks.find(id);
+        if (blockIt == blocks.end()) {
+            continue;
+        }
+        GraphBlock &block = blockIt->second;
 
         QRect rec(block.x, block.y, block.width, block.height);
         if (rec.contains(p)) {
@@ -555,10 +1017,18 @@ void GraphView::setGraphLayout(std::unique_ptr<GraphLayout> layout)
     if (!graphLayoutSystem) {
         graphLayoutSystem = makeGraphLayout(Layout::GridMedium);
     }
+    placementValid = false;
 }
 
 void GraphView::setLayoutConfig(const GraphLayout::LayoutConfig &config)
 {
+    const auto &current = graphLayoutSystem->getLayoutConfig();
+    if (config.blockVerticalSpacing != current.blockVerticalSpacing
+        || config.blockHorizontalSpacing != current.blockHorizontalSpacing
+        || config.edgeVerticalSpacing != current.edgeVerticalSpacing
+        || config.edgeHorizontalSpacing != current.edgeHorizontalSpacing) {
+        placementValid = false;
+    }
     graphLayoutSystem->setLayoutConfig(config);
 }
 
@@ -631,6 +1101,16 @@ std::unique_ptr<GraphLayout> GraphView::makeGraphLayout(GraphView::Layout layout
 void GraphView::addBlock(GraphView::GraphBlock block)
 {
     blocks[block.entry] = block;
+    invalidateSpatialIndex();
+}
+
+const GraphSpatialIndex &GraphView::spatialIndex()
+{
+    // blocks is accessible to subclasses, catch at least additions and removals
+    if (!spatialIndexData.isValid() || spatialIndexData.blockCount() != blocks.size()) {
+        spatialIndexData.build(blocks);
+    }
+    return spatialIndexData;
 }
 
 void GraphView::setEntry(ut64 e)
@@ -670,26 +1150,28 @@ void GraphView::mousePressEvent(QMouseEvent *event)
 
     // Check if a line beginning/end  was clicked
     if (event->button() == Qt::LeftButton) {
-        for (auto &blockIt : blocks) {
-            GraphBlock &block = blockIt.second;
-            for (GraphEdge &edge : block.edges) {
-                if (edge.polyline.length() < 2) {
-                    continue;
-                }
-                QPointF start = edge.polyline.first();
-                QPointF end = edge.polyline.last();
-                if (checkPointClicked(start, pos.x(), pos.y())) {
-                    showBlock(blocks[edge.target]);
-                    // TODO: Callback to child
-                    return;
-                    break;
-                }
-                if (checkPointClicked(end, pos.x(), pos.y(), true)) {
-                    showBlock(block);
-                    // TODO: Callback to child
-                    return;
-                    break;
-                }
+        QRectF clickArea(pos.x() - 16, pos.y() - 16, 32, 32);
+        for (const auto &edgeRef : spatialIndex().edgesIn(clickArea)) {
+            auto blockIt = blocks.find(edgeRef.block);
+            if (blockIt == blocks.end() || edgeRef.edge >= blockIt->second.edges.size()) {
+                continue;
+            }
+            GraphBlock &block = blockIt->second;
+            GraphEdge &edge = block.edges[edgeRef.edge];
+            if (edge.polyline.length() < 2) {
+                continue;
+            }
+            QPointF start = edge.polyline.first();
+            QPointF end = edge.polyline.last();
+            if (checkPointClicked(start, pos.x(), pos.y())) {
+                showBlock(blocks[edge.target]);
+                // TODO: Callback to child
+                return;
+            }
+            if (checkPointClicked(end, pos.x(), pos.y(), true)) {
+                showBlock(block);
+                // TODO: Callback to child
+                return;
             }
         }
     }
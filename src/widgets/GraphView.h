@@ -7,7 +7,9 @@
 #include <QHelpEvent>
 #include <QObject>
 #include <QPainter>
+#include <QPixmap>
 #include <QScrollBar>
+#include <QStaticText>
 #include <QWidget>
 
 #include <memory>
@@ -17,6 +19,16 @@
 
 #include "core/Iaito.h"
 #include "widgets/GraphLayout.h"
+#include "widgets/GraphLayoutTask.h"
+#include "widgets/GraphSpatialIndex.h"
+
+// graphs with at least this many blocks are laid out in the background
+#define GRAPH_BACKGROUND_LAYOUT_MIN_BLOCKS 300
+// side of the cached graph tiles, in device independent pixels
+#define GRAPH_TILE_SIZE 256
+// tiles kept in memory besides twice the visible ones, the farthest from the
+// view are dropped first
+#define GRAPH_MAX_CACHED_TILES 96
 
 #if defined(QT_NO_OPENGL) || QT_VERSION < QT_VERSION_CHECK(5, 6, 0)
 // QOpenGLExtraFunctions were introduced in 5.6
@@ -97,11 +109,42 @@ public:
 
     void paint(QPainter &p, QPoint offset, QRect area, qreal scale = 1.0, bool interactive = true);
 
+    /**
+     * @brief Set the level of detail thresholds.
+     * Below \a blockScale blocks are painted as filled rectangles with their
+     * title instead of calling drawBlock(). Below \a edgeScale edges are
+     * painted as one path per color, without arrows.
+     */
+    void setDetailScales(qreal blockScale, qreal edgeScale);
+
     void saveAsBitmap(
         QString path, const char *format = nullptr, double scaler = 1.0, bool transparent = false);
     void saveAsSvg(QString path);
 
+    /**
+     * @brief Lays out the blocks with the current layout. Big graphs first get
+     * a quick layered placement and the real layout is computed in the
+     * background, replacing it when ready.
+     */
     void computeGraphPlacement();
+    /**
+     * @brief Stops a background layout, its result will not be applied.
+     */
+    void cancelGraphPlacement();
+    /**
+     * @brief Keep the placement of \a previous for blocks that were reloaded
+     * with the same ids and edges, instead of laying them out again.
+     * Blocks that got bigger push away what is right of and below them, blocks
+     * that got smaller keep their size.
+     * @param previous the blocks as they were placed before reloading
+     * @return false if the graph changed and computeGraphPlacement() is needed
+     */
+    bool reuseGraphPlacement(const GraphLayout::Graph &previous);
+    /**
+     * @brief Lay out the graph from scratch on the next load, e.g. when every
+     * block changes size.
+     */
+    void invalidateGraphPlacement() { placementValid = false; }
 
     /**
      * @brief Remove duplicate edges and edges without target in graph.
@@ -117,19 +160,39 @@ protected:
     // Padding inside the block
     int block_padding = 16;
 
+    /**
+     * @brief Render everything again on the next paint.
+     */
     void setCacheDirty() { cacheDirty = true; }
+    /**
+     * @brief Render again only the cached tiles intersecting \a area, in
+     * logical coordinates. Call viewport()->update() afterwards.
+     */
+    void invalidateArea(const QRectF &area);
+    void invalidateBlock(const GraphBlock &block);
+    /**
+     * @brief Must be called when blocks are moved, added or removed without
+     * going through computeGraphPlacement() or addBlock(). Also drops the
+     * cached block titles.
+     */
+    void invalidateSpatialIndex()
+    {
+        spatialIndexData.clear();
+        blockTitles.clear();
+    }
+    const GraphSpatialIndex &spatialIndex();
 
     void addBlock(GraphView::GraphBlock block);
     void setEntry(ut64 e);
 
     // Callbacks that should be overridden
     /**
-     * @brief drawBlock
+     * @brief drawBlock, by default the block is painted as when zoomed out
      * @param p painter object, not necesarily current widget
      * @param block
      * @param interactive - can be used for disabling elemnts during export
      */
-    virtual void drawBlock(QPainter &p, GraphView::GraphBlock &block, bool interactive = true) = 0;
+    virtual void drawBlock(QPainter &p, GraphView::GraphBlock &block, bool interactive = true);
     virtual void blockClicked(GraphView::GraphBlock &block, QMouseEvent *event, QPoint pos);
     virtual void blockDoubleClicked(GraphView::GraphBlock &block, QMouseEvent *event, QPoint pos);
     virtual void blockHelpEvent(GraphView::GraphBlock &block, QHelpEvent *event, QPoint pos);
@@ -138,6 +201,15 @@ protected:
     virtual void wheelEvent(QWheelEvent *event) override;
     virtual EdgeConfiguration edgeConfiguration(
         GraphView::GraphBlock &from, GraphView::GraphBlock *to, bool interactive = true);
+    /**
+     * @brief Label painted in a block when zoomed out below the block detail
+     * scale, queried once per block until invalidateSpatialIndex()
+     */
+    virtual QString blockTitle(GraphView::GraphBlock &block);
+    /**
+     * @brief Fill color of a block when zoomed out below the block detail scale
+     */
+    virtual QColor blockFillColor(GraphView::GraphBlock &block, bool interactive);
     virtual bool gestureEvent(QGestureEvent *event);
     /**
      * @brief Called when user requested context menu for a block. Should open a
@@ -150,6 +222,12 @@ protected:
      */
     virtual void blockContextMenuRequested(
         GraphView::GraphBlock &block, QContextMenuEvent *event, QPoint pos);
+    /**
+     * @brief Called before and after a layout computed in the background
+     * replaces the provisional one, e.g. to keep the focused block in view.
+     */
+    virtual void beforeGraphPlacementUpdate() {}
+    virtual void afterGraphPlacementUpdate() {}
 
     bool event(QEvent *event) override;
     void contextMenuEvent(QContextMenuEvent *event) override;
@@ -176,7 +254,38 @@ private:
     void centerX(bool emitSignal);
     void centerY(bool emitSignal);
 
+    void paintArea(QPainter &p, const QRectF &windowF, qreal scale, bool interactive);
+    void paintTiles(QPainter &p);
+    QPixmap renderTile(int column, int row);
+    QPoint scaledViewOrigin() const;
+#ifndef IAITO_NO_OPENGL_GRAPH
     void paintGraphCache();
+#endif
+
+    void computeProvisionalPlacement();
+    void applyBackgroundPlacement();
+    /**
+     * @brief Show the layout task's placement so far until it finishes
+     */
+    void applyIntermediatePlacement();
+    bool applyPlacement(GraphLayout::Graph &graph, int graphWidth, int graphHeight);
+    void growBlock(ut64 id, int dx, int dy);
+    GraphLayoutTask::Ptr layoutTask;
+    /**
+     * @brief whether the blocks are placed by the current layout, and not by
+     * a provisional placement or another layout configuration
+     */
+    bool placementValid = false;
+
+    GraphSpatialIndex spatialIndexData;
+
+    // Level of detail, everything is drawn in full until setDetailScales()
+    qreal blockDetailScale = 0;
+    qreal edgeDetailScale = 0;
+    std::unordered_map<ut64, QStaticText> blockTitles;
+
+    void drawSimplifiedBlock(QPainter &p, GraphBlock &block, qreal scale, bool interactive);
+    void drawEdge(QPainter &p, GraphBlock &block, GraphEdge &edge, qreal scale, bool interactive);
 
     bool checkPointClicked(QPointF &point, int x, int y, bool above_y = false);
 
@@ -197,14 +306,19 @@ private:
     bool useGL;
 
     /**
-     * @brief pixmap that caches the graph nodes
+     * @brief rendered tiles of the graph at tilesScale, keyed by row and
+     * column. Moving the view only renders the tiles that become visible.
      */
-    QPixmap pixmap;
+    std::unordered_map<quint64, QPixmap> tiles;
+    qreal tilesScale = 0;
+    qreal tilesDevicePixelRatio = 0;
 
 #ifndef IAITO_NO_OPENGL_GRAPH
     uint32_t cacheTexture;
     uint32_t cacheFBO;
     QSize cacheSize;
+    QPoint cacheOffset;
+    qreal cacheScale = 0;
     QOpenGLWidget *glWidget;
 #endif
 
@@ -214,9 +328,7 @@ private:
      */
     bool cacheDirty = true;
     QSize getCacheSize();
-    qreal getCacheDevicePixelRatioF();
     QSize getRequiredCacheSize();
-    qreal getRequiredCacheDevicePixelRatioF();
 
     void beginMouseDrag(QMouseEvent *event);
 
@@ -1,5 +1,6 @@
 #include "HeadersWidget.h"
 #include "common/Helpers.h"
+#include "common/RefreshScheduler.h"
 #include "core/MainWindow.h"
 #include "ui_ListDockWidget.h"
 
@@ -128,8 +129,8 @@ HeadersWidget::HeadersWidget(MainWindow *main)
     ui->quickFilterView->closeFilter();
     showCount(false);
 
-    connect(Core(), &IaitoCore::codeRebased, this, &HeadersWidget::refreshHeaders);
-    connect(Core(), &IaitoCore::refreshAll, this, &HeadersWidget::refreshHeaders);
+    Core()->getRefreshScheduler()->subscribe(
+        this, RefreshScheduler::Rebased, &HeadersWidget::refreshHeaders);
     connect(Core(), &IaitoCore::commentsChanged, this, [this]() {
         qhelpers::emitColumnChanged(headersModel, HeadersModel::CommentColumn);
     });
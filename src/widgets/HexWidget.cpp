@@ -316,8 +316,9 @@ HexWidget::HexWidget(QWidget *parent)
 
     startAddress = 0ULL;
     cursor.address = 0ULL;
-    data.reset(new MemoryData());
-    oldData.reset(new MemoryData());
+    IOPageCache::Ptr pageCache(new IOPageCache());
+    data.reset(new MemoryData(pageCache));
+    oldData.reset(new MemoryData(pageCache));
 
     fetchData();
     updateCursorMeta();
@@ -937,6 +938,7 @@ void HexWidget::w_writeString()
     QString str = d.getText(this, tr("Write string"), tr("String:"), QLineEdit::Normal, "", &ok);
     if (ok && !str.isEmpty()) {
         Core()->cmdRawAt(QStringLiteral("w %1").arg(str), getLocationAddress());
+        Core()->bumpIOGeneration();
         refresh();
     }
 }
@@ -958,6 +960,7 @@ void HexWidget::w_increaseDecrease()
             .arg(mode)
             .arg(QString::number(d.getValue())),
         getLocationAddress());
+    Core()->bumpIOGeneration();
     refresh();
 }
 
@@ -978,6 +981,7 @@ void HexWidget::w_writeZeros()
         d.getInt(this, tr("Write zeros"), tr("Number of zeros:"), size, 1, 0x7FFFFFFF, 1, &ok));
     if (ok && !str.isEmpty()) {
         Core()->cmdRawAt(QStringLiteral("w0 %1").arg(str), getLocationAddress());
+        Core()->bumpIOGeneration();
         refresh();
     }
 }
@@ -1011,6 +1015,7 @@ void HexWidget::w_write64()
         QStringLiteral("w6%1 %2").arg(mode).arg(
             (mode == "e" ? str.toHex() : str).toStdString().c_str()),
         getLocationAddress());
+    Core()->bumpIOGeneration();
     refresh();
 }
 
@@ -1030,6 +1035,7 @@ void HexWidget::w_writeRandom()
         d.getInt(this, tr("Write random"), tr("Number of bytes:"), size, 1, 0x7FFFFFFF, 1, &ok));
     if (ok && !nbytes.isEmpty()) {
         Core()->cmdRawAt(QStringLiteral("wr %1").arg(nbytes), getLocationAddress());
+        Core()->bumpIOGeneration();
         refresh();
     }
 }
@@ -1047,6 +1053,7 @@ void HexWidget::w_duplFromOffset()
     RVA copyFrom = d.getOffset();
     QString nBytes = QString::number(d.getNBytes());
     Core()->cmdRawAt(QStringLiteral("wd %1 %2").arg(copyFrom).arg(nBytes), getLocationAddress());
+    Core()->bumpIOGeneration();
     refresh();
 }
 
@@ -1062,6 +1069,7 @@ void HexWidget::w_writePascalString()
         = d.getText(this, tr("Write Pascal string"), tr("String:"), QLineEdit::Normal, "", &ok);
     if (ok && !str.isEmpty()) {
         Core()->cmdRawAt(QStringLiteral("ws %1").arg(str), getLocationAddress());
+        Core()->bumpIOGeneration();
         refresh();
     }
 }
@@ -1078,6 +1086,7 @@ void HexWidget::w_writeWideString()
         = d.getText(this, tr("Write wide string"), tr("String:"), QLineEdit::Normal, "", &ok);
     if (ok && !str.isEmpty()) {
         Core()->cmdRawAt(QStringLiteral("ww %1").arg(str), getLocationAddress());
+        Core()->bumpIOGeneration();
         refresh();
     }
 }
@@ -1094,6 +1103,7 @@ void HexWidget::w_writeCString()
         this, tr("Write zero-terminated string"), tr("String:"), QLineEdit::Normal, "", &ok);
     if (ok && !str.isEmpty()) {
         Core()->cmdRawAt(QStringLiteral("wz %1").arg(str), getLocationAddress());
+        Core()->bumpIOGeneration();
         refresh();
     }
 }
@@ -1132,6 +1142,7 @@ void HexWidget::writeNumber(int byteCount)
         hex = rev;
     }
     Core()->cmdRawAt(QStringLiteral("wx %1").arg(hex), getLocationAddress());
+    Core()->bumpIOGeneration();
     refresh();
 }
 
@@ -3,6 +3,7 @@
 
 #include "Iaito.h"
 #include "common/IOModesController.h"
+#include "common/IOPageCache.h"
 #include "dialogs/HexdumpRangeDialog.h"
 
 #include <memory>
@@ -125,14 +126,15 @@ private:
 class MemoryData : public AbstractData
 {
 public:
-    MemoryData() {}
+    MemoryData(const IOPageCache::Ptr &cache)
+        : m_cache(cache)
+    {}
     ~MemoryData() override {}
-    static constexpr size_t BLOCK_SIZE = 4096;
+    static constexpr size_t BLOCK_SIZE = IOPageCache::PAGE_SIZE;
 
     void fetch(uint64_t address, int length) override
     {
-        // FIXME: reuse data if possible
-        const uint64_t blockSize = 0x1000ULL;
+        const uint64_t blockSize = BLOCK_SIZE;
         uint64_t alignedAddr = address & ~(blockSize - 1);
         int offset = address - alignedAddr;
         int len = (offset + length + (blockSize - 1)) & ~(blockSize - 1);
@@ -145,7 +147,10 @@ public:
         m_blocks.clear();
         uint64_t addr = alignedAddr;
         for (ut64 i = 0; i < len / blockSize; ++i, addr += blockSize) {
-            m_blocks.append(Core()->ioRead(addr, blockSize));
+            m_blocks.append(m_cache->page(addr));
+        }
+        if (length) {
+            IOPageCache::readAhead(m_cache, m_firstBlockAddr, m_lastValidAddr);
         }
     }
 
@@ -179,6 +184,7 @@ public:
     virtual uint64_t minIndex() override { return m_firstBlockAddr; }
 
 private:
+    IOPageCache::Ptr m_cache;
     QVector<QByteArray> m_blocks;
     uint64_t m_firstBlockAddr = 0;
     uint64_t m_lastValidAddr = 0;
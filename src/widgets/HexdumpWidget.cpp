@@ -3,6 +3,7 @@
 
 #include "common/Configuration.h"
 #include "common/Helpers.h"
+#include "common/RefreshScheduler.h"
 #include "common/SyntaxHighlighter.h"
 #include "common/TempConfig.h"
 #include "core/MainWindow.h"
@@ -153,11 +154,11 @@ HexdumpWidget::HexdumpWidget(MainWindow *main)
     this->ui->hexTextView->addAction(&syncAction);
 
     connect(Config(), &Configuration::fontsUpdated, this, &HexdumpWidget::fontsUpdated);
-    connect(Core(), &IaitoCore::refreshAll, this, [this]() { refresh(); });
-    connect(Core(), &IaitoCore::refreshCodeViews, this, [this]() { refresh(); });
-    connect(Core(), &IaitoCore::instructionChanged, this, [this]() { refresh(); });
-    connect(Core(), &IaitoCore::stackChanged, this, [this]() { refresh(); });
-    connect(Core(), &IaitoCore::registersChanged, this, [this]() { refresh(); });
+    Core()->getRefreshScheduler()->subscribe(
+        this,
+        RefreshScheduler::CodeViews | RefreshScheduler::Instructions | RefreshScheduler::Stack
+            | RefreshScheduler::Registers,
+        [this]() { refresh(); });
 
     connect(seekable, &IaitoSeekable::seekableSeekChanged, this, &HexdumpWidget::onSeekChanged);
     connect(ui->hexTextView, &HexWidget::positionChanged, this, [this](RVA addr) {
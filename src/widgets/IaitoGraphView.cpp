@@ -31,7 +31,10 @@ IaitoGraphView::IaitoGraphView(QWidget *parent)
     , actionExportGraph(tr("Export Graph"), this)
     , graphLayout(GraphView::Layout::GridMedium)
 {
-    connect(Core(), &IaitoCore::graphOptionsChanged, this, &IaitoGraphView::refreshView);
+    connect(Core(), &IaitoCore::graphOptionsChanged, this, [this]() {
+        invalidateGraphPlacement();
+        refreshView();
+    });
     connect(Config(), &Configuration::colorsUpdated, this, &IaitoGraphView::colorsUpdatedSlot);
     connect(Config(), &Configuration::fontsUpdated, this, &IaitoGraphView::fontsUpdatedSlot);
 
@@ -203,6 +206,7 @@ void IaitoGraphView::updateLayout()
 
 void IaitoGraphView::fontsUpdatedSlot()
 {
+    invalidateGraphPlacement();
     initFont();
     refreshView();
 }
@@ -261,6 +265,7 @@ void IaitoGraphView::refreshView()
 {
     initFont();
     setLayoutConfig(getLayoutConfig());
+    setDetailScales(Config()->getGraphBlockDetailScale(), Config()->getGraphEdgeDetailScale());
 }
 
 bool IaitoGraphView::gestureEvent(QGestureEvent *event)
@@ -323,6 +328,17 @@ void IaitoGraphView::saveCurrentBlock() {}
 
 void IaitoGraphView::restoreCurrentBlock() {}
 
+void IaitoGraphView::beforeGraphPlacementUpdate()
+{
+    saveCurrentBlock();
+}
+
+void IaitoGraphView::afterGraphPlacementUpdate()
+{
+    restoreCurrentBlock();
+    emit viewRefreshed();
+}
+
 void IaitoGraphView::mousePressEvent(QMouseEvent *event)
 {
     GraphView::mousePressEvent(event);
@@ -125,6 +125,9 @@ protected:
      */
     virtual void restoreCurrentBlock();
 
+    void beforeGraphPlacementUpdate() override;
+    void afterGraphPlacementUpdate() override;
+
     void initFont();
     QPoint getTextOffset(int line) const;
     GraphLayout::LayoutConfig getLayoutConfig();
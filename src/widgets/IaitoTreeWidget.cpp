@@ -23,6 +23,14 @@ void IaitoTreeWidget::showItemsNumber(int count)
     }
 }
 
+void IaitoTreeWidget::showItemsNumber(int count, qint64 done, qint64 total)
+{
+    if (bar) {
+        int percent = total > 0 ? static_cast<int>(100.0 * done / total) : 100;
+        bar->showMessage(tr("%1 Items (loading %2%)").arg(count).arg(percent));
+    }
+}
+
 void IaitoTreeWidget::showStatusBar(bool show)
 {
     bar->setVisible(show);
@@ -17,6 +17,12 @@ public:
     ~IaitoTreeWidget();
     void addStatusBar(QVBoxLayout *pos);
     void showItemsNumber(int count);
+    /**
+     * @brief Show the number of items while the list is still being loaded
+     * @param done part of the list loaded so far, in items or bytes
+     * @param total size of the whole list in the same unit as \a done
+     */
+    void showItemsNumber(int count, qint64 done, qint64 total);
     void showStatusBar(bool show);
 
 private:
@@ -1,6 +1,7 @@
 #include "ImportsWidget.h"
 #include "WidgetShortcuts.h"
 #include "common/Helpers.h"
+#include "common/RefreshScheduler.h"
 #include "core/MainWindow.h"
 #include "ui_ListDockWidget.h"
 
@@ -202,8 +203,8 @@ ImportsWidget::ImportsWidget(MainWindow *main)
     QShortcut *toggle_shortcut = new QShortcut(widgetShortcuts["ImportsWidget"], main);
     connect(toggle_shortcut, &QShortcut::activated, this, [=]() { toggleDockWidget(true); });
 
-    connect(Core(), &IaitoCore::codeRebased, this, &ImportsWidget::refreshImports);
-    connect(Core(), &IaitoCore::refreshAll, this, &ImportsWidget::refreshImports);
+    Core()->getRefreshScheduler()->subscribe(
+        this, RefreshScheduler::Rebased, &ImportsWidget::refreshImports);
     /*
         connect(Core(), &IaitoCore::commentsChanged, this, [this]() {
             qhelpers::emitColumnChanged(importsModel,
@@ -1,5 +1,6 @@
 #include "widgets/MapsWidget.h"
 #include "common/Helpers.h"
+#include "common/RefreshScheduler.h"
 #include "core/MainWindow.h"
 #include <QAbstractItemView>
 #include <QCheckBox>
@@ -207,7 +208,8 @@ MapsWidget::MapsWidget(MainWindow *main)
     loadBanks();
     // Refresh banks and maps when the core triggers a refresh (e.g., after binary load)
     refreshDeferrer = createRefreshDeferrer([this]() { loadBanks(); });
-    connect(Core(), &IaitoCore::refreshAll, this, &MapsWidget::loadBanks);
+    Core()->getRefreshScheduler()->subscribe(
+        this, RefreshScheduler::Nothing, &MapsWidget::loadBanks);
 }
 
 MapsWidget::~MapsWidget() = default;
@@ -1,5 +1,6 @@
 #include "MemoryMapWidget.h"
 #include "common/Helpers.h"
+#include "common/RefreshScheduler.h"
 #include "core/MainWindow.h"
 #include "ui_ListDockWidget.h"
 #include <QShortcut>
@@ -129,8 +130,8 @@ MemoryMapWidget::MemoryMapWidget(MainWindow *main)
 
     refreshDeferrer = createRefreshDeferrer([this]() { refreshMemoryMap(); });
 
-    connect(Core(), &IaitoCore::refreshAll, this, &MemoryMapWidget::refreshMemoryMap);
-    connect(Core(), &IaitoCore::registersChanged, this, &MemoryMapWidget::refreshMemoryMap);
+    Core()->getRefreshScheduler()->subscribe(
+        this, RefreshScheduler::Registers, &MemoryMapWidget::refreshMemoryMap);
     connect(Core(), &IaitoCore::commentsChanged, this, [this]() {
         qhelpers::emitColumnChanged(memoryModel, MemoryMapModel::CommentColumn);
     });
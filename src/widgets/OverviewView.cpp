@@ -1,6 +1,7 @@
 #include "OverviewView.h"
 #include <QMouseEvent>
 #include <QPainter>
+#include <QtNumeric>
 
 #include "common/Colors.h"
 #include "common/Configuration.h"
@@ -16,6 +17,8 @@ OverviewView::OverviewView(QWidget *parent)
 {
     connect(Config(), &Configuration::colorsUpdated, this, &OverviewView::colorsUpdatedSlot);
     colorsUpdatedSlot();
+    // only the shape of the graph is shown, never draw the block contents
+    setDetailScales(qInf(), qInf());
 }
 
 void OverviewView::setData(
@@ -27,6 +30,7 @@ void OverviewView::setData(
     width = baseWidth;
     height = baseHeight;
     blocks = baseBlocks;
+    invalidateSpatialIndex();
     edgeConfigurations = baseEdgeConfigurations;
     scaleAndCenter();
     setCacheDirty();
@@ -56,28 +60,16 @@ void OverviewView::refreshView()
     viewport()->update();
 }
 
-void OverviewView::drawBlock(QPainter &p, GraphView::GraphBlock &block, bool interactive)
+QColor OverviewView::blockFillColor(GraphView::GraphBlock &block, bool interactive)
 {
     Q_UNUSED(interactive)
-    QRectF blockRect(block.x, block.y, block.width, block.height);
-
-    p.setPen(Qt::black);
-    p.setBrush(Qt::gray);
-    p.drawRect(blockRect);
-    p.setBrush(QColor(0, 0, 0, 100));
-    p.drawRect(blockRect.translated(2, 2));
-
-    // Draw basic block highlighting/tracing
-    auto bb = Core()->getBBHighlighter()->getBasicBlock(block.entry);
-    if (bb) {
+    // Basic block highlighting/tracing
+    if (auto bb = Core()->getBBHighlighter()->getBasicBlock(block.entry)) {
         QColor color(bb->color);
         color.setAlphaF(0.5);
-        p.setBrush(color);
-    } else {
-        p.setBrush(disassemblyBackgroundColor);
+        return color;
     }
-    p.setPen(QPen(graphNodeColor, 1));
-    p.drawRect(blockRect);
+    return disassemblyBackgroundColor;
 }
 
 void OverviewView::paintEvent(QPaintEvent *event)
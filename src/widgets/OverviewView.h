@@ -106,9 +106,10 @@ private:
     void scaleAndCenter();
 
     /**
-     * @brief draw the computed blocks passed by Graph
+     * @brief color of the blocks, the overview always paints the simplified
+     * blocks of GraphView
      */
-    virtual void drawBlock(QPainter &p, GraphView::GraphBlock &block, bool interactive) override;
+    virtual QColor blockFillColor(GraphView::GraphBlock &block, bool interactive) override;
 
     /**
      * @brief override the edgeConfiguration so as to
@@ -1,6 +1,7 @@
 #include "ProcessesWidget.h"
 #include "QuickFilterView.h"
 #include "common/JsonModel.h"
+#include "common/RefreshScheduler.h"
 #include "ui_ProcessesWidget.h"
 #include <r_debug.h>
 #include <QShortcut>
@@ -54,11 +55,11 @@ ProcessesWidget::ProcessesWidget(MainWindow *main)
         &QuickFilterView::filterTextChanged,
         modelFilter,
         &ProcessesFilterModel::setFilterWildcard);
-    connect(Core(), &IaitoCore::refreshAll, this, &ProcessesWidget::updateContents);
-    connect(Core(), &IaitoCore::registersChanged, this, &ProcessesWidget::updateContents);
-    connect(Core(), &IaitoCore::debugTaskStateChanged, this, &ProcessesWidget::updateContents);
-    // Seek doesn't necessarily change when switching processes
-    connect(Core(), &IaitoCore::switchedProcess, this, &ProcessesWidget::updateContents);
+    // Seek doesn't necessarily change when switching processes, hence Debug
+    Core()->getRefreshScheduler()->subscribe(
+        this,
+        RefreshScheduler::Registers | RefreshScheduler::Debug,
+        &ProcessesWidget::updateContents);
     connect(Config(), &Configuration::fontsUpdated, this, &ProcessesWidget::fontsUpdatedSlot);
     connect(ui->viewProcesses, &QTableView::activated, this, &ProcessesWidget::onActivated);
 }
@@ -92,6 +92,7 @@ void GenericR2GraphView::loadCurrentGraph()
 {
     blockContent.clear();
     blocks.clear();
+    setCacheDirty();
 
     if (graphCommand.isEmpty()) {
         return;
@@ -1,5 +1,6 @@
 #include "RegisterRefsWidget.h"
 #include "common/Helpers.h"
+#include "common/RefreshScheduler.h"
 #include "core/MainWindow.h"
 #include "ui_RegisterRefsWidget.h"
 
@@ -167,8 +168,8 @@ RegisterRefsWidget::RegisterRefsWidget(MainWindow *main)
         ui->registerRefTreeView->setFocus();
     });
     setScrollMode();
-    connect(Core(), &IaitoCore::refreshAll, this, &RegisterRefsWidget::refreshRegisterRef);
-    connect(Core(), &IaitoCore::registersChanged, this, &RegisterRefsWidget::refreshRegisterRef);
+    Core()->getRefreshScheduler()->subscribe(
+        this, RefreshScheduler::Registers, &RegisterRefsWidget::refreshRegisterRef);
     connect(Core(), &IaitoCore::commentsChanged, this, [this]() {
         qhelpers::emitColumnChanged(registerRefModel, RegisterRefModel::CommentColumn);
     });
@@ -200,14 +201,14 @@ void RegisterRefsWidget::refreshRegisterRef()
 
     registerRefModel->beginResetModel();
 
-    QList<QJsonObject> regRefs = Core()->getRegisterRefs();
+    QList<TelescopeDescription> regRefs = Core()->getRegisterRefs();
     registerRefs.clear();
-    for (const QJsonObject &reg : regRefs) {
+    for (const TelescopeDescription &reg : regRefs) {
         RegisterRefDescription desc;
 
-        desc.value = RAddressString(reg["value"].toVariant().toULongLong());
-        desc.reg = reg["name"].toVariant().toString();
-        desc.refDesc = Core()->formatRefDesc(reg["ref"].toObject());
+        desc.value = RAddressString(reg.value);
+        desc.reg = reg.reg;
+        desc.refDesc = reg.refDesc;
 
         registerRefs.push_back(desc);
     }
@@ -1,5 +1,6 @@
 #include "RegistersWidget.h"
 #include "common/JsonModel.h"
+#include "common/RefreshScheduler.h"
 #include "ui_RegistersWidget.h"
 
 #include "core/MainWindow.h"
@@ -22,8 +23,8 @@ RegistersWidget::RegistersWidget(MainWindow *main)
 
     refreshDeferrer = createRefreshDeferrer([this]() { updateContents(); });
 
-    connect(Core(), &IaitoCore::refreshAll, this, &RegistersWidget::updateContents);
-    connect(Core(), &IaitoCore::registersChanged, this, &RegistersWidget::updateContents);
+    Core()->getRefreshScheduler()->subscribe(
+        this, RefreshScheduler::Registers, &RegistersWidget::updateContents);
 
     // Hide shortcuts because there is no way of selecting an item and triger
     // them
@@ -50,6 +51,7 @@ void RegistersWidget::setRegisterGrid()
     QLabel *registerLabel;
     QLineEdit *registerEditValue;
     const auto registerRefs = Core()->getRegisterRefValues();
+    const QSet<QString> changedRegisters = Core()->getChangedRegisters();
 
     registerLen = registerRefs.size();
     for (auto &reg : registerRefs) {
@@ -94,7 +96,7 @@ void RegistersWidget::setRegisterGrid()
             registerEditValue = qobject_cast<QLineEdit *>(regValueWidget);
         }
         // decide to highlight QLine Box in case of change of register value
-        if (reg.value != registerEditValue->text() && registerEditValue->text() != "") {
+        if (changedRegisters.contains(reg.name)) {
             registerEditValue->setStyleSheet("border: 1px solid green;");
         } else {
             // reset stylesheet
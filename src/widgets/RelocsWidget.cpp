@@ -1,5 +1,6 @@
 #include "RelocsWidget.h"
 #include "common/Helpers.h"
+#include "common/RefreshScheduler.h"
 #include "core/MainWindow.h"
 #include "ui_ListDockWidget.h"
 
@@ -174,8 +175,8 @@ RelocsWidget::RelocsWidget(MainWindow *main)
     setModels(relocsProxyModel);
     ui->treeView->sortByColumn(RelocsModel::NameColumn, Qt::AscendingOrder);
 
-    connect(Core(), &IaitoCore::codeRebased, this, &RelocsWidget::refreshRelocs);
-    connect(Core(), &IaitoCore::refreshAll, this, &RelocsWidget::refreshRelocs);
+    Core()->getRefreshScheduler()->subscribe(
+        this, RefreshScheduler::Rebased, &RelocsWidget::refreshRelocs);
     connect(Core(), &IaitoCore::commentsChanged, this, [this]() {
         qhelpers::emitColumnChanged(relocsModel, RelocsModel::CommentColumn);
     });
@@ -1,5 +1,6 @@
 #include "ResourcesWidget.h"
 #include "common/Helpers.h"
+#include "common/RefreshScheduler.h"
 #include "core/MainWindow.h"
 #include "ui_ListDockWidget.h"
 #include <QVBoxLayout>
@@ -117,7 +118,8 @@ ResourcesWidget::ResourcesWidget(MainWindow *main)
     // Configure widget
     this->setWindowTitle(tr("Resources"));
 
-    connect(Core(), &IaitoCore::refreshAll, this, &ResourcesWidget::refreshResources);
+    Core()->getRefreshScheduler()->subscribe(
+        this, RefreshScheduler::Nothing, &ResourcesWidget::refreshResources);
     connect(Core(), &IaitoCore::commentsChanged, this, [this]() {
         qhelpers::emitColumnChanged(model, ResourcesModel::COMMENT);
     });
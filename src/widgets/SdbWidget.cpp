@@ -2,6 +2,7 @@
 #include "ui_SdbWidget.h"
 
 #include "common/Helpers.h"
+#include "common/RefreshScheduler.h"
 #include "core/MainWindow.h"
 
 #include <QDebug>
@@ -15,7 +16,8 @@ SdbWidget::SdbWidget(MainWindow *main)
 
     path.clear();
 
-    connect(Core(), &IaitoCore::refreshAll, this, [this]() { reload(); });
+    Core()->getRefreshScheduler()->subscribe(
+        this, RefreshScheduler::Nothing, [this]() { reload(); });
     reload();
 }
 
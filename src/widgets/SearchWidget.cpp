@@ -1,5 +1,6 @@
 #include "SearchWidget.h"
 #include "common/Helpers.h"
+#include "common/RefreshScheduler.h"
 #include "core/MainWindow.h"
 #include "ui_SearchWidget.h"
 
@@ -207,7 +208,8 @@ SearchWidget::SearchWidget(MainWindow *main)
     setScrollMode();
 
     connect(Core(), &IaitoCore::toggleDebugView, this, &SearchWidget::updateSearchBoundaries);
-    connect(Core(), &IaitoCore::refreshAll, this, &SearchWidget::refreshSearchspaces);
+    Core()->getRefreshScheduler()->subscribe(
+        this, RefreshScheduler::Nothing, &SearchWidget::refreshSearchspaces);
     connect(Core(), &IaitoCore::commentsChanged, this, [this]() {
         qhelpers::emitColumnChanged(search_model, SearchModel::COMMENT);
     });
@@ -2,6 +2,7 @@
 #include "QuickFilterView.h"
 #include "common/Configuration.h"
 #include "common/Helpers.h"
+#include "common/RefreshScheduler.h"
 #include "core/MainWindow.h"
 #include "ui_ListDockWidget.h"
 
@@ -228,8 +229,8 @@ void SectionsWidget::initAddrMapDocks()
 
 void SectionsWidget::initConnects()
 {
-    connect(Core(), &IaitoCore::refreshAll, this, &SectionsWidget::refreshSections);
-    connect(Core(), &IaitoCore::codeRebased, this, &SectionsWidget::refreshSections);
+    Core()->getRefreshScheduler()->subscribe(
+        this, RefreshScheduler::Rebased, &SectionsWidget::refreshSections);
     connect(this, &QDockWidget::visibilityChanged, this, [=](bool visibility) {
         if (visibility) {
             refreshSections();
@@ -1,5 +1,6 @@
 #include "SegmentsWidget.h"
 #include "common/Helpers.h"
+#include "common/RefreshScheduler.h"
 #include "core/MainWindow.h"
 #include "ui_ListDockWidget.h"
 
@@ -153,8 +154,8 @@ SegmentsWidget::SegmentsWidget(MainWindow *main)
     ui->quickFilterView->closeFilter();
     showCount(false);
 
-    connect(Core(), &IaitoCore::refreshAll, this, &SegmentsWidget::refreshSegments);
-    connect(Core(), &IaitoCore::codeRebased, this, &SegmentsWidget::refreshSegments);
+    Core()->getRefreshScheduler()->subscribe(
+        this, RefreshScheduler::Rebased, &SegmentsWidget::refreshSegments);
     connect(Core(), &IaitoCore::commentsChanged, this, [this]() {
         qhelpers::emitColumnChanged(segmentsModel, SegmentsModel::CommentColumn);
     });
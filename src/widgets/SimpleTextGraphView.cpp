@@ -56,8 +56,7 @@ SimpleTextGraphView::~SimpleTextGraphView()
 
 void SimpleTextGraphView::refreshView()
 {
-    initFont();
-    setLayoutConfig(getLayoutConfig());
+    IaitoGraphView::refreshView();
     saveCurrentBlock();
     loadCurrentGraph();
     if (blocks.find(selectedBlock) == blocks.end()) {
@@ -72,16 +71,21 @@ void SimpleTextGraphView::selectBlockWithId(ut64 blockId)
     if (!enableBlockSelection) {
         return;
     }
+    auto previousIt = blocks.find(selectedBlock);
+    if (previousIt != blocks.end()) {
+        invalidateBlock(previousIt->second);
+    }
     auto contentIt = blockContent.find(blockId);
     if (contentIt != blockContent.end()) {
         selectedBlock = blockId;
         if (haveAddresses) {
             addressableItemContextMenu.setTarget(contentIt->second.address, contentIt->second.text);
         }
-        viewport()->update();
+        invalidateBlock(blocks[blockId]);
     } else {
         selectedBlock = NO_BLOCK_SELECTED;
     }
+    viewport()->update();
 }
 
 void SimpleTextGraphView::drawBlock(QPainter &p, GraphView::GraphBlock &block, bool interactive)
@@ -126,6 +130,19 @@ void SimpleTextGraphView::drawBlock(QPainter &p, GraphView::GraphBlock &block, b
     p.drawText(QPoint(x, y), content.text);
 }
 
+QString SimpleTextGraphView::blockTitle(GraphView::GraphBlock &block)
+{
+    return blockContent[block.entry].text;
+}
+
+QColor SimpleTextGraphView::blockFillColor(GraphView::GraphBlock &block, bool interactive)
+{
+    if (interactive && block.entry == selectedBlock) {
+        return disassemblySelectedBackgroundColor;
+    }
+    return disassemblyBackgroundColor;
+}
+
 GraphView::EdgeConfiguration SimpleTextGraphView::edgeConfiguration(
     GraphView::GraphBlock &from, GraphView::GraphBlock *to, bool interactive)
 {
@@ -144,6 +161,8 @@ void SimpleTextGraphView::setBlockSelectionEnabled(bool value)
     enableBlockSelection = value;
     if (!value) {
         selectedBlock = NO_BLOCK_SELECTED;
+        setCacheDirty();
+        viewport()->update();
     }
 }
 
@@ -247,10 +266,3 @@ void SimpleTextGraphView::restoreCurrentBlock()
         }
     }
 }
-
-void SimpleTextGraphView::paintEvent(QPaintEvent *event)
-{
-    // SimpleTextGraphView is always dirty
-    setCacheDirty();
-    GraphView::paintEvent(event);
-}
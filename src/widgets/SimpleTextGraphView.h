@@ -25,6 +25,8 @@ public:
     virtual void drawBlock(QPainter &p, GraphView::GraphBlock &block, bool interactive) override;
     virtual GraphView::EdgeConfiguration edgeConfiguration(
         GraphView::GraphBlock &from, GraphView::GraphBlock *to, bool interactive) override;
+    virtual QString blockTitle(GraphView::GraphBlock &block) override;
+    virtual QColor blockFillColor(GraphView::GraphBlock &block, bool interactive) override;
 
     /**
      * @brief Enable or disable block selection.
@@ -41,7 +43,6 @@ public slots:
     void selectBlockWithId(ut64 blockId);
 
 protected:
-    void paintEvent(QPaintEvent *event) override;
     void contextMenuEvent(QContextMenuEvent *event) override;
     void blockContextMenuRequested(
         GraphView::GraphBlock &block, QContextMenuEvent *event, QPoint pos) override;
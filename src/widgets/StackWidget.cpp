@@ -1,6 +1,7 @@
 #include "StackWidget.h"
 #include "common/Helpers.h"
 #include "common/JsonModel.h"
+#include "common/RefreshScheduler.h"
 #include "dialogs/EditInstructionDialog.h"
 #include "ui_StackWidget.h"
 
@@ -35,9 +36,8 @@ StackWidget::StackWidget(MainWindow *main)
 
     refreshDeferrer = createRefreshDeferrer([this]() { updateContents(); });
 
-    connect(Core(), &IaitoCore::refreshAll, this, &StackWidget::updateContents);
-    connect(Core(), &IaitoCore::registersChanged, this, &StackWidget::updateContents);
-    connect(Core(), &IaitoCore::stackChanged, this, &StackWidget::updateContents);
+    Core()->getRefreshScheduler()->subscribe(
+        this, RefreshScheduler::Registers | RefreshScheduler::Stack, &StackWidget::updateContents);
     connect(Core(), &IaitoCore::commentsChanged, this, [this]() {
         qhelpers::emitColumnChanged(modelStack, StackModel::CommentColumn);
     });
@@ -151,16 +151,16 @@ StackModel::StackModel(QObject *parent)
 
 void StackModel::reload()
 {
-    QList<QJsonObject> stackItems = Core()->getStack();
+    QList<TelescopeDescription> stackItems = Core()->getStack();
 
     beginResetModel();
     values.clear();
-    for (const QJsonObject &stackItem : stackItems) {
+    for (const TelescopeDescription &stackItem : stackItems) {
         Item item;
 
-        item.offset = stackItem["addr"].toVariant().toULongLong();
-        item.value = RAddressString(stackItem["value"].toVariant().toULongLong());
-        item.refDesc = Core()->formatRefDesc(stackItem["ref"].toObject());
+        item.offset = stackItem.addr;
+        item.value = RAddressString(stackItem.value);
+        item.refDesc = stackItem.refDesc;
 
         values.push_back(item);
     }
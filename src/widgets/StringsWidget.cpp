@@ -1,6 +1,7 @@
 #include "StringsWidget.h"
 #include "WidgetShortcuts.h"
 #include "common/Helpers.h"
+#include "common/RefreshScheduler.h"
 #include "core/MainWindow.h"
 #include "ui_StringsWidget.h"
 
@@ -97,6 +98,16 @@ const StringDescription *StringsModel::description(const QModelIndex &index) con
     return &strings->at(index.row());
 }
 
+void StringsModel::appendStrings(const QList<StringDescription> &batch)
+{
+    if (batch.isEmpty()) {
+        return;
+    }
+    beginInsertRows(QModelIndex(), strings->count(), strings->count() + batch.count() - 1);
+    strings->append(batch);
+    endInsertRows();
+}
+
 StringsProxyModel::StringsProxyModel(StringsModel *sourceModel, QObject *parent)
     : AddressableFilterProxyModel(sourceModel, parent)
 {
@@ -208,8 +219,8 @@ StringsWidget::StringsWidget(MainWindow *main)
     });
     clearShortcut->setContext(Qt::WidgetWithChildrenShortcut);
 
-    connect(Core(), &IaitoCore::refreshAll, this, &StringsWidget::refreshStrings);
-    connect(Core(), &IaitoCore::codeRebased, this, &StringsWidget::refreshStrings);
+    Core()->getRefreshScheduler()->subscribe(
+        this, RefreshScheduler::Rebased, &StringsWidget::refreshStrings);
     connect(Core(), &IaitoCore::commentsChanged, this, [this]() {
         qhelpers::emitColumnChanged(model, StringsModel::CommentColumn);
     });
@@ -229,24 +240,57 @@ StringsWidget::StringsWidget(MainWindow *main)
     header->setResizeContentsPrecision(256);
 }
 
-StringsWidget::~StringsWidget() {}
+StringsWidget::~StringsWidget()
+{
+    if (task) {
+        task->interrupt();
+    }
+}
 
 void StringsWidget::refreshStrings()
 {
-#if MONOTHREAD
-    auto strings = Core()->getAllStrings();
-    this->strings = strings;
-    model->endResetModel();
-    tree->showItemsNumber(proxyModel->rowCount());
-#else
     if (task) {
+        task->interrupt();
         task->wait();
+        task.clear();
+    }
+    const int generation = ++taskGeneration;
+
+    if (!Core()->isThreadedMode()) {
+        model->beginResetModel();
+        strings = Core()->getAllStrings();
+        model->endResetModel();
+        stringSearchFinished();
+        refreshSectionCombo();
+        return;
     }
+
+    model->beginResetModel();
+    strings.clear();
+    model->endResetModel();
+
     task = QSharedPointer<StringsTask>(new StringsTask());
     connect(
-        task.data(), &StringsTask::stringSearchFinished, this, &StringsWidget::stringSearchFinished);
+        task.data(),
+        &StringsTask::stringsFound,
+        this,
+        [this, generation](const QList<StringDescription> &batch, qint64 done, qint64 total) {
+            if (generation == taskGeneration) {
+                stringsFound(batch, done, total);
+            }
+        },
+        Qt::QueuedConnection);
+    connect(
+        task.data(),
+        &StringsTask::stringSearchFinished,
+        this,
+        [this, generation]() {
+            if (generation == taskGeneration) {
+                stringSearchFinished();
+            }
+        },
+        Qt::QueuedConnection);
     Core()->getAsyncTaskManager()->start(task);
-#endif
 
     refreshSectionCombo();
 }
@@ -265,12 +309,15 @@ void StringsWidget::refreshSectionCombo()
     proxyModel->selectedSection.clear();
 }
 
-void StringsWidget::stringSearchFinished(const QList<StringDescription> &strings)
+void StringsWidget::stringsFound(
+    const QList<StringDescription> &batch, qint64 done, qint64 total)
 {
-    model->beginResetModel();
-    this->strings = strings;
-    model->endResetModel();
+    model->appendStrings(batch);
+    tree->showItemsNumber(proxyModel->rowCount(), done, total);
+}
 
+void StringsWidget::stringSearchFinished()
+{
     tree->showItemsNumber(proxyModel->rowCount());
 
     task.clear();
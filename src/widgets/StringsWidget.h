@@ -53,6 +53,11 @@ public:
 
     RVA address(const QModelIndex &index) const override;
     const StringDescription *description(const QModelIndex &index) const;
+
+    /**
+     * @brief Append a batch of strings at the end of the model
+     */
+    void appendStrings(const QList<StringDescription> &batch);
 };
 
 class StringsProxyModel : public AddressableFilterProxyModel
@@ -81,7 +86,8 @@ public:
 
 private slots:
     void refreshStrings();
-    void stringSearchFinished(const QList<StringDescription> &strings);
+    void stringsFound(const QList<StringDescription> &batch, qint64 done, qint64 total);
+    void stringSearchFinished();
     void refreshSectionCombo();
 
     void on_actionCopy();
@@ -90,6 +96,11 @@ private:
     std::unique_ptr<Ui::StringsWidget> ui;
 
     QSharedPointer<StringsTask> task;
+    /**
+     * Incremented on every refresh so that batches queued by an interrupted
+     * task are dropped instead of being appended to the new list.
+     */
+    int taskGeneration = 0;
 
     StringsModel *model;
     StringsProxyModel *proxyModel;
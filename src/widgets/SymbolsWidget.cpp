@@ -1,5 +1,6 @@
 #include "SymbolsWidget.h"
 #include "common/Helpers.h"
+#include "common/RefreshScheduler.h"
 #include "core/MainWindow.h"
 #include "ui_ListDockWidget.h"
 
@@ -128,8 +129,8 @@ SymbolsWidget::SymbolsWidget(MainWindow *main)
     setModels(symbolsProxyModel);
     ui->treeView->sortByColumn(SymbolsModel::AddressColumn, Qt::AscendingOrder);
 
-    connect(Core(), &IaitoCore::codeRebased, this, &SymbolsWidget::refreshSymbols);
-    connect(Core(), &IaitoCore::refreshAll, this, &SymbolsWidget::refreshSymbols);
+    Core()->getRefreshScheduler()->subscribe(
+        this, RefreshScheduler::Rebased, &SymbolsWidget::refreshSymbols);
     connect(Core(), &IaitoCore::commentsChanged, this, [this]() {
         qhelpers::emitColumnChanged(symbolsModel, SymbolsModel::CommentColumn);
     });
@@ -1,6 +1,7 @@
 #include "ThreadsWidget.h"
 #include "QuickFilterView.h"
 #include "common/JsonModel.h"
+#include "common/RefreshScheduler.h"
 #include "ui_ThreadsWidget.h"
 #include <r_debug.h>
 #include <QShortcut>
@@ -51,12 +52,11 @@ ThreadsWidget::ThreadsWidget(MainWindow *main)
         &QuickFilterView::filterTextChanged,
         modelFilter,
         &ThreadsFilterModel::setFilterWildcard);
-    connect(Core(), &IaitoCore::refreshAll, this, &ThreadsWidget::updateContents);
-    connect(Core(), &IaitoCore::registersChanged, this, &ThreadsWidget::updateContents);
-    connect(Core(), &IaitoCore::debugTaskStateChanged, this, &ThreadsWidget::updateContents);
-    // Seek doesn't necessarily change when switching threads/processes
-    connect(Core(), &IaitoCore::switchedThread, this, &ThreadsWidget::updateContents);
-    connect(Core(), &IaitoCore::switchedProcess, this, &ThreadsWidget::updateContents);
+    // Seek doesn't necessarily change when switching threads/processes, hence Debug
+    Core()->getRefreshScheduler()->subscribe(
+        this,
+        RefreshScheduler::Registers | RefreshScheduler::Debug,
+        &ThreadsWidget::updateContents);
     connect(Config(), &Configuration::fontsUpdated, this, &ThreadsWidget::fontsUpdatedSlot);
     connect(ui->viewThreads, &QTableView::activated, this, &ThreadsWidget::onActivated);
 }
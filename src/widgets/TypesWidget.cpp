@@ -1,5 +1,6 @@
 #include "TypesWidget.h"
 #include "common/Helpers.h"
+#include "common/RefreshScheduler.h"
 #include "core/MainWindow.h"
 #include "dialogs/LinkTypeDialog.h"
 #include "dialogs/TypesInteractionDialog.h"
@@ -77,6 +78,7 @@ QVariant TypesModel::headerData(int section, Qt::Orientation, int role) const
 bool TypesModel::removeRows(int row, int count, const QModelIndex &parent)
 {
     Core()->cmdRaw("t-" + types->at(row).type);
+    emit Core()->typesChanged();
     beginRemoveRows(parent, row, row + count - 1);
     while (count--) {
         types->removeAt(row);
@@ -189,7 +191,8 @@ TypesWidget::TypesWidget(MainWindow *main)
         &ComboQuickFilterView::clearFilter);
     clearShortcut->setContext(Qt::WidgetWithChildrenShortcut);
 
-    connect(Core(), &IaitoCore::refreshAll, this, &TypesWidget::refreshTypes);
+    Core()->getRefreshScheduler()->subscribe(
+        this, RefreshScheduler::Nothing, &TypesWidget::refreshTypes);
 
     connect(ui->quickFilterView->comboBox(), &QComboBox::currentTextChanged, this, [this]() {
         types_proxy_model->selectedCategory
@@ -2,6 +2,7 @@
 #include <QShortcut>
 
 #include "common/Helpers.h"
+#include "common/RefreshScheduler.h"
 #include "core/MainWindow.h"
 
 #include "VTablesWidget.h"
@@ -163,8 +164,8 @@ VTablesWidget::VTablesWidget(MainWindow *main)
         tree->showItemsNumber(proxy->rowCount());
     });
 
-    connect(Core(), &IaitoCore::codeRebased, this, &VTablesWidget::refreshVTables);
-    connect(Core(), &IaitoCore::refreshAll, this, &VTablesWidget::refreshVTables);
+    Core()->getRefreshScheduler()->subscribe(
+        this, RefreshScheduler::Rebased, &VTablesWidget::refreshVTables);
 
     refreshDeferrer = createRefreshDeferrer([this]() { refreshVTables(); });
 }
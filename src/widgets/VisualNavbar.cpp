@@ -1,16 +1,10 @@
 #include "VisualNavbar.h"
-#include "common/TempConfig.h"
+#include "common/RefreshScheduler.h"
 #include "core/MainWindow.h"
 
 #include <QComboBox>
-#include <QGraphicsRectItem>
-#include <QGraphicsScene>
-#include <QGraphicsView>
-#include <QJsonArray>
-#include <QJsonDocument>
-#include <QJsonObject>
-#include <QJsonParseError>
 #include <QMouseEvent>
+#include <QPainter>
 #include <QToolTip>
 
 #include <array>
@@ -18,9 +12,7 @@
 
 VisualNavbar::VisualNavbar(MainWindow *main, QWidget *parent)
     : QToolBar(main)
-    , graphicsView(new QGraphicsView)
-    , seekGraphicsItem(nullptr)
-    , PCGraphicsItem(nullptr)
+    , strip(new QWidget)
     , main(main)
 {
     Q_UNUSED(parent);
@@ -41,33 +33,22 @@ VisualNavbar::VisualNavbar(MainWindow *main, QWidget *parent)
     addsCombo->addItem("Entry points");
     addsCombo->addItem("Marks");
     */
-    addWidget(this->graphicsView);
+    addWidget(this->strip);
     // addWidget(addsCombo);
 
     connect(Core(), &IaitoCore::seekChanged, this, &VisualNavbar::on_seekChanged);
     connect(Core(), &IaitoCore::registersChanged, this, &VisualNavbar::drawPCCursor);
-    connect(Core(), &IaitoCore::refreshAll, this, &VisualNavbar::fetchAndPaintData);
-    connect(Core(), &IaitoCore::functionsChanged, this, &VisualNavbar::fetchAndPaintData);
-    connect(Core(), &IaitoCore::flagsChanged, this, &VisualNavbar::fetchAndPaintData);
-
-    graphicsScene = new QGraphicsScene(this);
-
-    const QBrush bg = QBrush(QColor(74, 74, 74));
-
-    graphicsScene->setBackgroundBrush(bg);
-
-    this->graphicsView->setAlignment(Qt::AlignLeft);
-    this->graphicsView->setMinimumHeight(15);
-    this->graphicsView->setMaximumHeight(15);
-    this->graphicsView->setFrameShape(QFrame::NoFrame);
-    this->graphicsView->setRenderHints({});
-    this->graphicsView->setScene(graphicsScene);
-    this->graphicsView->setRenderHints(QPainter::Antialiasing);
-    this->graphicsView->setHorizontalScrollBarPolicy(Qt::ScrollBarAlwaysOff);
-    this->graphicsView->setVerticalScrollBarPolicy(Qt::ScrollBarAlwaysOff);
-    // So the graphicsView doesn't intercept mouse events.
-    this->graphicsView->setEnabled(false);
-    this->graphicsView->setMouseTracking(true);
+    // renaming functions or flags doesn't change what is shown
+    Core()->getRefreshScheduler()->subscribe(
+        this, RefreshScheduler::Functions, &VisualNavbar::fetchAndPaintData);
+
+    this->strip->setMinimumHeight(15);
+    this->strip->setMaximumHeight(15);
+    this->strip->setSizePolicy(QSizePolicy::Expanding, QSizePolicy::Fixed);
+    // So the strip doesn't intercept mouse events.
+    this->strip->setAttribute(Qt::WA_TransparentForMouseEvents);
+    this->strip->setAttribute(Qt::WA_OpaquePaintEvent);
+    this->strip->installEventFilter(this);
     setMouseTracking(true);
 }
 
@@ -85,9 +66,7 @@ void VisualNavbar::paintEvent(QPaintEvent *event)
 {
     Q_UNUSED(event);
 
-    QPainter painter(this);
-
-    auto w = static_cast<unsigned int>(width());
+    auto w = static_cast<unsigned int>(strip->width());
     bool fetch = false;
     if (statsWidth < w) {
         statsWidth = nextPow2(w);
@@ -99,12 +78,18 @@ void VisualNavbar::paintEvent(QPaintEvent *event)
 
     if (fetch) {
         fetchAndPaintData();
-    } else if (previousWidth != w) {
-        this->previousWidth = w;
-        updateGraphicsScene();
     }
 }
 
+bool VisualNavbar::eventFilter(QObject *watched, QEvent *event)
+{
+    if (watched == strip && event->type() == QEvent::Paint) {
+        paintStrip();
+        return true;
+    }
+    return QToolBar::eventFilter(watched, event);
+}
+
 void VisualNavbar::fetchAndPaintData()
 {
     fetchStats();
@@ -116,23 +101,30 @@ void VisualNavbar::fetchStats()
     stats = Core()->getBlockStatistics(statsWidth);
 }
 
+void VisualNavbar::updateGraphicsScene()
+{
+    stripImageValid = false;
+    strip->update();
+}
+
 enum class DataType : int { Empty, Code, String, Symbol, Count };
 
-void VisualNavbar::updateGraphicsScene()
+void VisualNavbar::renderStrip()
 {
-    graphicsScene->clear();
+    int w = strip->width();
+    int h = strip->height();
+    qreal dpr = strip->devicePixelRatioF();
+
+    stripImage = QImage(QSize(w, h) * dpr, QImage::Format_RGB32);
+    stripImage.setDevicePixelRatio(dpr);
+    stripImage.fill(Config()->getColor("gui.navbar.empty"));
+    stripImageValid = true;
     xToAddress.clear();
-    seekGraphicsItem = nullptr;
-    PCGraphicsItem = nullptr;
-    graphicsScene->setBackgroundBrush(QBrush(Config()->getColor("gui.navbar.empty")));
 
     if (stats.to <= stats.from) {
         return;
     }
 
-    int w = graphicsView->width();
-    int h = graphicsView->height();
-
     RVA totalSize = stats.to - stats.from;
     RVA beginAddr = stats.from;
 
@@ -149,9 +141,18 @@ void VisualNavbar::updateGraphicsScene()
     dataTypeBrushes[static_cast<int>(DataType::Symbol)] = QBrush(
         Config()->getColor("gui.navbar.sym"));
 
+    QPainter painter(&stripImage);
+    painter.setPen(Qt::NoPen);
+    painter.setRenderHint(QPainter::Antialiasing);
+
+    // consecutive blocks of the same type are drawn as a single rectangle
     DataType lastDataType = DataType::Empty;
-    QGraphicsRectItem *dataItem = nullptr;
-    QRectF dataItemRect(0.0, 0.0, 0.0, h);
+    QRectF dataRect(0.0, 0.0, 0.0, h);
+    auto flush = [&]() {
+        if (lastDataType != DataType::Empty) {
+            painter.fillRect(dataRect, dataTypeBrushes[static_cast<int>(lastDataType)]);
+        }
+    };
     for (const BlockDescription &block : stats.blocks) {
         // Keep track of where which memory segment is mapped so we are able to
         // convert from address to X coordinate and vice versa.
@@ -172,78 +173,64 @@ void VisualNavbar::updateGraphicsScene()
         } else if (block.inFunctions > 0) {
             dataType = DataType::Code;
         } else {
-            lastDataType = DataType::Empty;
-            continue;
+            dataType = DataType::Empty;
         }
 
         if (dataType == lastDataType) {
-            double r = xFromAddr(block.addr + block.size);
-            if (r > dataItemRect.right()) {
-                dataItemRect.setRight(r);
-                dataItem->setRect(dataItemRect);
-            }
-            dataItem->setRect(dataItemRect);
+            dataRect.setRight(std::max(dataRect.right(), x2a.x_end));
             continue;
         }
-
-        dataItemRect.setX(xFromAddr(block.addr));
-        dataItemRect.setRight(xFromAddr(block.addr + block.size));
-
-        dataItem = new QGraphicsRectItem();
-        dataItem->setPen(Qt::NoPen);
-        dataItem->setBrush(dataTypeBrushes[static_cast<int>(dataType)]);
-        graphicsScene->addItem(dataItem);
-
+        flush();
+        dataRect.setLeft(x2a.x_start);
+        dataRect.setRight(x2a.x_end);
         lastDataType = dataType;
     }
+    flush();
+}
 
-    // Update scene width
-    graphicsScene->setSceneRect(0, 0, w, h);
+void VisualNavbar::paintStrip()
+{
+    if (!stripImageValid || stripImage.size() != strip->size() * strip->devicePixelRatioF()) {
+        renderStrip();
+    }
 
-    drawSeekCursor();
+    QPainter painter(strip);
+    painter.drawImage(0, 0, stripImage);
+    drawCursor(painter, Core()->getOffset(), Config()->getColor("gui.navbar.seek"));
+    drawCursor(painter, pcAddress, Config()->getColor("gui.navbar.pc"));
 }
 
-void VisualNavbar::drawCursor(RVA addr, QColor color, QGraphicsRectItem *&graphicsItem)
+void VisualNavbar::drawCursor(QPainter &painter, RVA addr, const QColor &color)
 {
-    double cursor_x = addressToLocalX(addr);
-    if (graphicsItem != nullptr) {
-        graphicsScene->removeItem(graphicsItem);
-        delete graphicsItem;
-        graphicsItem = nullptr;
+    if (addr == RVA_INVALID) {
+        return;
     }
+    double cursor_x = addressToLocalX(addr);
     if (std::isnan(cursor_x)) {
         return;
     }
-    int h = this->graphicsView->height();
-    graphicsItem = new QGraphicsRectItem(cursor_x, 0, 2, h);
-    graphicsItem->setPen(Qt::NoPen);
-    graphicsItem->setBrush(QBrush(color));
-    graphicsScene->addItem(graphicsItem);
+    painter.fillRect(QRectF(cursor_x, 0, 2, strip->height()), color);
 }
 
 void VisualNavbar::drawPCCursor()
 {
-    drawCursor(Core()->getProgramCounterValue(), Config()->getColor("gui.navbar.pc"), PCGraphicsItem);
-}
-
-void VisualNavbar::drawSeekCursor()
-{
-    drawCursor(Core()->getOffset(), Config()->getColor("gui.navbar.seek"), seekGraphicsItem);
+    pcAddress = Core()->getProgramCounterValue();
+    strip->update();
 }
 
 void VisualNavbar::on_seekChanged(RVA addr)
 {
     Q_UNUSED(addr);
     // Update cursor
-    this->drawSeekCursor();
+    strip->update();
 }
 
 void VisualNavbar::mousePressEvent(QMouseEvent *event)
 {
 #if QT_VERSION >= QT_VERSION_CHECK(6, 0, 0)
-    qreal x = event->position().x();
+    qreal x = event->position().x() - strip->x();
 #else
-    qreal x = event->localPos().x();
+    qreal x = event->localPos().x() - strip->x();
 #endif
     RVA address = localXToAddress(x);
     if (address != RVA_INVALID) {
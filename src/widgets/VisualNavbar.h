@@ -1,13 +1,12 @@
 #ifndef VISUALNAVBAR_H
 #define VISUALNAVBAR_H
 
-#include <QGraphicsScene>
+#include <QImage>
 #include <QToolBar>
 
 #include "core/Iaito.h"
 
 class MainWindow;
-class QGraphicsView;
 
 class VisualNavbar : public QToolBar
 {
@@ -26,29 +25,44 @@ public:
 
 public slots:
     void paintEvent(QPaintEvent *event) override;
+    /**
+     * @brief Render the blocks again, e.g. after a color change
+     */
     void updateGraphicsScene();
 
 private slots:
     void fetchAndPaintData();
     void fetchStats();
-    void drawSeekCursor();
     void drawPCCursor();
-    void drawCursor(RVA addr, QColor color, QGraphicsRectItem *&graphicsItem);
     void on_seekChanged(RVA addr);
 
+protected:
+    bool eventFilter(QObject *watched, QEvent *event) override;
+
 private:
-    QGraphicsView *graphicsView;
-    QGraphicsScene *graphicsScene;
-    QGraphicsRectItem *seekGraphicsItem;
-    QGraphicsRectItem *PCGraphicsItem;
+    /**
+     * the widget the blocks and cursors are painted on
+     */
+    QWidget *strip;
     MainWindow *main;
 
     BlockStatistics stats;
     unsigned int statsWidth = 0;
-    unsigned int previousWidth = 0;
+
+    /**
+     * blocks rendered at the current strip size, the cursors are drawn on top
+     * of it when painting
+     */
+    QImage stripImage;
+    bool stripImageValid = false;
+    RVA pcAddress = RVA_INVALID;
 
     QList<XToAddress> xToAddress;
 
+    void renderStrip();
+    void paintStrip();
+    void drawCursor(QPainter &painter, RVA addr, const QColor &color);
+
     RVA localXToAddress(double x);
     double addressToLocalX(RVA address);
     QList<QString> sectionsForAddress(RVA address);
@@ -1,5 +1,6 @@
 #include "ZignaturesWidget.h"
 #include "common/Helpers.h"
+#include "common/RefreshScheduler.h"
 #include "core/MainWindow.h"
 #include "ui_ZignaturesWidget.h"
 
@@ -125,7 +126,8 @@ ZignaturesWidget::ZignaturesWidget(MainWindow *main)
 
     setScrollMode();
 
-    connect(Core(), &IaitoCore::refreshAll, this, &ZignaturesWidget::refreshZignatures);
+    Core()->getRefreshScheduler()->subscribe(
+        this, RefreshScheduler::Nothing, &ZignaturesWidget::refreshZignatures);
 }
 
 ZignaturesWidget::~ZignaturesWidget() {}